@@ -173,4 +173,23 @@ if (ENABLE_SSE)
 
 endif()
 
+#
+# Runtime ISA dispatch: the build targets the SSE4.1 baseline and only the
+# dispatched kernels are also built for AVX2 and AVX-512, which only requires
+# compiler support. The kernels are selected from CPUID at runtime.
+#
+if (ENABLE_ISA_DISPATCH AND HAVE_SSE)
+    include(CheckCCompilerFlag)
+    check_c_compiler_flag("-mavx2 -mfma" HAVE_ISA_DISPATCH_AVX2)
+    check_c_compiler_flag("-mavx2 -mfma -mavx512f -mavx512cd -mavx512bw -mavx512dq" HAVE_ISA_DISPATCH_AVX512)
+    set(ISA_DISPATCH_AVX2_FLAGS "-mavx2 -mfma -DLV_HAVE_SSE -DLV_HAVE_AVX -DLV_HAVE_AVX2 -DLV_HAVE_FMA")
+    set(ISA_DISPATCH_AVX512_FLAGS "${ISA_DISPATCH_AVX2_FLAGS} -mavx512f -mavx512cd -mavx512bw -mavx512dq -DLV_HAVE_AVX512")
+
+    set(HAVE_AVX    FALSE)
+    set(HAVE_AVX2   FALSE)
+    set(HAVE_FMA    FALSE)
+    set(HAVE_AVX512 FALSE)
+    message(STATUS "Runtime ISA dispatch is enabled - SSE4.1 baseline, AVX2: ${HAVE_ISA_DISPATCH_AVX2}, AVX512: ${HAVE_ISA_DISPATCH_AVX512}")
+endif()
+
 mark_as_advanced(HAVE_SSE, HAVE_AVX, HAVE_AVX2, HAVE_FMA, HAVE_AVX512)
@@ -189,6 +189,7 @@ int main(int argc, char** argv)
   if (cell_detect_config.max_frames_pss) {
     srslte_ue_cellsearch_set_nof_valid_frames(&cs, cell_detect_config.nof_valid_pss_frames);
   }
+  srslte_ue_cellsearch_set_prescan(&cs, true);
   if (cell_detect_config.init_agc) {
     srslte_rf_info_t* rf_info = srslte_rf_get_info(&rf);
     srslte_ue_sync_start_agc(&cs.ue_sync,
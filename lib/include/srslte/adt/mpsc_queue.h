@@ -0,0 +1,124 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_MPSC_QUEUE_H
+#define SRSLTE_MPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ *
+ * @file mpsc_queue.h
+ *
+ * @brief Bounded lock-free queue with many producers and a single consumer
+ *
+ * Every slot carries a sequence number that tells producers and the consumer whose turn it is, so a push only
+ * contends on the enqueue position and a pop never contends at all. Pushes fail instead of blocking when the queue
+ * is full. The capacity N must be a power of two.
+ */
+
+namespace srslte {
+
+template <typename T, std::size_t N>
+class bounded_mpsc_queue
+{
+  static_assert(N > 1 and (N & (N - 1)) == 0, "The capacity of bounded_mpsc_queue must be a power of two");
+
+  struct slot_t {
+    std::atomic<std::size_t> seq;
+    T                        value;
+  };
+
+public:
+  bounded_mpsc_queue()
+  {
+    for (std::size_t i = 0; i < N; ++i) {
+      slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+  bounded_mpsc_queue(const bounded_mpsc_queue&) = delete;
+  bounded_mpsc_queue& operator=(const bounded_mpsc_queue&) = delete;
+
+  /// Thread-safe with respect to other producers and to the consumer
+  bool try_push(const T& value)
+  {
+    std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      slot_t&        s   = slots[pos & (N - 1)];
+      std::size_t    seq = s.seq.load(std::memory_order_acquire);
+      std::ptrdiff_t dif = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+      if (dif == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          s.value = value;
+          s.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        // the consumer has not released this slot yet
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Must only be called from the consumer thread
+  bool try_pop(T& value)
+  {
+    slot_t&     s   = slots[dequeue_pos & (N - 1)];
+    std::size_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq != dequeue_pos + 1) {
+      return false;
+    }
+    value = s.value;
+    s.seq.store(dequeue_pos + N, std::memory_order_release);
+    dequeue_pos++;
+    return true;
+  }
+
+  /// Pops and applies f to every element pushed before the call. Returns the number of elements consumed
+  template <typename Func>
+  std::size_t consume_all(Func&& f)
+  {
+    std::size_t count = 0;
+    T           value;
+    while (try_pop(value)) {
+      f(value);
+      count++;
+    }
+    return count;
+  }
+
+  static constexpr std::size_t capacity() { return N; }
+
+private:
+  std::array<slot_t, N> slots;
+  // the producers' and the consumer's positions are kept in separate cache lines
+  alignas(64) std::atomic<std::size_t> enqueue_pos{0};
+  alignas(64) std::size_t dequeue_pos = 0;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_MPSC_QUEUE_H
@@ -135,6 +135,48 @@ public:
   SRSASN_CODE align_bytes_zero();
 };
 
+/************************
+     arena allocator
+************************/
+
+// Monotonic allocator. The memory is only given back when the arena is reset or destroyed, so the arena must
+// outlive every object that takes storage from it
+class arena_allocator
+{
+public:
+  explicit arena_allocator(size_t chunk_size_ = 16384) : chunk_size(chunk_size_) {}
+  arena_allocator(const arena_allocator&) = delete;
+  arena_allocator& operator=(const arena_allocator&) = delete;
+  ~arena_allocator();
+
+  void*  allocate(size_t sz, size_t align);
+  void   reset();
+  size_t nof_chunks() const { return chunks.size(); }
+
+private:
+  std::vector<uint8_t*> chunks;
+  std::vector<uint8_t*> large_chunks;
+  size_t                chunk_size;
+  size_t                chunk_idx = 0;
+  size_t                used      = 0;
+};
+
+// While in scope, the dyn_arrays allocated by the calling thread take their storage from the arena, so decoding a
+// message does not go to the heap for each of its fields. Scopes can be nested.
+class arena_scope
+{
+public:
+  explicit arena_scope(arena_allocator& arena);
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+  ~arena_scope();
+
+private:
+  arena_allocator* prev;
+};
+
+arena_allocator* get_thread_arena();
+
 /*********************
   function helpers
 *********************/
@@ -147,21 +189,16 @@ public:
   using const_iterator = const T*;
 
   dyn_array() = default;
-  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = new T[size_]; }
+  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = alloc_(size_, in_arena_); }
   dyn_array(const dyn_array<T>& other) : dyn_array(&other[0], other.size_) {}
   dyn_array(const T* ptr, uint32_t nof_items)
   {
     size_ = nof_items;
     cap_  = nof_items;
-    data_ = new T[cap_];
+    data_ = alloc_(cap_, in_arena_);
     std::copy(ptr, ptr + size_, data_);
   }
-  ~dyn_array()
-  {
-    if (data_ != NULL) {
-      delete[] data_;
-    }
-  }
+  ~dyn_array() { free_(data_, cap_, in_arena_); }
   uint32_t      size() const { return size_; }
   uint32_t      capacity() const { return cap_; }
   T&            operator[](uint32_t idx) { return data_[idx]; }
@@ -184,10 +221,12 @@ public:
       size_ = new_size;
       return;
     }
-    T* old_data = data_;
-    cap_        = new_size > new_cap ? new_size : new_cap;
+    T*       old_data     = data_;
+    uint32_t old_cap      = cap_;
+    bool     old_in_arena = in_arena_;
+    cap_                  = new_size > new_cap ? new_size : new_cap;
     if (cap_ > 0) {
-      data_ = new T[cap_];
+      data_ = alloc_(cap_, in_arena_);
       if (old_data != NULL) {
         std::copy(&old_data[0], &old_data[size_], data_);
       }
@@ -195,9 +234,7 @@ public:
       data_ = NULL;
     }
     size_ = new_size;
-    if (old_data != NULL) {
-      delete[] old_data;
-    }
+    free_(old_data, old_cap, old_in_arena);
   }
   iterator erase(iterator it)
   {
@@ -231,9 +268,38 @@ public:
   const_iterator end() const { return &data_[size()]; }
 
 private:
-  T*       data_ = nullptr;
-  uint32_t size_ = 0;
-  uint32_t cap_  = 0;
+  static T* alloc_(uint32_t n, bool& in_arena)
+  {
+    arena_allocator* arena = get_thread_arena();
+    in_arena               = arena != nullptr;
+    if (not in_arena) {
+      return new T[n];
+    }
+    T* p = static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    for (uint32_t i = 0; i < n; ++i) {
+      new (&p[i]) T();
+    }
+    return p;
+  }
+  static void free_(T* p, uint32_t n, bool in_arena)
+  {
+    if (p == NULL) {
+      return;
+    }
+    if (not in_arena) {
+      delete[] p;
+      return;
+    }
+    // The storage itself is released with the arena
+    for (uint32_t i = 0; i < n; ++i) {
+      p[i].~T();
+    }
+  }
+
+  T*       data_     = nullptr;
+  uint32_t size_     = 0;
+  uint32_t cap_      = 0;
+  bool     in_arena_ = false;
 };
 
 template <class T, uint32_t MAX_N>
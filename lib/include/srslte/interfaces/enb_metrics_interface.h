@@ -37,9 +37,10 @@
 namespace srsenb {
 
 struct stack_metrics_t {
-  mac_metrics_t  mac[ENB_METRICS_MAX_USERS];
-  rrc_metrics_t  rrc;
-  s1ap_metrics_t s1ap;
+  mac_metrics_t   mac[ENB_METRICS_MAX_USERS];
+  sched_metrics_t sched;
+  rrc_metrics_t   rrc;
+  s1ap_metrics_t  s1ap;
 };
 
 typedef struct {
@@ -118,6 +118,14 @@ typedef struct SRSLTE_API {
   cf_t tmp_pss[SRSLTE_PSS_LEN];
   cf_t tmp_pss_noisy[SRSLTE_PSS_LEN];
 
+  /* Static channel mode, last full estimate of every channel. Buffers are allocated on first use */
+  cf_t*    static_ce[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS];
+  cf_t*    static_pilots[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS];
+  uint32_t static_npilots[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS];
+  uint32_t static_age[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS];
+  float    static_snr_db[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS];
+  float    static_cfo[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS];
+
 } srslte_chest_dl_t;
 
 typedef struct SRSLTE_API {
@@ -134,6 +142,9 @@ typedef struct SRSLTE_API {
   uint32_t cfo_estimate_sf_mask;
   bool     sync_error_enable;
 
+  bool wiener_filter_bank; // Wiener estimator uses the precomputed filter bank instead of online training
+  bool static_channel;     // Reuse the previous estimate while the channel, SNR and CFO do not change
+
 } srslte_chest_dl_cfg_t;
 
 SRSLTE_API int srslte_chest_dl_init(srslte_chest_dl_t* q, uint32_t max_prb, uint32_t nof_rx_antennas);
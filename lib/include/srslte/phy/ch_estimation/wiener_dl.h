@@ -37,6 +37,11 @@
 #define SRSLTE_WIENER_DL_TIMEFIFO_SIZE (32U)
 #define SRSLTE_WIENER_DL_CXFIFO_SIZE (400U)
 
+// Filter bank, indexed by the effective SNR of the averaged pilots in 1 dB steps from -10 dB to the 15 (11.8 dB) cap
+#define SRSLTE_WIENER_DL_BANK_MIN_SNR_DB (-10)
+#define SRSLTE_WIENER_DL_BANK_NOF_SNR (22U)
+#define SRSLTE_WIENER_DL_BANK_MAX_DELAY_S (4.7e-6f) // Delay spread covered by the bank, normal cyclic prefix
+
 typedef struct {
   cf_t*    hls_fifo_1[SRSLTE_WIENER_DL_HLS_FIFO_SIZE]; // Least square channel estimates on odd pilots
   cf_t*    hls_fifo_2[SRSLTE_WIENER_DL_HLS_FIFO_SIZE]; // Least square channel estimates on even pilots
@@ -53,6 +58,13 @@ typedef struct {
   uint32_t cnt;    // counter for skipping pilot OFDM symbols
 } srslte_wiener_dl_state_t;
 
+typedef struct {
+  cf_t     wm1[SRSLTE_WIENER_DL_MIN_RE][SRSLTE_WIENER_DL_MIN_REF];
+  cf_t     wm2[SRSLTE_WIENER_DL_MIN_RE][SRSLTE_WIENER_DL_MIN_REF];
+  uint32_t shift;
+  bool     computed;
+} srslte_wiener_dl_bank_entry_t;
+
 typedef struct {
   // Maximum allocated number of...
   uint32_t max_prb;      // Resource Blocks
@@ -77,6 +89,12 @@ typedef struct {
   bool wm_computed;
   bool ready;
 
+  // Precomputed filter bank, used instead of the online trained matrices if enabled. Entries are computed on first use
+  // for the shift of the first and second pilot positions
+  bool                           bank_enable;
+  cf_t                           bank_acV[SRSLTE_WIENER_DL_MIN_RE];
+  srslte_wiener_dl_bank_entry_t* bank[2];
+
   // Calculation support
   cf_t hlsv[SRSLTE_WIENER_DL_MIN_RE];
   cf_t hlsv_sum[SRSLTE_WIENER_DL_MIN_RE];
@@ -115,6 +133,8 @@ SRSLTE_API int srslte_wiener_dl_set_cell(srslte_wiener_dl_t* q, srslte_cell_t ce
 
 SRSLTE_API void srslte_wiener_dl_reset(srslte_wiener_dl_t* q);
 
+SRSLTE_API void srslte_wiener_dl_set_bank(srslte_wiener_dl_t* q, bool enable);
+
 SRSLTE_API int srslte_wiener_dl_run(srslte_wiener_dl_t* q,
                                     uint32_t            tx,
                                     uint32_t            rx,
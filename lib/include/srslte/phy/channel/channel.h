@@ -26,7 +26,10 @@
 #include "fading.h"
 #include "hst.h"
 #include "rlf.h"
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <pthread.h>
 #include <srslte/common/log_filter.h>
 #include <string>
 
@@ -37,7 +40,8 @@ class channel
 public:
   typedef struct {
     // General
-    bool enable = false;
+    bool     enable      = false;
+    uint32_t nof_threads = 0; // Worker threads sharing the channels, 0 or 1 processes them serially
 
     // AWGN options
     bool  awgn_enable            = false;
@@ -75,18 +79,44 @@ public:
   void run(cf_t* in[SRSLTE_MAX_CHANNELS], cf_t* out[SRSLTE_MAX_CHANNELS], uint32_t len, const srslte_timestamp_t& t);
 
 private:
-  float                    hst_init_phase              = 0.0f;
-  srslte_channel_fading_t* fading[SRSLTE_MAX_CHANNELS] = {};
-  srslte_channel_delay_t*  delay[SRSLTE_MAX_CHANNELS]  = {};
-  srslte_channel_awgn_t*   awgn                        = nullptr;
-  srslte_channel_hst_t*    hst                         = nullptr;
-  srslte_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
-  log_filter*              log_h                       = nullptr;
-  uint32_t                 nof_channels                = 0;
-  uint32_t                 current_srate               = 0;
-  args_t                   args                        = {};
+  void         run_channel(uint32_t i);
+  void         run_worker(uint32_t worker_id);
+  static void* worker_entry(void* arg);
+
+  // Every channel owns its emulator state and buffers, so channels can be processed concurrently
+  float                    hst_init_phase                  = 0.0f;
+  srslte_channel_fading_t* fading[SRSLTE_MAX_CHANNELS]     = {};
+  srslte_channel_delay_t*  delay[SRSLTE_MAX_CHANNELS]      = {};
+  srslte_channel_awgn_t*   awgn[SRSLTE_MAX_CHANNELS]       = {};
+  srslte_channel_hst_t*    hst[SRSLTE_MAX_CHANNELS]        = {};
+  srslte_channel_rlf_t*    rlf                             = nullptr;
+  cf_t*                    buffer_in[SRSLTE_MAX_CHANNELS]  = {};
+  cf_t*                    buffer_out[SRSLTE_MAX_CHANNELS] = {};
+  log_filter*              log_h                           = nullptr;
+  uint32_t                 nof_channels                    = 0;
+  uint32_t                 current_srate                   = 0;
+  args_t                   args                            = {};
+
+  // Current run() job, read by the workers
+  cf_t**             job_in  = nullptr;
+  cf_t**             job_out = nullptr;
+  uint32_t           job_len = 0;
+  srslte_timestamp_t job_ts  = {};
+
+  // Worker pool, the calling thread processes the channels assigned to worker 0
+  typedef struct {
+    channel* parent;
+    uint32_t id;
+  } worker_arg_t;
+  uint32_t                nof_workers                       = 1;
+  pthread_t               workers[SRSLTE_MAX_CHANNELS]      = {};
+  worker_arg_t            workers_arg[SRSLTE_MAX_CHANNELS]  = {};
+  std::mutex              workers_mutex;
+  std::condition_variable cvar_start;
+  std::condition_variable cvar_done;
+  uint64_t                job_count       = 0;
+  uint32_t                pending_workers = 0;
+  bool                    workers_quit    = false;
 };
 
 typedef std::unique_ptr<channel> channel_ptr;
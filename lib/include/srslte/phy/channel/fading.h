@@ -57,7 +57,6 @@ typedef struct {
   cf_t*             temp;            // Temporal buffer, length fft_size
   cf_t*             h_freq;          // Channel frequency response, length fft_size
   cf_t*             y_freq;          // Intermediate frequency domain buffer
-  float             sin_table[1024]; // Table of sinus values
 
   // State variables
   cf_t* state; // To save impulse response of the filter
@@ -51,6 +51,11 @@ SRSLTE_API int srslte_rm_turbo_tx(uint8_t* w_buff,
                                   uint32_t out_len,
                                   uint32_t rv_idx);
 
+/* Sets a file used to share the receive deinterleaver tables between processes. If the file exists and matches this
+ * build it is mapped read-only instead of generating the tables, otherwise it is created. When no file is set, the
+ * SRSLTE_RM_TURBO_CACHE environment variable is used. Must be called before srslte_rm_turbo_gentables(). */
+SRSLTE_API void srslte_rm_turbo_set_cache_file(const char* path);
+
 SRSLTE_API void srslte_rm_turbo_gentables();
 
 SRSLTE_API void srslte_rm_turbo_free_tables();
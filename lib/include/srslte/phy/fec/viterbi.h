@@ -54,6 +54,26 @@ typedef struct SRSLTE_API {
   uint16_t* symbols_us;
 } srslte_viterbi_t;
 
+/* Maximum number of codewords decoded at once by the batched decoder */
+#define SRSLTE_VITERBI_BATCH_MAX 32
+
+/* Batched decoder, it runs the trellis of several codewords of the same length in parallel lanes (e.g. the PBCH or
+ * PDCCH candidates) and leaves the traceback of each of them to the caller, which can skip the unreliable ones. */
+typedef struct SRSLTE_API {
+  void*    ptr;
+  uint32_t K;
+  uint32_t framebits;
+  bool     tail_biting;
+  float    gain_quant;
+  uint32_t nof_cw;
+  uint32_t frame_length;
+  int16_t* symbols;
+  int16_t* tmp;
+  uint32_t best_state[SRSLTE_VITERBI_BATCH_MAX];
+  float    reliability[SRSLTE_VITERBI_BATCH_MAX];
+  int (*update)(void*, const int16_t*, uint32_t);
+} srslte_viterbi_batch_t;
+
 SRSLTE_API int srslte_viterbi_init(srslte_viterbi_t*     q,
                                    srslte_viterbi_type_t type,
                                    int                   poly[3],
@@ -92,4 +112,30 @@ SRSLTE_API int srslte_viterbi_init_avx2(srslte_viterbi_t*     q,
                                         uint32_t              max_frame_length,
                                         bool                  tail_bitting);
 
+SRSLTE_API int srslte_viterbi_batch_init(srslte_viterbi_batch_t* q,
+                                         srslte_viterbi_type_t   type,
+                                         int                     poly[3],
+                                         uint32_t                max_frame_length,
+                                         bool                    tail_biting);
+
+SRSLTE_API void srslte_viterbi_batch_free(srslte_viterbi_batch_t* q);
+
+/* Runs the trellis of nof_cw codewords of frame_length bits. Real-valued symbols, one pointer per codeword */
+SRSLTE_API int
+srslte_viterbi_batch_forward_f(srslte_viterbi_batch_t* q, float* symbols[], uint32_t nof_cw, uint32_t frame_length);
+
+/* Correlation of the survivor of a codeword with its symbols, normalized to [-1, 1]. It is available after the forward
+ * pass and is close to 1 only when the codeword was received with few errors. */
+SRSLTE_API float srslte_viterbi_batch_reliability(srslte_viterbi_batch_t* q, uint32_t cw);
+
+/* Traceback of one of the codewords of the last forward pass */
+SRSLTE_API int srslte_viterbi_batch_chainback(srslte_viterbi_batch_t* q, uint32_t cw, uint8_t* data);
+
+/* Forward pass and traceback of every codeword */
+SRSLTE_API int srslte_viterbi_batch_decode_f(srslte_viterbi_batch_t* q,
+                                             float*                  symbols[],
+                                             uint8_t*                data[],
+                                             uint32_t                nof_cw,
+                                             uint32_t                frame_length);
+
 #endif // SRSLTE_VITERBI_H
@@ -51,6 +51,13 @@
 
 #define SRSLTE_PBCH_MAX_RE 256 // make it avx2-aligned
 
+/* Source, destination and length combinations of up to 4 received frames, all decoded in one batch */
+#define SRSLTE_PBCH_MAX_CANDIDATES 30
+
+/* Default reliability below which a candidate is discarded before its traceback and CRC check. Random symbols give
+ * about 0.745 and error-free codewords 0.72 or more down to a BER of 10%. Set to 0 to check every candidate. */
+#define SRSLTE_PBCH_EARLY_EXIT_THRESHOLD 0.74f
+
 /* PBCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -64,20 +71,27 @@ typedef struct SRSLTE_API {
   cf_t*    d;
   float*   llr;
   float*   temp;
-  float    rm_f[SRSLTE_BCH_ENCODED_LEN];
+  float    rm_f[SRSLTE_PBCH_MAX_CANDIDATES][SRSLTE_BCH_ENCODED_LEN];
   uint8_t* rm_b;
   uint8_t  data[SRSLTE_BCH_PAYLOADCRC_LEN];
   uint8_t  data_enc[SRSLTE_BCH_ENCODED_LEN];
 
   uint32_t frame_idx;
 
+  /* frame combinations of the current batch */
+  uint32_t nof_candidates;
+  uint8_t  candidate_src[SRSLTE_PBCH_MAX_CANDIDATES];
+  uint8_t  candidate_dst[SRSLTE_PBCH_MAX_CANDIDATES];
+  uint8_t  candidate_n[SRSLTE_PBCH_MAX_CANDIDATES];
+  float    early_exit_threshold;
+
   /* tx & rx objects */
-  srslte_modem_table_t mod;
-  srslte_sequence_t    seq;
-  srslte_viterbi_t     decoder;
-  srslte_crc_t         crc;
-  srslte_convcoder_t   encoder;
-  bool                 search_all_ports;
+  srslte_modem_table_t   mod;
+  srslte_sequence_t      seq;
+  srslte_viterbi_batch_t decoder;
+  srslte_crc_t           crc;
+  srslte_convcoder_t     encoder;
+  bool                   search_all_ports;
 
 } srslte_pbch_t;
 
@@ -101,6 +115,8 @@ SRSLTE_API int srslte_pbch_encode(srslte_pbch_t* q,
 
 SRSLTE_API void srslte_pbch_decode_reset(srslte_pbch_t* q);
 
+SRSLTE_API void srslte_pbch_set_early_exit_threshold(srslte_pbch_t* q, float threshold);
+
 SRSLTE_API void srslte_pbch_mib_unpack(uint8_t* msg, srslte_cell_t* cell, uint32_t* sfn);
 
 SRSLTE_API void srslte_pbch_mib_pack(srslte_cell_t* cell, uint32_t sfn, uint8_t* msg);
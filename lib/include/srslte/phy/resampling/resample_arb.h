@@ -47,12 +47,24 @@ typedef struct SRSLTE_API {
   float step; // Step increment through filter
   float acc;  // Index into filter
   bool  interpolate;
-  cf_t  reg[SRSLTE_RESAMPLE_ARB_M]; // Our window of samples
+  cf_t  reg[SRSLTE_RESAMPLE_ARB_M]; // Last input samples, history for the next block
 
+  // Filter bank with every coefficient duplicated, so a phase multiplies interleaved complex samples directly
+  float filt[SRSLTE_RESAMPLE_ARB_N][2 * SRSLTE_RESAMPLE_ARB_M];
 } srslte_resample_arb_t;
 
 SRSLTE_API void srslte_resample_arb_init(srslte_resample_arb_t* q, float rate, bool interpolate);
 
+/**
+ * Resamples a block of n_in samples and returns the number of output samples. The resampler keeps the filter phase
+ * and the last input samples, so consecutive blocks are processed as a continuous stream.
+ */
 SRSLTE_API int srslte_resample_arb_compute(srslte_resample_arb_t* q, cf_t* input, cf_t* output, int n_in);
 
+/**
+ * Returns the number of input samples that srslte_resample_arb_compute() needs to produce exactly n_out samples from
+ * the current state. It is exact for rates lower or equal than 1 (decimation).
+ */
+SRSLTE_API uint32_t srslte_resample_arb_nof_input(const srslte_resample_arb_t* q, uint32_t n_out);
+
 #endif // SRSLTE_RESAMPLE_ARB_
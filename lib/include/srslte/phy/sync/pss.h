@@ -137,6 +137,10 @@ SRSLTE_API int srslte_pss_set_N_id_2(srslte_pss_t* q, uint32_t N_id_2);
 
 SRSLTE_API int srslte_pss_find_pss(srslte_pss_t* q, const cf_t* input, float* corr_peak_value);
 
+/* Correlates the input with the three PSS sequences at once. The input is transformed once and multiplied in
+ * frequency domain by every reference. Writes the peak position and value of each N_id_2, resets the averaging. */
+SRSLTE_API int srslte_pss_find_pss_all(srslte_pss_t* q, const cf_t* input, int peak_pos[3], float corr_peak_value[3]);
+
 SRSLTE_API int srslte_pss_chest(srslte_pss_t* q, const cf_t* input, cf_t ce[SRSLTE_PSS_LEN]);
 
 SRSLTE_API float srslte_pss_cfo_compute(srslte_pss_t* q, const cf_t* pss_recv);
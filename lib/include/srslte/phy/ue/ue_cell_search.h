@@ -50,6 +50,7 @@
 
 #define SRSLTE_CS_NOF_PRB      6
 #define SRSLTE_CS_SAMP_FREQ    1920000.0
+#define SRSLTE_CS_PRESCAN_FRAMES 3 // Number of 5 ms frames correlated against the three PSS before scanning
 
 typedef struct SRSLTE_API {
   uint32_t cell_id;
@@ -70,6 +71,9 @@ typedef struct SRSLTE_API {
 
   uint32_t max_frames;
   uint32_t nof_valid_frames;  // number of 5 ms frames to scan 
+
+  bool  prescan_enable; // Correlate all N_id_2 at once first and skip the ones without any peak
+  float prescan_psr[3]; // Best PSR found by the prescan for each N_id_2
     
   uint32_t *mode_ntimes;
   uint8_t *mode_counted; 
@@ -102,6 +106,8 @@ SRSLTE_API int srslte_ue_cellsearch_scan(srslte_ue_cellsearch_t * q,
 SRSLTE_API int srslte_ue_cellsearch_set_nof_valid_frames(srslte_ue_cellsearch_t *q, 
                                                          uint32_t nof_frames);
 
+SRSLTE_API void srslte_ue_cellsearch_set_prescan(srslte_ue_cellsearch_t* q, bool enable);
+
 
 
 
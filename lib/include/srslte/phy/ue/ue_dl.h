@@ -99,6 +99,15 @@ typedef struct SRSLTE_API {
   srslte_ofdm_t         fft[SRSLTE_MAX_PORTS];
   srslte_ofdm_t         fft_mbsfn;
 
+  // Channel estimates, cell and subframe counter of the front-end object when initialized with
+  // srslte_ue_dl_init_shared(), NULL otherwise
+  srslte_chest_dl_res_t* shared_chest_res;
+  const srslte_cell_t*   shared_cell;
+  const uint32_t*        shared_sf_count;
+
+  // Subframes demodulated by a front-end, or the front-end subframe a shared object is decoding
+  uint32_t sf_count;
+
   // Buffers to store channel symbols after demodulation
   cf_t* sf_symbols[SRSLTE_MAX_PORTS];
 
@@ -163,6 +172,17 @@ typedef struct {
 SRSLTE_API int
 srslte_ue_dl_init(srslte_ue_dl_t* q, cf_t* input[SRSLTE_MAX_PORTS], uint32_t max_prb, uint32_t nof_rx_antennas);
 
+/* Initializes an object that reuses the OFDM demodulation and channel estimates of frontend, so several RNTIs can be
+ * decoded from a single FFT and channel estimation per subframe. srslte_ue_dl_decode_fft_estimate() must be called on
+ * the front-end before calling it on this object, and the front-end must outlive it.
+ *
+ * The front-end buffers are not copied: every shared object must finish decoding a subframe before the front-end
+ * demodulates the next one, i.e. the front-end and its shared objects are driven from the same thread. Decoding
+ * functions of a shared object return SRSLTE_ERROR if the front-end moved on in the meantime. The cell passed to
+ * srslte_ue_dl_set_cell() must match the front-end cell, and srslte_ue_dl_decode_fft_estimate_noguru() is not
+ * supported since there is no FFT to run. */
+SRSLTE_API int srslte_ue_dl_init_shared(srslte_ue_dl_t* q, srslte_ue_dl_t* frontend, uint32_t max_prb);
+
 SRSLTE_API void srslte_ue_dl_free(srslte_ue_dl_t* q);
 
 SRSLTE_API int srslte_ue_dl_set_cell(srslte_ue_dl_t* q, srslte_cell_t cell);
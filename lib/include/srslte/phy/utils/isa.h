@@ -0,0 +1,70 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         isa.h
+ *
+ *  Description:  Runtime detection of the x86 instruction set extensions used
+ *                to select the SIMD variant of the PHY kernels.
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSLTE_ISA_H
+#define SRSLTE_ISA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "srslte/config.h"
+#include <stdbool.h>
+
+/* Instruction set levels, ordered so that every level includes the previous ones. AVX-only CPUs run the SSE
+ * kernels. */
+typedef enum SRSLTE_API {
+  SRSLTE_ISA_GENERIC = 0,
+  SRSLTE_ISA_SSE,    /* SSE4.1 */
+  SRSLTE_ISA_AVX2,   /* AVX2 and FMA */
+  SRSLTE_ISA_AVX512, /* AVX-512 F, CD, BW and DQ */
+  SRSLTE_ISA_NOF
+} srslte_isa_t;
+
+/* Best level supported by both the running CPU and the library build. It is detected once and can be lowered
+ * with the SRSLTE_ISA environment variable (generic, sse, avx2 or avx512). */
+SRSLTE_API srslte_isa_t srslte_isa_get(void);
+
+/* Best level supported by the running CPU, regardless of the build */
+SRSLTE_API srslte_isa_t srslte_isa_cpu(void);
+
+/* Best level the library has kernels for */
+SRSLTE_API srslte_isa_t srslte_isa_build(void);
+
+/* True if the kernels for the given level are built and the running CPU can execute them */
+SRSLTE_API bool srslte_isa_is_supported(srslte_isa_t isa);
+
+SRSLTE_API const char* srslte_isa_to_string(srslte_isa_t isa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSLTE_ISA_H
@@ -67,6 +67,20 @@ SRSLTE_API void srslte_mat_2x2_mmse_csi_gen(cf_t   y0,
 
 SRSLTE_API int srslte_mat_2x2_cn(cf_t h00, cf_t h01, cf_t h10, cf_t h11, float* cn);
 
+/* Maximum number of receive antennas and layers of the NxL solvers */
+#define SRSLTE_MAT_NxL_MAX 4
+
+/* Generic implementation for the NxL Minimum Mean Squared Error (MMSE) solver, h[rx][layer] is the effective channel
+ * and nof_layers <= nof_rx. It is a Zero Forcing (ZF) solver if noise_estimate is 0. */
+SRSLTE_API void srslte_mat_NxL_mmse_csi_gen(uint32_t nof_rx,
+                                            uint32_t nof_layers,
+                                            cf_t     y[SRSLTE_MAT_NxL_MAX],
+                                            cf_t     h[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX],
+                                            cf_t     x[SRSLTE_MAT_NxL_MAX],
+                                            float    csi[SRSLTE_MAT_NxL_MAX],
+                                            float    noise_estimate,
+                                            float    norm);
+
 #ifdef LV_HAVE_SSE
 
 /* SSE implementation for complex reciprocal */
@@ -203,6 +217,72 @@ static inline void srslte_mat_2x2_mmse_simd(simd_cf_t  y0,
   srslte_mat_2x2_mmse_csi_simd(y0, y1, h00, h01, h10, h11, x0, x1, &csi0, &csi1, noise_estimate, norm);
 }
 
+/* Generic SIMD implementation for the NxL Minimum Mean Squared Error (MMSE) solver, every lane solves one resource
+ * element. A = H' x H + No is Hermitian positive definite, so it is inverted in place by Gauss-Jordan elimination
+ * without pivoting and with real pivots. */
+static inline void srslte_mat_NxL_mmse_csi_simd(uint32_t  nof_rx,
+                                                uint32_t  nof_layers,
+                                                simd_cf_t y[SRSLTE_MAT_NxL_MAX],
+                                                simd_cf_t h[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX],
+                                                simd_cf_t x[SRSLTE_MAT_NxL_MAX],
+                                                simd_f_t  csi[SRSLTE_MAT_NxL_MAX],
+                                                float     noise_estimate,
+                                                float     norm)
+{
+  simd_cf_t a[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX];
+  simd_cf_t z[SRSLTE_MAT_NxL_MAX];
+  simd_f_t  _norm = srslte_simd_f_set1(norm);
+
+  /* 1. A = H' x H + No and Z = H' x Y */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    for (uint32_t j = i; j < nof_layers; j++) {
+      simd_cf_t acc = srslte_simd_cf_conjprod(h[0][j], h[0][i]);
+      for (uint32_t r = 1; r < nof_rx; r++) {
+        acc = srslte_simd_cf_add(acc, srslte_simd_cf_conjprod(h[r][j], h[r][i]));
+      }
+      a[i][j] = acc;
+      a[j][i] = srslte_simd_cf_conj(acc);
+    }
+    a[i][i] = srslte_simd_cf_add(a[i][i], srslte_simd_cf_set1(noise_estimate));
+
+    z[i] = srslte_simd_cf_conjprod(y[0], h[0][i]);
+    for (uint32_t r = 1; r < nof_rx; r++) {
+      z[i] = srslte_simd_cf_add(z[i], srslte_simd_cf_conjprod(y[r], h[r][i]));
+    }
+  }
+
+  /* 2. B = inv(A), the reciprocal of every pivot takes one Newton-Raphson step */
+  for (uint32_t k = 0; k < nof_layers; k++) {
+    simd_f_t pivot = srslte_simd_cf_re(a[k][k]);
+    simd_f_t rcp   = srslte_simd_f_rcp(pivot);
+    rcp = srslte_simd_f_mul(rcp, srslte_simd_f_sub(srslte_simd_f_set1(2.0f), srslte_simd_f_mul(pivot, rcp)));
+
+    a[k][k] = srslte_simd_cf_set1(1.0f);
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      a[k][j] = srslte_simd_cf_mul(a[k][j], rcp);
+    }
+    for (uint32_t i = 0; i < nof_layers; i++) {
+      if (i != k) {
+        simd_cf_t f = a[i][k];
+        a[i][k]     = srslte_simd_cf_zero();
+        for (uint32_t j = 0; j < nof_layers; j++) {
+          a[i][j] = srslte_simd_cf_sub(a[i][j], srslte_simd_cf_prod(f, a[k][j]));
+        }
+      }
+    }
+  }
+
+  /* 3. X = B x Z and CSI = 1 / B(l, l) */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    simd_cf_t acc = srslte_simd_cf_prod(a[i][0], z[0]);
+    for (uint32_t j = 1; j < nof_layers; j++) {
+      acc = srslte_simd_cf_add(acc, srslte_simd_cf_prod(a[i][j], z[j]));
+    }
+    x[i]   = srslte_simd_cf_mul(acc, _norm);
+    csi[i] = srslte_simd_f_rcp(srslte_simd_f_mul(srslte_simd_cf_re(a[i][i]), _norm));
+  }
+}
+
 #endif /* SRSLTE_SIMD_CF_SIZE != 0 */
 
 typedef struct {
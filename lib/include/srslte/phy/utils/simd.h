@@ -512,6 +512,28 @@ static inline simd_f_t srslte_simd_f_sqrt(simd_f_t a)
 #endif /* LV_HAVE_AVX512 */
 }
 
+static inline simd_f_t srslte_simd_f_round(simd_f_t a)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_roundscale_ps(a, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_round_ps(a, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#else /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  return _mm_round_ps(a, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#else /* LV_HAVE_SSE */
+#ifdef HAVE_NEON
+  /* Round half away from zero by biasing before the truncating conversion */
+  uint32x4_t  sign = vandq_u32(vreinterpretq_u32_f32(a), vdupq_n_u32(0x80000000));
+  float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), sign));
+  return vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(a, half)));
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
 static inline simd_f_t srslte_simd_f_neg(simd_f_t a)
 {
 #ifdef LV_HAVE_AVX512
@@ -1146,6 +1168,44 @@ static inline simd_cf_t srslte_simd_cf_zero(void)
   return ret;
 }
 
+/* The AVX2 interleaved loads and stores (cfi) keep the samples in the register order 0, 4, 1, 5, 2, 6, 3, 7. These
+ * reorder a register between the interleaved and the split (cf) loads and stores, they do nothing for other ISAs. */
+static inline simd_f_t srslte_simd_f_cfi_to_split(simd_f_t a)
+{
+#if defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512)
+  return _mm256_permutevar8x32_ps(a, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+#else  /* defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512) */
+  return a;
+#endif /* defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512) */
+}
+
+static inline simd_f_t srslte_simd_f_split_to_cfi(simd_f_t a)
+{
+#if defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512)
+  return _mm256_permutevar8x32_ps(a, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+#else  /* defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512) */
+  return a;
+#endif /* defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512) */
+}
+
+static inline simd_cf_t srslte_simd_cf_cfi_to_split(simd_cf_t a)
+{
+#if defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512)
+  a.re = srslte_simd_f_cfi_to_split(a.re);
+  a.im = srslte_simd_f_cfi_to_split(a.im);
+#endif /* defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512) */
+  return a;
+}
+
+static inline simd_cf_t srslte_simd_cf_split_to_cfi(simd_cf_t a)
+{
+#if defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512)
+  a.re = srslte_simd_f_split_to_cfi(a.re);
+  a.im = srslte_simd_f_split_to_cfi(a.im);
+#endif /* defined(LV_HAVE_AVX2) && !defined(LV_HAVE_AVX512) */
+  return a;
+}
+
 static inline void srslte_simd_cf_fprintf(FILE* stream, simd_cf_t a)
 {
   cf_t x[SRSLTE_SIMD_CF_SIZE];
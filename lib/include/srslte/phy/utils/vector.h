@@ -153,6 +153,42 @@ SRSLTE_API void srslte_vec_prod_ccc_split(const float*   x_re,
                                           float*         z_im,
                                           const uint32_t len);
 
+/* Complex samples in split (structure-of-arrays) layout, with the real and imaginary parts in separate aligned arrays.
+ * The split kernels take the re/im pointers, so that they can work on any offset of the buffer. */
+typedef struct SRSLTE_API {
+  float*   re;
+  float*   im;
+  uint32_t size;
+} srslte_cf_split_t;
+
+SRSLTE_API int  srslte_vec_cf_split_malloc(srslte_cf_split_t* q, uint32_t size);
+SRSLTE_API void srslte_vec_cf_split_free(srslte_cf_split_t* q);
+
+/* Conversion between the interleaved and the split layouts */
+SRSLTE_API void srslte_vec_cf_to_split(const cf_t* x, float* z_re, float* z_im, const uint32_t len);
+SRSLTE_API void srslte_vec_split_to_cf(const float* x_re, const float* x_im, cf_t* z, const uint32_t len);
+
+/* Split layout versions of prod_conj_ccc, sc_prod_ccc, abs_square_cf and dot_prod_ccc */
+SRSLTE_API void srslte_vec_prod_conj_ccc_split(const float*   x_re,
+                                               const float*   x_im,
+                                               const float*   y_re,
+                                               const float*   y_im,
+                                               float*         z_re,
+                                               float*         z_im,
+                                               const uint32_t len);
+SRSLTE_API void srslte_vec_sc_prod_ccc_split(const float*   x_re,
+                                             const float*   x_im,
+                                             const cf_t     h,
+                                             float*         z_re,
+                                             float*         z_im,
+                                             const uint32_t len);
+SRSLTE_API void srslte_vec_abs_square_cf_split(const float* x_re, const float* x_im, float* z, const uint32_t len);
+SRSLTE_API cf_t srslte_vec_dot_prod_ccc_split(const float*   x_re,
+                                              const float*   x_im,
+                                              const float*   y_re,
+                                              const float*   y_im,
+                                              const uint32_t len);
+
 /* vector product (element-wise) */
 SRSLTE_API void srslte_vec_prod_cfc(const cf_t* x, const float* y, cf_t* z, const uint32_t len);
 
@@ -27,9 +27,17 @@ extern "C" {
 #endif
 
 #include "srslte/config.h"
+#include "srslte/phy/utils/isa.h"
 #include <stdint.h>
 #include <stdio.h>
 
+/* Selects the instruction set of the SIMD kernels, it is chosen from CPUID at start-up. Only the instruction set
+ * selected at compile time is available without ENABLE_ISA_DISPATCH. Not thread-safe, call it before any processing.
+ */
+SRSLTE_API int srslte_vec_simd_set_isa(srslte_isa_t isa);
+
+SRSLTE_API srslte_isa_t srslte_vec_simd_get_isa(void);
+
 /*SIMD Logical operations*/
 SRSLTE_API void srslte_vec_xor_bbb_simd(const int8_t* x, const int8_t* y, int8_t* z, int len);
 
@@ -66,6 +74,21 @@ SRSLTE_API void srslte_vec_prod_ccc_split_simd(const float* a_re,
                                                float*       r_im,
                                                const int    len);
 
+SRSLTE_API void srslte_vec_prod_conj_ccc_split_simd(const float* a_re,
+                                                    const float* a_im,
+                                                    const float* b_re,
+                                                    const float* b_im,
+                                                    float*       r_re,
+                                                    float*       r_im,
+                                                    const int    len);
+
+SRSLTE_API void srslte_vec_sc_prod_ccc_split_simd(const float* x_re,
+                                                  const float* x_im,
+                                                  const cf_t   h,
+                                                  float*       z_re,
+                                                  float*       z_im,
+                                                  const int    len);
+
 SRSLTE_API void srslte_vec_prod_ccc_c16_simd(const int16_t* a_re,
                                              const int16_t* a_im,
                                              const int16_t* b_re,
@@ -100,6 +123,12 @@ SRSLTE_API cf_t srslte_vec_dot_prod_conj_ccc_simd(const cf_t* x, const cf_t* y,
 
 SRSLTE_API cf_t srslte_vec_dot_prod_ccc_simd(const cf_t* x, const cf_t* y, const int len);
 
+SRSLTE_API cf_t srslte_vec_dot_prod_ccc_split_simd(const float* x_re,
+                                                   const float* x_im,
+                                                   const float* y_re,
+                                                   const float* y_im,
+                                                   const int    len);
+
 #ifdef ENABLE_C16
 SRSLTE_API c16_t srslte_vec_dot_prod_ccc_c16i_simd(const c16_t* x, const c16_t* y, const int len);
 #endif /* ENABLE_C16 */
@@ -111,6 +140,13 @@ SRSLTE_API void srslte_vec_abs_cf_simd(const cf_t* x, float* z, const int len);
 
 SRSLTE_API void srslte_vec_abs_square_cf_simd(const cf_t* x, float* z, const int len);
 
+SRSLTE_API void srslte_vec_abs_square_cf_split_simd(const float* x_re, const float* x_im, float* z, const int len);
+
+/* SIMD Split (structure-of-arrays) layout conversion */
+SRSLTE_API void srslte_vec_cf_to_split_simd(const cf_t* x, float* z_re, float* z_im, const int len);
+
+SRSLTE_API void srslte_vec_split_to_cf_simd(const float* x_re, const float* x_im, cf_t* z, const int len);
+
 /* Other Functions */
 SRSLTE_API void srslte_vec_lut_sss_simd(const short* x, const unsigned short* lut, short* y, const int len);
 
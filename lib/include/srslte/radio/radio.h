@@ -26,6 +26,7 @@
 #include "srslte/common/interfaces_common.h"
 #include "srslte/common/log_filter.h"
 #include "srslte/interfaces/radio_interfaces.h"
+#include "srslte/phy/resampling/resample_arb.h"
 #include "srslte/phy/resampling/resampler.h"
 #include "srslte/phy/rf/rf.h"
 #include "srslte/radio/radio_base.h"
@@ -111,6 +112,10 @@ private:
   std::array<std::vector<cf_t>, SRSLTE_MAX_CHANNELS>      rx_buffer;
   std::array<srslte_resampler_fft_t, SRSLTE_MAX_CHANNELS> interpolators = {};
   std::array<srslte_resampler_fft_t, SRSLTE_MAX_CHANNELS> decimators    = {};
+  std::array<srslte_resample_arb_t, SRSLTE_MAX_CHANNELS>  arb_interpolators = {}; // Used for non integer ratios
+  std::array<srslte_resample_arb_t, SRSLTE_MAX_CHANNELS>  arb_decimators    = {}; // Used for non integer ratios
+  bool                                                    tx_arb_enable     = false;
+  bool                                                    rx_arb_enable     = false;
 
   rf_timestamp_t end_of_burst_time  = {};
   bool           is_start_of_burst  = false;
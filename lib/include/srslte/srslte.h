@@ -38,6 +38,7 @@ extern "C" {
 #include "srslte/phy/utils/cexptab.h"
 #include "srslte/phy/utils/convolution.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/isa.h"
 #include "srslte/phy/utils/ringbuffer.h"
 #include "srslte/phy/utils/vector.h"
 
@@ -22,6 +22,7 @@
 #include "srslte/asn1/asn1_utils.h"
 #include "srslte/common/logmap.h"
 #include <cmath>
+#include <endian.h>
 #include <stdio.h>
 
 namespace asn1 {
@@ -102,10 +103,92 @@ void log_error_code(SRSASN_CODE code, const char* filename, int line)
   }
 }
 
+/************************
+     arena allocator
+************************/
+
+static thread_local arena_allocator* thread_arena = nullptr;
+
+arena_allocator::~arena_allocator()
+{
+  reset();
+  for (uint8_t* c : chunks) {
+    delete[] c;
+  }
+}
+
+void* arena_allocator::allocate(size_t sz, size_t align)
+{
+  if (sz + align > chunk_size) {
+    // Requests that do not fit a chunk get one of their own, released on reset
+    uint8_t* c = new uint8_t[sz + align];
+    large_chunks.push_back(c);
+    return (void*)(((uintptr_t)c + align - 1) & ~(uintptr_t)(align - 1));
+  }
+  while (true) {
+    if (chunk_idx < chunks.size()) {
+      uintptr_t base    = (uintptr_t)chunks[chunk_idx];
+      uintptr_t aligned = (base + used + align - 1) & ~(uintptr_t)(align - 1);
+      if (aligned + sz <= base + chunk_size) {
+        used = aligned + sz - base;
+        return (void*)aligned;
+      }
+      chunk_idx++;
+      used = 0;
+      if (chunk_idx < chunks.size()) {
+        // Reuse the chunks kept by reset()
+        continue;
+      }
+    }
+    chunks.push_back(new uint8_t[chunk_size]);
+    chunk_idx = chunks.size() - 1;
+    used      = 0;
+  }
+}
+
+void arena_allocator::reset()
+{
+  for (uint8_t* c : large_chunks) {
+    delete[] c;
+  }
+  large_chunks.clear();
+  chunk_idx = 0;
+  used      = 0;
+}
+
+arena_scope::arena_scope(arena_allocator& arena) : prev(thread_arena)
+{
+  thread_arena = &arena;
+}
+
+arena_scope::~arena_scope()
+{
+  thread_arena = prev;
+}
+
+arena_allocator* get_thread_arena()
+{
+  return thread_arena;
+}
+
 /*********************
        bit_ref
 *********************/
 
+// Big-endian 64-bit word access, used by the word-at-a-time paths when at least 8 bytes are left in the buffer
+static inline uint64_t load_be64(const uint8_t* p)
+{
+  uint64_t w;
+  memcpy(&w, p, sizeof(w));
+  return be64toh(w);
+}
+
+static inline void store_be64(uint8_t* p, uint64_t w)
+{
+  w = htobe64(w);
+  memcpy(p, &w, sizeof(w));
+}
+
 template <typename Ptr>
 int bit_ref_impl<Ptr>::distance(const bit_ref_impl<Ptr>& other) const
 {
@@ -138,6 +221,21 @@ SRSASN_CODE bit_ref::pack(uint32_t val, uint32_t n_bits)
     log_error("This method only supports packing up to 32 bits\n");
     return SRSASN_ERROR_ENCODE_FAIL;
   }
+  if (n_bits == 0) {
+    return SRSASN_SUCCESS;
+  }
+  if (max_ptr - ptr >= 8) {
+    // Word-at-a-time path. The bits before offset are kept and the remaining bits of the last byte are zeroed
+    uint32_t end_bit    = offset + n_bits;
+    uint32_t end_byte   = ceil_frac(end_bit, 8u);
+    uint64_t clear_mask = (~0ull >> offset) & ~(~0ull >> (8 * end_byte));
+    uint64_t w          = load_be64(ptr) & ~clear_mask;
+    w |= ((uint64_t)(val & ((1u << n_bits) - 1u))) << (64 - end_bit);
+    store_be64(ptr, w);
+    ptr += end_bit / 8;
+    offset = end_bit % 8;
+    return SRSASN_SUCCESS;
+  }
   uint32_t mask;
   while (n_bits > 0) {
     if (ptr >= max_ptr) {
@@ -171,6 +269,14 @@ SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
     return SRSASN_ERROR_DECODE_FAIL;
   }
   val = 0;
+  if (n_bits > 0 && offset + n_bits <= 64 && max_ptr - ptr >= 8) {
+    // Word-at-a-time path
+    uint64_t w = load_be64(ptr) << offset;
+    val        = (T)(w >> (64 - n_bits));
+    ptr += (offset + n_bits) / 8;
+    offset = (offset + n_bits) % 8;
+    return SRSASN_SUCCESS;
+  }
   while (n_bits > 0) {
     if (ptr >= max_ptr) {
       log_error("Buffer size limit was achieved\n");
@@ -183,7 +289,7 @@ SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
       n_bits = 0;
     } else {
       auto mask = static_cast<uint8_t>((1u << (8u - offset)) - 1u);
-      val += ((uint32_t)((*ptr) & mask)) << (n_bits - 8 + offset);
+      val += ((uint64_t)((*ptr) & mask)) << (n_bits - 8 + offset);
       n_bits -= 8 - offset;
       offset = 0;
       ptr++;
@@ -243,9 +349,17 @@ SRSASN_CODE bit_ref_impl<Ptr>::unpack_bytes(uint8_t* buf, uint32_t n_bytes)
     memcpy(buf, ptr, n_bytes);
     ptr += n_bytes;
   } else {
-    for (uint32_t i = 0; i < n_bytes; ++i) {
-      HANDLE_CODE(unpack(buf[i], 8));
+    // Unaligned case, every output byte is made of the tail of one input byte and the head of the next one.
+    // The bound check above guarantees ptr[n_bytes] is inside the buffer
+    uint32_t i = 0;
+    for (; i + 8 <= n_bytes && max_ptr - (ptr + i) >= 9; i += 8) {
+      uint64_t w = (load_be64(ptr + i) << offset) | (ptr[i + 8] >> (8 - offset));
+      store_be64(buf + i, w);
+    }
+    for (; i < n_bytes; ++i) {
+      buf[i] = (uint8_t)((ptr[i] << offset) | (ptr[i + 1] >> (8 - offset)));
     }
+    ptr += n_bytes;
   }
   return SRSASN_SUCCESS;
 }
@@ -268,8 +382,8 @@ template <typename Ptr>
 SRSASN_CODE bit_ref_impl<Ptr>::advance_bits(uint32_t n_bits)
 {
   uint32_t extra_bits     = (offset + n_bits) % 8;
-  uint32_t bytes_required = ceilf((offset + n_bits) / 8.0f);
-  uint32_t bytes_offset   = floorf((offset + n_bits) / 8.0f);
+  uint32_t bytes_required = ceil_frac(offset + n_bits, 8u);
+  uint32_t bytes_offset   = (offset + n_bits) / 8;
 
   if (ptr + bytes_required >= max_ptr) {
     log_error("Buffer size limit was achieved\n");
@@ -306,9 +420,15 @@ SRSASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
     memcpy(ptr, buf, n_bytes);
     ptr += n_bytes;
   } else {
+    // Unaligned case, every input byte is split between two output bytes. The bits of the current byte before
+    // offset are kept and the bits after the last packed one are zeroed, as pack() does
+    uint8_t carry = ptr[0] & (uint8_t)(0xffu << (8 - offset));
     for (uint32_t i = 0; i < n_bytes; ++i) {
-      pack(buf[i], 8);
+      ptr[i] = carry | (buf[i] >> offset);
+      carry  = (uint8_t)(buf[i] << (8 - offset));
     }
+    ptr[n_bytes] = carry;
+    ptr += n_bytes;
   }
   return SRSASN_SUCCESS;
 }
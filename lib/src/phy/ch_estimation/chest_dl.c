@@ -203,6 +203,16 @@ void srslte_chest_dl_free(srslte_chest_dl_t* q)
     srslte_wiener_dl_free(q->wiener_dl);
     free(q->wiener_dl);
   }
+  for (uint32_t i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    for (uint32_t j = 0; j < SRSLTE_MAX_PORTS; j++) {
+      if (q->static_ce[i][j]) {
+        free(q->static_ce[i][j]);
+      }
+      if (q->static_pilots[i][j]) {
+        free(q->static_pilots[i][j]);
+      }
+    }
+  }
   bzero(q, sizeof(srslte_chest_dl_t));
 }
 
@@ -311,6 +321,9 @@ int srslte_chest_dl_set_cell(srslte_chest_dl_t* q, srslte_cell_t cell)
         fprintf(stderr, "Error initializing interpolator\n");
         return SRSLTE_ERROR;
       }
+
+      // Discard the static channel estimates of the previous cell
+      bzero(q->static_npilots, sizeof(q->static_npilots));
     }
     ret = SRSLTE_SUCCESS;
   }
@@ -618,6 +631,66 @@ static float chest_estimate_cfo(srslte_chest_dl_t* q)
   return -cargf(sum) * n / (ns * (n + ng)) / 2 / M_PI;
 }
 
+/* Static channel mode. The previous estimate of a channel is reused while the new least-squares pilot estimates stay
+ * within the noise of the stored ones and the SNR and CFO estimates do not move. A full estimate is forced every
+ * CHEST_DL_STATIC_MAX_AGE subframes. */
+#define CHEST_DL_STATIC_MAX_AGE 10
+#define CHEST_DL_STATIC_SNR_TH_DB 1.0f
+#define CHEST_DL_STATIC_CFO_TH 0.01f
+#define CHEST_DL_STATIC_NOISE_FACTOR 3.0f
+
+static float chest_dl_static_snr_db(srslte_chest_dl_t* q, uint32_t port_id, uint32_t rxant_id)
+{
+  return srslte_convert_power_to_dB(q->rsrp[rxant_id][port_id] / q->noise_estimate[rxant_id][port_id]);
+}
+
+static bool
+chest_dl_static_reuse(srslte_chest_dl_t* q, srslte_dl_sf_cfg_t* sf, cf_t* ce, uint32_t port_id, uint32_t rxant_id)
+{
+  uint32_t npilots = srslte_refsignal_cs_nof_re(&q->csr_refs, sf, port_id);
+  if (q->static_npilots[rxant_id][port_id] != npilots || q->static_age[rxant_id][port_id] >= CHEST_DL_STATIC_MAX_AGE) {
+    return false;
+  }
+
+  float snr_db = chest_dl_static_snr_db(q, port_id, rxant_id);
+  if (!(fabsf(snr_db - q->static_snr_db[rxant_id][port_id]) < CHEST_DL_STATIC_SNR_TH_DB) ||
+      !(fabsf(q->cfo - q->static_cfo[rxant_id][port_id]) < CHEST_DL_STATIC_CFO_TH)) {
+    return false;
+  }
+
+  // Both estimates are noisy, their difference has twice the noise power when the channel did not change
+  srslte_vec_sub_ccc(q->pilot_estimates, q->static_pilots[rxant_id][port_id], q->tmp_noise, npilots);
+  float diff_power = srslte_vec_avg_power_cf(q->tmp_noise, npilots);
+  if (!(diff_power <= CHEST_DL_STATIC_NOISE_FACTOR * q->noise_estimate[rxant_id][port_id])) {
+    return false;
+  }
+
+  srslte_vec_cf_copy(ce, q->static_ce[rxant_id][port_id], SRSLTE_NOF_RE(q->cell));
+  q->static_age[rxant_id][port_id]++;
+  return true;
+}
+
+static void
+chest_dl_static_store(srslte_chest_dl_t* q, srslte_dl_sf_cfg_t* sf, cf_t* ce, uint32_t port_id, uint32_t rxant_id)
+{
+  if (!q->static_ce[rxant_id][port_id]) {
+    q->static_ce[rxant_id][port_id]     = srslte_vec_cf_malloc(SRSLTE_SF_LEN_RE(SRSLTE_MAX_PRB, SRSLTE_CP_NORM));
+    q->static_pilots[rxant_id][port_id] = srslte_vec_cf_malloc(SRSLTE_REFSIGNAL_MAX_NUM_SF(SRSLTE_MAX_PRB));
+    if (!q->static_ce[rxant_id][port_id] || !q->static_pilots[rxant_id][port_id]) {
+      ERROR("Error allocating static channel estimates\n");
+      return;
+    }
+  }
+
+  uint32_t npilots = srslte_refsignal_cs_nof_re(&q->csr_refs, sf, port_id);
+  srslte_vec_cf_copy(q->static_pilots[rxant_id][port_id], q->pilot_estimates, npilots);
+  srslte_vec_cf_copy(q->static_ce[rxant_id][port_id], ce, SRSLTE_NOF_RE(q->cell));
+  q->static_npilots[rxant_id][port_id] = npilots;
+  q->static_age[rxant_id][port_id]     = 0;
+  q->static_snr_db[rxant_id][port_id]  = chest_dl_static_snr_db(q, port_id, rxant_id);
+  q->static_cfo[rxant_id][port_id]     = q->cfo;
+}
+
 static void chest_interpolate_noise_est(srslte_chest_dl_t*     q,
                                         srslte_dl_sf_cfg_t*    sf,
                                         srslte_chest_dl_cfg_t* cfg,
@@ -646,6 +719,8 @@ static void chest_interpolate_noise_est(srslte_chest_dl_t*     q,
   }
 
   if (q->wiener_dl && ch_mode == SRSLTE_SF_NORM && cfg->estimator_alg == SRSLTE_ESTIMATOR_ALG_WIENER) {
+    srslte_wiener_dl_set_bank(q->wiener_dl, cfg->wiener_filter_bank);
+
     bool     ready   = q->wiener_dl->ready;
     uint32_t nre     = q->cell.nof_prb * SRSLTE_NRE;
     uint32_t nref    = q->cell.nof_prb * 2;
@@ -701,12 +776,19 @@ static void chest_interpolate_noise_est(srslte_chest_dl_t*     q,
       ERROR("Warning: Subframe interpolation must be enabled in MBSFN subframes\n");
     }
 
-    /* Smooth estimates (if applicable) and interpolate */
-    if (cfg->filter_type == SRSLTE_CHEST_FILTER_NONE) {
-      interpolate_pilots(q, sf, cfg, q->pilot_estimates, ce, port_id);
-    } else {
-      average_pilots(q, sf, cfg, q->pilot_estimates, q->pilot_estimates_average, port_id, filter, filter_len);
-      interpolate_pilots(q, sf, cfg, q->pilot_estimates_average, ce, port_id);
+    /* Smooth estimates (if applicable) and interpolate, unless the previous estimate is still valid */
+    bool static_channel = cfg->static_channel && ch_mode == SRSLTE_SF_NORM;
+    if (!static_channel || !chest_dl_static_reuse(q, sf, ce, port_id, rxant_id)) {
+      if (cfg->filter_type == SRSLTE_CHEST_FILTER_NONE) {
+        interpolate_pilots(q, sf, cfg, q->pilot_estimates, ce, port_id);
+      } else {
+        average_pilots(q, sf, cfg, q->pilot_estimates, q->pilot_estimates_average, port_id, filter, filter_len);
+        interpolate_pilots(q, sf, cfg, q->pilot_estimates_average, ce, port_id);
+      }
+
+      if (static_channel) {
+        chest_dl_static_store(q, sf, ce, port_id, rxant_id);
+      }
     }
 
     /* Estimate noise for PSS and EMPTY algorithms */
@@ -20,6 +20,7 @@
  */
 
 #include <complex.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
@@ -35,7 +36,11 @@ srslte_cell_t cell = {6,              // nof_prb
                       SRSLTE_PHICH_R_1_6,
                       SRSLTE_FDD};
 
-char* output_matlab = NULL;
+char* output_matlab      = NULL;
+char* estimator_alg      = "average";
+bool  wiener_filter_bank = false;
+bool  static_channel     = false;
+float snr_db             = NAN;
 
 void usage(char* prog)
 {
@@ -46,6 +51,11 @@ void usage(char* prog)
 
   printf("\t-c cell_id (1000 tests all). [Default %d]\n", cell.id);
 
+  printf("\t-a estimator algorithm (average, interpolate, wiener) [Default %s]\n", estimator_alg);
+  printf("\t-b use the Wiener filter bank [Default %s]\n", wiener_filter_bank ? "enabled" : "disabled");
+  printf("\t-s static channel mode [Default %s]\n", static_channel ? "enabled" : "disabled");
+  printf("\t-n SNR in dB [Default no noise]\n");
+
   printf("\t-o output matlab file [Default %s]\n", output_matlab ? output_matlab : "None");
   printf("\t-v increase verbosity\n");
 }
@@ -53,8 +63,20 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "recov")) != -1) {
+  while ((opt = getopt(argc, argv, "recovabsn")) != -1) {
     switch (opt) {
+      case 'a':
+        estimator_alg = argv[optind];
+        break;
+      case 'b':
+        wiener_filter_bank = true;
+        break;
+      case 's':
+        static_channel = true;
+        break;
+      case 'n':
+        snr_db = strtof(argv[optind], NULL);
+        break;
       case 'r':
         cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
@@ -164,6 +186,16 @@ int main(int argc, char** argv)
         }
       }
 
+      if (!isnan(snr_db)) {
+        srslte_ch_awgn_c(input, input, sqrtf(0.5f * srslte_convert_dB_to_power(-snr_db)), num_re);
+      }
+
+      srslte_chest_dl_cfg_t chest_cfg;
+      ZERO_OBJECT(chest_cfg);
+      chest_cfg.estimator_alg      = srslte_chest_dl_str2estimator_alg(estimator_alg);
+      chest_cfg.wiener_filter_bank = wiener_filter_bank;
+      chest_cfg.static_channel     = static_channel;
+
       srslte_chest_dl_res_t res;
 
       res.ce[0][0] = ce;
@@ -174,12 +206,20 @@ int main(int argc, char** argv)
       struct timeval t[3];
       gettimeofday(&t[1], NULL);
       for (int j = 0; j < 100; j++) {
-        srslte_chest_dl_estimate(&est, &sf_cfg, input_m, &res);
+        srslte_chest_dl_estimate_cfg(&est, &sf_cfg, &chest_cfg, input_m, &res);
       }
       gettimeofday(&t[2], NULL);
       get_time_interval(t);
       printf("CHEST: %f us\n", (float)t[0].tv_usec / 100);
 
+      // Channel estimation error normalised to the channel power
+      float err_pwr = 0, h_pwr = 0;
+      for (i = 0; i < num_re; i++) {
+        err_pwr += __real__((ce[i] - h[i]) * conjf(ce[i] - h[i]));
+        h_pwr += __real__(h[i] * conjf(h[i]));
+      }
+      printf("CE-NMSE: %.1f dB\n", srslte_convert_power_to_dB(err_pwr / h_pwr));
+
       gettimeofday(&t[1], NULL);
       for (int j = 0; j < 100; j++) {
         srslte_predecoding_single(input, ce, output, NULL, num_re, 1.0f, 0);
@@ -33,6 +33,7 @@
 #define M_4_3 1.33333333333333333333f /* 4 / 3 */
 #define M_5_3 1.66666666666666666666f /* 5 / 3 */
 #define SRSLTE_WIENER_HALFREF_IDX (q->nof_ref / 2 - 1)
+#define SUBCARRIER_SPACING_HZ 15000.0f
 
 // Constants
 const float hlsv_sum_norm[SRSLTE_WIENER_DL_MIN_RE] = {0.0625f,
@@ -92,7 +93,10 @@ static void                      srslte_wiener_dl_state_reset(srslte_wiener_dl_t
 // Local run function prototypes
 static void
             srslte_wiener_dl_run_symbol_1_8(srslte_wiener_dl_t* q, srslte_wiener_dl_state_t* state, cf_t* pilots, float snr_lin);
-static void srslte_wiener_dl_run_symbol_2_9(srslte_wiener_dl_t* q, srslte_wiener_dl_state_t* state);
+static void srslte_wiener_dl_run_symbol_2_9(srslte_wiener_dl_t*       q,
+                                            srslte_wiener_dl_state_t* state,
+                                            uint32_t                  shift,
+                                            float                     snr_lin);
 static void srslte_wiener_dl_run_symbol_5_12(srslte_wiener_dl_t*       q,
                                              srslte_wiener_dl_state_t* state,
                                              cf_t*                     pilots,
@@ -324,6 +328,23 @@ int srslte_wiener_dl_init(srslte_wiener_dl_t* q, uint32_t max_prb, uint32_t max_
         ret = SRSLTE_ERROR;
       }
     }
+
+    // Allocate filter bank and compute its frequency correlation. It is the one of a uniform power delay profile
+    // spanning the maximum delay spread, the robust choice when the actual profile is unknown
+    for (uint32_t i = 0; i < 2 && !ret; i++) {
+      q->bank[i] = calloc(sizeof(srslte_wiener_dl_bank_entry_t), SRSLTE_WIENER_DL_BANK_NOF_SNR);
+      if (!q->bank[i]) {
+        perror("calloc");
+        ret = SRSLTE_ERROR;
+      }
+    }
+    if (!ret) {
+      q->bank_acV[0] = 1.0f;
+      for (uint32_t k = 1; k < SRSLTE_WIENER_DL_MIN_RE; k++) {
+        float theta    = 2.0f * (float)M_PI * (float)k * SUBCARRIER_SPACING_HZ * SRSLTE_WIENER_DL_BANK_MAX_DELAY_S;
+        q->bank_acV[k] = (cexpf(I * theta) - 1.0f) / (I * theta);
+      }
+    }
   }
 
   return ret;
@@ -371,6 +392,13 @@ void srslte_wiener_dl_reset(srslte_wiener_dl_t* q)
   }
 }
 
+void srslte_wiener_dl_set_bank(srslte_wiener_dl_t* q, bool enable)
+{
+  if (q) {
+    q->bank_enable = enable;
+  }
+}
+
 static void circshift_dim1(cf_t** matrix, uint32_t ndim1, int32_t k)
 {
   // Check valid inputs
@@ -542,6 +570,96 @@ inline static cf_t _cmul(cf_t a, cf_t b)
   return ret;
 }
 
+static void wiener_dl_gen_matrices(srslte_wiener_dl_t* q,
+                                   const cf_t*         acV,
+                                   float               N,
+                                   uint32_t            shift,
+                                   cf_t                wm1[SRSLTE_WIENER_DL_MIN_RE][SRSLTE_WIENER_DL_MIN_REF],
+                                   cf_t                wm2[SRSLTE_WIENER_DL_MIN_RE][SRSLTE_WIENER_DL_MIN_REF])
+{
+  // Compute square wiener correlation matrix
+  for (uint32_t i = 0; i < SRSLTE_WIENER_DL_MIN_REF; i++) {
+    for (uint32_t k = i; k < SRSLTE_WIENER_DL_MIN_REF; k++) {
+      q->RH.m[i][k] = acV[6 * (k - i)];
+      q->RH.m[k][i] = conjf(q->RH.m[i][k]);
+    }
+  }
+
+  // Add noise contribution to the square wiener
+  for (uint32_t i = 0; i < SRSLTE_WIENER_DL_MIN_REF; i++) {
+    q->RH.m[i][i] += N;
+  }
+
+  // Compute wiener correlation inverse matrix
+  srslte_matrix_NxN_inv_run(q->matrix_inverter, q->RH.v, q->invRH.v);
+
+  // Generate Rectangular Wiener
+  for (uint32_t i = 0; i < SRSLTE_WIENER_DL_MIN_RE; i++) {
+    for (uint32_t k = 0; k < SRSLTE_WIENER_DL_MIN_REF; k++) {
+      int m1 = ((shift + 3) % 6) + 6 * k - i;
+      int m2 = shift + 6 * k - i;
+
+      if (m1 >= 0) {
+        q->hH1[i][k] = acV[m1];
+      } else {
+        q->hH1[i][k] = conjf(acV[-m1]);
+      }
+
+      if (m2 >= 0) {
+        q->hH2[i][k] = acV[m2];
+      } else {
+        q->hH2[i][k] = conjf(acV[-m2]);
+      }
+    }
+  }
+
+  // Compute Wiener matrices
+  for (uint32_t dim1 = 0; dim1 < SRSLTE_WIENER_DL_MIN_RE; dim1++) {
+    for (uint32_t dim2 = 0; dim2 < SRSLTE_WIENER_DL_MIN_REF; dim2++) {
+      wm1[dim1][dim2] = 0;
+      wm2[dim1][dim2] = 0;
+      for (int i = 0; i < SRSLTE_WIENER_DL_MIN_REF; i++) {
+        wm1[dim1][dim2] += _cmul(q->hH1[dim1][i], q->invRH.m[i][dim2]);
+        wm2[dim1][dim2] += _cmul(q->hH2[dim1][i], q->invRH.m[i][dim2]);
+      }
+    }
+  }
+}
+
+// Selects the Wiener matrices, from the filter bank if enabled or the ones trained online otherwise
+static void wiener_dl_select_matrices(srslte_wiener_dl_t*       q,
+                                      srslte_wiener_dl_state_t* state,
+                                      uint32_t                  shift,
+                                      float                     snr_lin,
+                                      cf_t (**wm1)[SRSLTE_WIENER_DL_MIN_REF],
+                                      cf_t (**wm2)[SRSLTE_WIENER_DL_MIN_REF])
+{
+  if (!q->bank_enable) {
+    *wm1 = q->wm1;
+    *wm2 = q->wm2;
+    return;
+  }
+
+  // The time averaging length follows the Doppler, so it sets the effective SNR together with the pilot SNR
+  float snr_eff = 15.0f;
+  if (isnormal(snr_lin)) {
+    snr_eff = SRSLTE_MIN(15.0f, snr_lin * SRSLTE_MAX(1, state->sumlen));
+  }
+  int idx = (int)floorf(srslte_convert_power_to_dB(snr_eff)) - SRSLTE_WIENER_DL_BANK_MIN_SNR_DB;
+  idx     = SRSLTE_MIN(SRSLTE_MAX(idx, 0), (int)SRSLTE_WIENER_DL_BANK_NOF_SNR - 1);
+
+  srslte_wiener_dl_bank_entry_t* entry = &q->bank[shift < 3 ? 0 : 1][idx];
+  if (!entry->computed || entry->shift != shift) {
+    float N = srslte_convert_dB_to_power(-(float)(idx + SRSLTE_WIENER_DL_BANK_MIN_SNR_DB));
+    wiener_dl_gen_matrices(q, q->bank_acV, N, shift, entry->wm1, entry->wm2);
+    entry->shift    = shift;
+    entry->computed = true;
+  }
+
+  *wm1 = entry->wm1;
+  *wm2 = entry->wm2;
+}
+
 static void
 srslte_wiener_dl_run_symbol_1_8(srslte_wiener_dl_t* q, srslte_wiener_dl_state_t* state, cf_t* pilots, float snr_lin)
 {
@@ -570,8 +688,14 @@ srslte_wiener_dl_run_symbol_1_8(srslte_wiener_dl_t* q, srslte_wiener_dl_state_t*
   state->skip         = SRSLTE_MAX(1, floorf(halfcx / 4.0f * SRSLTE_MIN(1, snr_lin / 16.0f)));
 }
 
-static void srslte_wiener_dl_run_symbol_2_9(srslte_wiener_dl_t* q, srslte_wiener_dl_state_t* state)
+static void srslte_wiener_dl_run_symbol_2_9(srslte_wiener_dl_t*       q,
+                                            srslte_wiener_dl_state_t* state,
+                                            uint32_t                  shift,
+                                            float                     snr_lin)
 {
+  cf_t(*wm1)[SRSLTE_WIENER_DL_MIN_REF] = NULL;
+  cf_t(*wm2)[SRSLTE_WIENER_DL_MIN_REF] = NULL;
+  wiener_dl_select_matrices(q, state, shift, snr_lin, &wm1, &wm2);
 
   // here we only shift and feed TD interpolation fifo
   circshift_dim1(state->tfifo, SRSLTE_WIENER_DL_TFIFO_SIZE, 1); // shift matrix columns right by one position
@@ -581,7 +705,7 @@ static void srslte_wiener_dl_run_symbol_2_9(srslte_wiener_dl_t* q, srslte_wiener
   srslte_vec_sc_prod_cfc(q->tmp, 1.0f / state->sumlen, q->tmp, q->nof_ref); // Scale sum
 
   // Estimate channel based on the wiener matrix 2
-  estimate_wiener(q, q->wm2, q->tmp, state->tfifo[0]);
+  estimate_wiener(q, wm2, q->tmp, state->tfifo[0]);
 
   // Update internal states
   state->deltan       = 0.0f;
@@ -607,15 +731,20 @@ static void srslte_wiener_dl_run_symbol_5_12(srslte_wiener_dl_t*       q,
   srslte_vec_sc_prod_cfc(q->tmp, 1.0f / state->sumlen, q->tmp, q->nof_ref); // Scale sum
 
   // Estimate channel based on the wiener matrix 1
-  estimate_wiener(q, q->wm1, q->tmp, state->tfifo[0]);
+  cf_t(*wm1)[SRSLTE_WIENER_DL_MIN_REF] = NULL;
+  cf_t(*wm2)[SRSLTE_WIENER_DL_MIN_REF] = NULL;
+  wiener_dl_select_matrices(q, state, shift, snr_lin, &wm1, &wm2);
+  estimate_wiener(q, wm1, q->tmp, state->tfifo[0]);
 
   // Update internal states
   state->deltan       = 0.0f;
   state->invtpilotoff = M_1_4;
   state->cnt++;
 
-  // Online training of Wiener matrices (random sub-bands)
-  if (state->cnt == state->skip) {
+  // Online training of Wiener matrices (random sub-bands), not needed with the filter bank
+  if (state->cnt >= state->skip && q->bank_enable) {
+    state->cnt = 0;
+  } else if (state->cnt == state->skip) {
     state->cnt = 0; // Reset counter
     uint32_t pos1, pos2, nsbb, pstart;
 
@@ -692,14 +821,6 @@ static void srslte_wiener_dl_run_symbol_5_12(srslte_wiener_dl_t*       q,
       // Apply averaging scale
       srslte_vec_sc_prod_cfc(q->acV, 1.0f / (q->nof_tx_ports * q->nof_rx_ant), q->acV, SRSLTE_WIENER_DL_MIN_RE);
 
-      // Compute square wiener correlation matrix
-      for (uint32_t i = 0; i < SRSLTE_WIENER_DL_MIN_REF; i++) {
-        for (uint32_t k = i; k < SRSLTE_WIENER_DL_MIN_REF; k++) {
-          q->RH.m[i][k] = q->acV[6 * (k - i)];
-          q->RH.m[k][i] = conjf(q->RH.m[i][k]);
-        }
-      }
-
       // Add noise contribution to the square wiener
       float N = 0.0f;
 
@@ -707,44 +828,7 @@ static void srslte_wiener_dl_run_symbol_5_12(srslte_wiener_dl_t*       q,
         N = (__real__ q->acV[0] / SRSLTE_MIN(15, snr_lin * state->sumlen));
       }
 
-      for (uint32_t i = 0; i < SRSLTE_WIENER_DL_MIN_REF; i++) {
-        q->RH.m[i][i] += N;
-      }
-
-      // Compute wiener correlation inverse matrix
-      srslte_matrix_NxN_inv_run(q->matrix_inverter, q->RH.v, q->invRH.v);
-
-      // Generate Rectangular Wiener
-      for (uint32_t i = 0; i < SRSLTE_WIENER_DL_MIN_RE; i++) {
-        for (uint32_t k = 0; k < SRSLTE_WIENER_DL_MIN_REF; k++) {
-          int m1 = ((shift + 3) % 6) + 6 * k - i;
-          int m2 = shift + 6 * k - i;
-
-          if (m1 >= 0) {
-            q->hH1[i][k] = q->acV[m1];
-          } else {
-            q->hH1[i][k] = conjf(q->acV[-m1]);
-          }
-
-          if (m2 >= 0) {
-            q->hH2[i][k] = q->acV[m2];
-          } else {
-            q->hH2[i][k] = conjf(q->acV[-m2]);
-          }
-        }
-      }
-
-      // Compute Wiener matrices
-      for (uint32_t dim1 = 0; dim1 < SRSLTE_WIENER_DL_MIN_RE; dim1++) {
-        for (uint32_t dim2 = 0; dim2 < SRSLTE_WIENER_DL_MIN_REF; dim2++) {
-          q->wm1[dim1][dim2] = 0;
-          q->wm2[dim1][dim2] = 0;
-          for (int i = 0; i < SRSLTE_WIENER_DL_MIN_REF; i++) {
-            q->wm1[dim1][dim2] += _cmul(q->hH1[dim1][i], q->invRH.m[i][dim2]);
-            q->wm2[dim1][dim2] += _cmul(q->hH2[dim1][i], q->invRH.m[i][dim2]);
-          }
-        }
-      }
+      wiener_dl_gen_matrices(q, q->acV, N, shift, q->wm1, q->wm2);
       q->wm_computed = true;
     }
   }
@@ -771,13 +855,13 @@ int srslte_wiener_dl_run(srslte_wiener_dl_t* q,
     // Process symbol
     switch (m) {
       case 1:
-        q->ready = q->wm_computed;
+        q->ready = q->wm_computed || q->bank_enable;
       case 8:
         srslte_wiener_dl_run_symbol_1_8(q, state, pilots, snr_lin);
         break;
       case 2:
       case 9:
-        srslte_wiener_dl_run_symbol_2_9(q, state);
+        srslte_wiener_dl_run_symbol_2_9(q, state, shift, snr_lin);
         break;
       case 5:
       case 12:
@@ -826,5 +910,11 @@ void srslte_wiener_dl_free(srslte_wiener_dl_t* q)
       srslte_matrix_NxN_inv_free(q->matrix_inverter);
       free(q->matrix_inverter);
     }
+
+    for (uint32_t i = 0; i < 2; i++) {
+      if (q->bank[i]) {
+        free(q->bank[i]);
+      }
+    }
   }
 }
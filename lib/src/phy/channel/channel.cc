@@ -42,15 +42,15 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
   // Copy args
   args = channel_args;
 
-  // Allocate internal buffers
-  buffer_in  = srslte_vec_cf_malloc(buffer_size);
-  buffer_out = srslte_vec_cf_malloc(buffer_size);
-  if (!buffer_out || !buffer_in) {
-    ret = SRSLTE_ERROR;
-  }
-
   nof_channels = _nof_channels;
   for (uint32_t i = 0; i < nof_channels; i++) {
+    // Allocate internal buffers
+    buffer_in[i]  = srslte_vec_cf_malloc(buffer_size);
+    buffer_out[i] = srslte_vec_cf_malloc(buffer_size);
+    if (!buffer_out[i] || !buffer_in[i]) {
+      ret = SRSLTE_ERROR;
+    }
+
     // Create fading channel
     if (channel_args.fading_enable && !channel_args.fading_model.empty() && channel_args.fading_model != "none" &&
         ret == SRSLTE_SUCCESS) {
@@ -72,19 +72,20 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
     } else {
       delay[i] = nullptr;
     }
-  }
 
-  // Create AWGN channnel
-  if (channel_args.awgn_enable && ret == SRSLTE_SUCCESS) {
-    awgn = (srslte_channel_awgn_t*)calloc(sizeof(srslte_channel_awgn_t), 1);
-    ret  = srslte_channel_awgn_init(awgn, 1234);
-    srslte_channel_awgn_set_n0(awgn, args.awgn_signal_power_dBfs - args.awgn_snr_dB);
-  }
+    // Create AWGN channnel, one independent generator per channel
+    if (channel_args.awgn_enable && ret == SRSLTE_SUCCESS) {
+      awgn[i] = (srslte_channel_awgn_t*)calloc(sizeof(srslte_channel_awgn_t), 1);
+      ret     = srslte_channel_awgn_init(awgn[i], 1234 + i);
+      srslte_channel_awgn_set_n0(awgn[i], args.awgn_signal_power_dBfs - args.awgn_snr_dB);
+    }
 
-  // Create high speed train
-  if (channel_args.hst_enable && ret == SRSLTE_SUCCESS) {
-    hst = (srslte_channel_hst_t*)calloc(sizeof(srslte_channel_hst_t), 1);
-    srslte_channel_hst_init(hst, channel_args.hst_fd_hz, channel_args.hst_period_s, channel_args.hst_init_time_s);
+    // Create high speed train, the instances share parameters and time so they produce the same doppler
+    if (channel_args.hst_enable && ret == SRSLTE_SUCCESS) {
+      hst[i] = (srslte_channel_hst_t*)calloc(sizeof(srslte_channel_hst_t), 1);
+      srslte_channel_hst_init(
+          hst[i], channel_args.hst_fd_hz, channel_args.hst_period_s, channel_args.hst_init_time_s);
+    }
   }
 
   // Create Radio Link Failure simulator
@@ -95,27 +96,31 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels)
 
   if (ret != SRSLTE_SUCCESS) {
     fprintf(stderr, "Error: Creating channel\n\n");
+    return;
+  }
+
+  // Launch worker threads, never more than channels
+  uint32_t nof_threads = SRSLTE_MAX(1, SRSLTE_MIN(args.nof_threads, nof_channels));
+  for (uint32_t w = 1; w < nof_threads; w++) {
+    workers_arg[w] = {this, w};
+    if (pthread_create(&workers[w], nullptr, worker_entry, &workers_arg[w]) != 0) {
+      fprintf(stderr, "Error: creating channel worker thread, processing remaining channels serially\n");
+      break;
+    }
+    nof_workers = w + 1;
   }
 }
 
 channel::~channel()
 {
-  if (buffer_in) {
-    free(buffer_in);
-  }
-
-  if (buffer_out) {
-    free(buffer_out);
-  }
-
-  if (awgn) {
-    srslte_channel_awgn_free(awgn);
-    free(awgn);
+  // Stop workers
+  {
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    workers_quit = true;
   }
-
-  if (hst) {
-    srslte_channel_hst_free(hst);
-    free(hst);
+  cvar_start.notify_all();
+  for (uint32_t w = 1; w < nof_workers; w++) {
+    pthread_join(workers[w], nullptr);
   }
 
   if (rlf) {
@@ -124,6 +129,24 @@ channel::~channel()
   }
 
   for (uint32_t i = 0; i < nof_channels; i++) {
+    if (buffer_in[i]) {
+      free(buffer_in[i]);
+    }
+
+    if (buffer_out[i]) {
+      free(buffer_out[i]);
+    }
+
+    if (awgn[i]) {
+      srslte_channel_awgn_free(awgn[i]);
+      free(awgn[i]);
+    }
+
+    if (hst[i]) {
+      srslte_channel_hst_free(hst[i]);
+      free(hst[i]);
+    }
+
     if (fading[i]) {
       srslte_channel_fading_free(fading[i]);
       free(fading[i]);
@@ -151,66 +174,137 @@ void channel::set_logger(log_filter* _log_h)
   log_h = _log_h;
 }
 
-void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
-                  cf_t*                     out[SRSLTE_MAX_CHANNELS],
-                  uint32_t                  len,
-                  const srslte_timestamp_t& t)
+void channel::run_channel(uint32_t i)
 {
-  // Early return if pointers are not enabled
+  cf_t*                     in  = job_in[i];
+  cf_t*                     out = job_out[i];
+  uint32_t                  len = job_len;
+  const srslte_timestamp_t& t   = job_ts;
+  cf_t*                     bin = buffer_in[i];
+  cf_t*                     bou = buffer_out[i];
+
+  // Skip channel if any buffer is null
   if (in == nullptr || out == nullptr) {
     return;
   }
 
-  // For each channel
-  for (uint32_t i = 0; i < nof_channels; i++) {
-    // Skip iteration if any buffer is null
-    if (in[i] == nullptr || out[i] == nullptr) {
-      continue;
+  // If sampling rate is not set, copy input and skip rest of channel
+  if (current_srate == 0) {
+    if (in != out) {
+      srslte_vec_cf_copy(out, in, len);
     }
+    return;
+  }
 
-    // If sampling rate is not set, copy input and skip rest of channel
-    if (current_srate == 0) {
-      if (in[i] != out[i]) {
-        srslte_vec_cf_copy(out[i], in[i], len);
-      }
-      continue;
-    }
+  // Copy input buffer
+  srslte_vec_cf_copy(bin, in, len);
 
-    // Copy input buffer
-    srslte_vec_cf_copy(buffer_in, in[i], len);
+  if (hst[i]) {
+    srslte_channel_hst_execute(hst[i], bin, bou, len, &t);
+    srslte_vec_sc_prod_ccc(bou, local_cexpf(hst_init_phase), bin, len);
+  }
+
+  if (awgn[i]) {
+    srslte_channel_awgn_run_c(awgn[i], bin, bou, len);
+    srslte_vec_cf_copy(bin, bou, len);
+  }
 
-    if (hst) {
-      srslte_channel_hst_execute(hst, buffer_in, buffer_out, len, &t);
-      srslte_vec_sc_prod_ccc(buffer_out, local_cexpf(hst_init_phase), buffer_in, len);
+  if (fading[i]) {
+    srslte_channel_fading_execute(fading[i], bin, bou, len, t.full_secs + t.frac_secs);
+    srslte_vec_cf_copy(bin, bou, len);
+  }
+
+  if (delay[i]) {
+    srslte_channel_delay_execute(delay[i], bin, bou, len, &t);
+    srslte_vec_cf_copy(bin, bou, len);
+  }
+
+  if (rlf) {
+    srslte_channel_rlf_execute(rlf, bin, bou, len, &t);
+    srslte_vec_cf_copy(bin, bou, len);
+  }
+
+  // Copy output buffer
+  srslte_vec_cf_copy(out, bin, len);
+}
+
+void* channel::worker_entry(void* arg)
+{
+  auto* a = (worker_arg_t*)arg;
+  a->parent->run_worker(a->id);
+  return nullptr;
+}
+
+void channel::run_worker(uint32_t worker_id)
+{
+  uint64_t last_job = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(workers_mutex);
+      while (!workers_quit && job_count == last_job) {
+        cvar_start.wait(lock);
+      }
+      if (workers_quit) {
+        return;
+      }
+      last_job = job_count;
     }
 
-    if (awgn) {
-      srslte_channel_awgn_run_c(awgn, buffer_in, buffer_out, len);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
+    for (uint32_t i = worker_id; i < nof_channels; i += nof_workers) {
+      run_channel(i);
     }
 
-    if (fading[i]) {
-      srslte_channel_fading_execute(fading[i], buffer_in, buffer_out, len, t.full_secs + t.frac_secs);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
+    {
+      std::unique_lock<std::mutex> lock(workers_mutex);
+      pending_workers--;
     }
+    cvar_done.notify_one();
+  }
+}
 
-    if (delay[i]) {
-      srslte_channel_delay_execute(delay[i], buffer_in, buffer_out, len, &t);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
+void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
+                  cf_t*                     out[SRSLTE_MAX_CHANNELS],
+                  uint32_t                  len,
+                  const srslte_timestamp_t& t)
+{
+  // Early return if pointers are not enabled
+  if (in == nullptr || out == nullptr) {
+    return;
+  }
+
+  job_in  = in;
+  job_out = out;
+  job_len = len;
+  job_ts  = t;
+
+  if (nof_workers == 1) {
+    // Serial processing in the calling thread
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      run_channel(i);
+    }
+  } else {
+    // Wake up the workers and process the channels of worker 0 meanwhile
+    {
+      std::unique_lock<std::mutex> lock(workers_mutex);
+      pending_workers = nof_workers - 1;
+      job_count++;
     }
+    cvar_start.notify_all();
 
-    if (rlf) {
-      srslte_channel_rlf_execute(rlf, buffer_in, buffer_out, len, &t);
-      srslte_vec_cf_copy(buffer_in, buffer_out, len);
+    for (uint32_t i = 0; i < nof_channels; i += nof_workers) {
+      run_channel(i);
     }
 
-    // Copy output buffer
-    srslte_vec_cf_copy(out[i], buffer_in, len);
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    while (pending_workers > 0) {
+      cvar_done.wait(lock);
+    }
   }
 
-  if (hst) {
+  if (hst[0]) {
     // Increment phase to keep it coherent between frames
-    hst_init_phase += (2 * M_PI * len * hst->fs_hz / hst->srate_hz);
+    hst_init_phase += (2 * M_PI * len * hst[0]->fs_hz / hst[0]->srate_hz);
 
     // Positive Remainder
     while (hst_init_phase > 2 * M_PI) {
@@ -233,8 +327,8 @@ void channel::run(cf_t*                     in[SRSLTE_MAX_CHANNELS],
       str << "delay=" << delay[0]->delay_us << "us; ";
     }
 
-    if (hst) {
-      str << "hst=" << hst->fs_hz << "Hz; ";
+    if (hst[0]) {
+      str << "hst=" << hst[0]->fs_hz << "Hz; ";
     }
 
     log_h->debug("%s\n", str.str().c_str());
@@ -254,12 +348,13 @@ void channel::set_srate(uint32_t srate)
       if (delay[i]) {
         srslte_channel_delay_update_srate(delay[i], srate);
       }
-    }
 
-    if (hst) {
-      srslte_channel_hst_update_srate(hst, srate);
+      if (hst[i]) {
+        srslte_channel_hst_update_srate(hst[i], srate);
+      }
     }
 
+
     // Update sampling rate
     current_srate = srate;
   }
@@ -267,7 +362,9 @@ void channel::set_srate(uint32_t srate)
 
 void channel::set_signal_power_dBfs(float power_dBfs)
 {
-  if (awgn != nullptr) {
-    srslte_channel_awgn_set_n0(awgn, power_dBfs - args.awgn_snr_dB);
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    if (awgn[i] != nullptr) {
+      srslte_channel_awgn_set_n0(awgn[i], power_dBfs - args.awgn_snr_dB);
+    }
   }
 }
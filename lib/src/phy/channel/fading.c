@@ -21,6 +21,7 @@
 
 #include "srslte/phy/channel/fading.h"
 #include "srslte/phy/utils/random.h"
+#include "srslte/phy/utils/simd.h"
 #include "srslte/phy/utils/vector.h"
 #include <math.h>
 #include <stdio.h>
@@ -77,80 +78,72 @@ static inline int parse_model(srslte_channel_fading_t* q, const char* str)
   return ret;
 }
 
-#ifdef LV_HAVE_SSE
-#include <immintrin.h>
-static inline __m128 _sine(const float* table, __m128 arg)
+#if SRSLTE_SIMD_F_SIZE
+/*
+ * Vector sine: the argument is reduced to [-pi, pi] and evaluated with an odd polynomial of 11th order. The maximum
+ * absolute error is below 3e-5, well below the resolution of the former 1024 points look-up table, and it does not
+ * need any gather so it scales with the vector width (SSE, AVX2, AVX512 and NEON).
+ */
+static inline simd_f_t fading_simd_sine(simd_f_t arg)
 {
-  __m128 ret;
-  int    idx[4];
-  float  sine[4];
-
-  __m128 turns =
-      _mm_round_ps(_mm_mul_ps(arg, _mm_set1_ps(1.0f / (2.0f * (float)M_PI))), (_MM_FROUND_TO_ZERO + _MM_FROUND_NO_EXC));
-  __m128  argmod   = _mm_sub_ps(arg, _mm_mul_ps(turns, _mm_set1_ps(2.0f * (float)M_PI)));
-  __m128  indexps  = _mm_mul_ps(argmod, _mm_set1_ps(1024.0f / (2.0f * (float)M_PI)));
-  __m128i indexi32 = _mm_abs_epi32(_mm_cvtps_epi32(indexps));
-  _mm_store_si128((__m128i*)idx, indexi32);
-
-  for (int i = 0; i < 4; i++) {
-    sine[i] = table[idx[i]];
-  }
-
-  ret = _mm_load_ps(sine);
-  return ret;
+  simd_f_t turns = srslte_simd_f_round(srslte_simd_f_mul(arg, srslte_simd_f_set1(1.0f / (2.0f * (float)M_PI))));
+  simd_f_t x     = srslte_simd_f_sub(arg, srslte_simd_f_mul(turns, srslte_simd_f_set1(2.0f * (float)M_PI)));
+  simd_f_t x2    = srslte_simd_f_mul(x, x);
+
+  // Horner evaluation of x - x^3/3! + x^5/5! - x^7/7! + x^9/9! - x^11/11!
+  simd_f_t p = srslte_simd_f_set1(-2.5052108e-8f);
+  p          = srslte_simd_f_add(srslte_simd_f_mul(p, x2), srslte_simd_f_set1(2.7557319e-6f));
+  p          = srslte_simd_f_add(srslte_simd_f_mul(p, x2), srslte_simd_f_set1(-1.9841270e-4f));
+  p          = srslte_simd_f_add(srslte_simd_f_mul(p, x2), srslte_simd_f_set1(8.3333333e-3f));
+  p          = srslte_simd_f_add(srslte_simd_f_mul(p, x2), srslte_simd_f_set1(-1.6666667e-1f));
+  p          = srslte_simd_f_add(srslte_simd_f_mul(p, x2), srslte_simd_f_set1(1.0f));
+
+  return srslte_simd_f_mul(p, x);
 }
 
-static inline __m128 _cosine(float* table, __m128 arg)
+static inline simd_f_t fading_simd_cosine(simd_f_t arg)
 {
-  arg = _mm_add_ps(arg, _mm_set1_ps((float)M_PI_2));
-  return _sine(table, arg);
+  return fading_simd_sine(srslte_simd_f_add(arg, srslte_simd_f_set1((float)M_PI_2)));
 }
-#endif /*LV_HAVE_SSE*/
+#endif /* SRSLTE_SIMD_F_SIZE */
 
-static inline cf_t
-get_doppler_dispersion(srslte_channel_fading_t* q, float t, float F_d, float* alpha, float* a, float* b)
+static inline cf_t get_doppler_dispersion(float t, float F_d, const float* alpha, const float* a, const float* b)
 {
-#ifdef LV_HAVE_SSE
-  const float recN   = 1.0f / sqrtf(SRSLTE_CHANNEL_FADING_NTERMS);
-  cf_t        ret    = 0;
-  __m128      _reacc = _mm_setzero_ps();
-  __m128      _imacc = _mm_setzero_ps();
-  __m128      _arg   = _mm_set1_ps((float)M_PI * F_d);
-  __m128      _t     = _mm_set1_ps(t);
-  __m128      _arg_  = (_mm_mul_ps(_arg, _t));
-
-  for (int i = 0; i < SRSLTE_CHANNEL_FADING_NTERMS; i += 4) {
-    __m128 _alpha = _mm_loadu_ps(&alpha[i]);
-    __m128 _a     = _mm_loadu_ps(&a[i]);
-    __m128 _b     = _mm_loadu_ps(&b[i]);
-    __m128 _arg1  = _mm_mul_ps(_arg_, _cosine(q->sin_table, _alpha));
-    __m128 _re    = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
-    __m128 _im    = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
-    _reacc        = _mm_add_ps(_reacc, _re);
-    _imacc        = _mm_add_ps(_imacc, _im);
-  }
-
-  __m128 _tmp = _mm_hadd_ps(_reacc, _imacc);
-  _tmp        = _mm_hadd_ps(_tmp, _tmp);
-  float r[4];
-  _mm_store_ps(r, _tmp);
-  __real__ ret = r[0];
-  __imag__ ret = r[1];
-
-  return ret * recN;
-
-#else
   const float recN = 1.0f / sqrtf(SRSLTE_CHANNEL_FADING_NTERMS);
   cf_t        r    = 0;
+  uint32_t    i    = 0;
+
+#if SRSLTE_SIMD_F_SIZE
+  simd_f_t _reacc = srslte_simd_f_zero();
+  simd_f_t _imacc = srslte_simd_f_zero();
+  simd_f_t _arg   = srslte_simd_f_set1((float)M_PI * F_d * t);
+
+  for (; i + SRSLTE_SIMD_F_SIZE - 1 < SRSLTE_CHANNEL_FADING_NTERMS; i += SRSLTE_SIMD_F_SIZE) {
+    simd_f_t _alpha = srslte_simd_f_loadu(&alpha[i]);
+    simd_f_t _a     = srslte_simd_f_loadu(&a[i]);
+    simd_f_t _b     = srslte_simd_f_loadu(&b[i]);
+    simd_f_t _arg1  = srslte_simd_f_mul(_arg, fading_simd_cosine(_alpha));
+    _reacc          = srslte_simd_f_add(_reacc, fading_simd_cosine(srslte_simd_f_add(_arg1, _a)));
+    _imacc          = srslte_simd_f_add(_imacc, fading_simd_sine(srslte_simd_f_add(_arg1, _b)));
+  }
 
-  for (uint32_t i = 0; i < SRSLTE_CHANNEL_FADING_NTERMS; i++) {
+  float re[SRSLTE_SIMD_F_SIZE];
+  float im[SRSLTE_SIMD_F_SIZE];
+  srslte_simd_f_storeu(re, _reacc);
+  srslte_simd_f_storeu(im, _imacc);
+  for (uint32_t j = 0; j < SRSLTE_SIMD_F_SIZE; j++) {
+    __real__ r += re[j];
+    __imag__ r += im[j];
+  }
+#endif /* SRSLTE_SIMD_F_SIZE */
+
+  for (; i < SRSLTE_CHANNEL_FADING_NTERMS; i++) {
     float arg = (float)M_PI * F_d * cosf(alpha[i]) * t;
     __real__ r += cosf(arg + a[i]);
     __imag__ r += sinf(arg + b[i]);
   }
 
   return recN * r;
-#endif /*LV_HAVE_SSE*/
 }
 
 static inline void generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, uint32_t N, uint32_t path_delay)
@@ -167,7 +160,7 @@ static inline void generate_taps(srslte_channel_fading_t* q, float time)
   // Generate taps
   for (int i = 0; i < nof_taps[q->model]; i++) {
     // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
+    cf_t a = get_doppler_dispersion(time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
 
     if (i) {
       // Copy tap frequency response
@@ -252,11 +245,6 @@ int srslte_channel_fading_init(srslte_channel_fading_t* q, double srate, const c
           excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->h_tap[i], q->N, q->path_delay);
     }
 
-    // Generate sine Table
-    for (uint32_t i = 0; i < 1024; i++) {
-      q->sin_table[i] = sinf((float)i * 2.0f * (float)M_PI / 1024);
-    }
-
     // Free random
     srslte_random_free(random);
 
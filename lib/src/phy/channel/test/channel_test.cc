@@ -0,0 +1,153 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/test_common.h"
+#include <srslte/phy/channel/channel.h>
+#include <srslte/phy/utils/vector.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static uint32_t    nof_channels  = 4;
+static uint32_t    nof_threads   = 4;
+static uint32_t    nof_prb       = 25;
+static uint32_t    nof_subframes = 100;
+static std::string fading_model  = "etu70";
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [cnpSm]\n", prog);
+  printf("\t-c Number of channels [Default %d]\n", nof_channels);
+  printf("\t-n Number of worker threads [Default %d]\n", nof_threads);
+  printf("\t-p Number of PRB [Default %d]\n", nof_prb);
+  printf("\t-S Number of subframes [Default %d]\n", nof_subframes);
+  printf("\t-m Fading model [Default %s]\n", fading_model.c_str());
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "cnpSm")) != -1) {
+    switch (opt) {
+      case 'c':
+        nof_channels = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        nof_subframes = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        fading_model = argv[optind];
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(nof_channels <= SRSLTE_MAX_CHANNELS);
+
+  uint32_t sf_len = SRSLTE_SF_LEN_PRB(nof_prb);
+  uint32_t srate  = (uint32_t)srslte_sampling_freq_hz(nof_prb);
+
+  srslte::channel::args_t args = {};
+  args.enable                  = true;
+  args.awgn_enable             = true;
+  args.awgn_snr_dB             = 20.0f;
+  args.fading_enable           = true;
+  args.fading_model            = fading_model;
+  args.delay_enable            = true;
+  args.hst_enable              = true;
+
+  // Serial reference and parallel emulators with the same configuration
+  srslte::channel serial(args, nof_channels);
+  args.nof_threads = nof_threads;
+  srslte::channel parallel(args, nof_channels);
+  serial.set_srate(srate);
+  parallel.set_srate(srate);
+
+  cf_t* input[SRSLTE_MAX_CHANNELS]      = {};
+  cf_t* out_serial[SRSLTE_MAX_CHANNELS] = {};
+  cf_t* out_par[SRSLTE_MAX_CHANNELS]    = {};
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    input[i]      = srslte_vec_cf_malloc(sf_len);
+    out_serial[i] = srslte_vec_cf_malloc(sf_len);
+    out_par[i]    = srslte_vec_cf_malloc(sf_len);
+    TESTASSERT(input[i] != nullptr && out_serial[i] != nullptr && out_par[i] != nullptr);
+  }
+
+  srslte_random_t    random      = srslte_random_init(0x1234);
+  srslte_timestamp_t ts          = {};
+  uint64_t           time_serial = 0;
+  uint64_t           time_par    = 0;
+  struct timeval     t[3]        = {};
+
+  for (uint32_t sf = 0; sf < nof_subframes; sf++) {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      srslte_random_uniform_complex_dist_vector(random, input[i], sf_len, -1.0f, +1.0f);
+    }
+
+    gettimeofday(&t[1], NULL);
+    serial.run(input, out_serial, sf_len, ts);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    time_serial += (uint64_t)t[0].tv_sec * 1000000 + t[0].tv_usec;
+
+    gettimeofday(&t[1], NULL);
+    parallel.run(input, out_par, sf_len, ts);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    time_par += (uint64_t)t[0].tv_sec * 1000000 + t[0].tv_usec;
+
+    // The parallel emulator must be bit exact with the serial one
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      TESTASSERT(memcmp(out_serial[i], out_par[i], sizeof(cf_t) * sf_len) == 0);
+    }
+
+    srslte_timestamp_add(&ts, 0, 1e-3);
+  }
+
+  printf("%d channels, %d subframes: serial %.1f us/sf, %d threads %.1f us/sf\n",
+         nof_channels,
+         nof_subframes,
+         (double)time_serial / nof_subframes,
+         nof_threads,
+         (double)time_par / nof_subframes);
+
+  srslte_random_free(random);
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    free(input[i]);
+    free(out_serial[i]);
+    free(out_par[i]);
+  }
+
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
@@ -19,12 +19,17 @@
  *
  */
 
+#include <fcntl.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "srslte/phy/fec/cbsegm.h"
 #include "srslte/phy/fec/rm_turbo.h"
@@ -76,9 +81,10 @@ static uint16_t                 interleaver_systematic_bits[192][6160]; // 4 tai
 static srslte_bit_interleaver_t bit_interleavers_systematic_bits[192];
 static uint16_t                 interleaver_parity_bits[192][2 * 6160];
 static srslte_bit_interleaver_t bit_interleavers_parity_bits[192];
-static uint16_t                 deinterleaver[192][4][18448];
 static int                      k0_vec[SRSLTE_NOF_TC_CB_SIZES][4][2];
 static bool                     rm_turbo_tables_generated = false;
+static uint32_t                 rm_turbo_tables_users     = 0;
+static pthread_mutex_t          rm_turbo_tables_mutex     = PTHREAD_MUTEX_INITIALIZER;
 
 // Store deinterleaver version for sub-block turbo decoder
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
@@ -97,9 +103,41 @@ int              deinter_table_idx_from_sb_len(uint32_t nof_subblocks)
   }
   return -1;
 }
-static uint16_t deinterleaver_sb[NOF_DEINTER_TABLE_SB_IDX][192][4][18448];
+#else
+#define NOF_DEINTER_TABLE_SB_IDX 0
 #endif
 
+/* The receive deinterleavers are by far the largest tables. Table 0 is the plain deinterleaver, tables 1 to
+ * NOF_DEINTER_TABLE_SB_IDX are the versions for the sub-block turbo decoder. They are either generated in the heap or
+ * mapped read-only from a cache file, so that several processes on one host share the same physical pages. */
+#define NOF_DEINTER_TABLES (1 + NOF_DEINTER_TABLE_SB_IDX)
+#define DEINTER_TABLE_LEN 18448
+
+typedef uint16_t rm_turbo_deinter_table_t[SRSLTE_NOF_TC_CB_SIZES][4][DEINTER_TABLE_LEN];
+
+static rm_turbo_deinter_table_t* deinter_tables     = NULL;
+static void*                     deinter_tables_map = NULL;
+static size_t                    deinter_tables_map_len;
+
+#define deinterleaver (deinter_tables[0])
+#define deinterleaver_sb(s) (deinter_tables[1 + (s)])
+
+/* Cache file layout: one page of header followed by the deinterleaver tables in native byte order */
+#define RM_TURBO_CACHE_MAGIC 0x52544d52 // "RMTR"
+#define RM_TURBO_CACHE_VERSION 1
+#define RM_TURBO_CACHE_HEADER_LEN 4096
+#define RM_TURBO_CACHE_ENV "SRSLTE_RM_TURBO_CACHE"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t nof_tables;
+  uint32_t nof_cb_sizes;
+  uint64_t tables_len;
+} rm_turbo_cache_header_t;
+
+static char rm_turbo_cache_file[256] = {};
+
 static uint16_t temp_table1[3 * 6176], temp_table2[3 * 6176];
 
 static void srslte_rm_turbo_gentable_systematic(uint16_t* table_bits, int k0_vec_[4][2], uint32_t nrows, int ndummy)
@@ -277,8 +315,139 @@ static void interleave_table_sb(uint16_t* in, uint16_t* out, uint32_t cb_idx, ui
 }
 #endif
 
+static void rm_turbo_gentables_deinter(rm_turbo_deinter_table_t* tables)
+{
+  for (int cb_idx = 0; cb_idx < SRSLTE_NOF_TC_CB_SIZES; cb_idx++) {
+    int in_len = 3 * srslte_cbsegm_cbsize(cb_idx) + 12;
+    for (int i = 0; i < 4; i++) {
+      srslte_rm_turbo_gentable_receive(tables[0][cb_idx][i], in_len, i);
+
+#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
+      for (uint32_t s = 0; s < NOF_DEINTER_TABLE_SB_IDX; s++) {
+        interleave_table_sb(tables[0][cb_idx][i], tables[1 + s][cb_idx][i], cb_idx, deinter_table_sb_idx[s]);
+      }
+#endif
+    }
+  }
+}
+
+// Maps the tables of a cache file read-only. Returns NULL if the file does not exist or was built for other tables.
+static rm_turbo_deinter_table_t* rm_turbo_cache_map(const char* path)
+{
+  size_t len = RM_TURBO_CACHE_HEADER_LEN + sizeof(rm_turbo_deinter_table_t) * NOF_DEINTER_TABLES;
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size != len) {
+    close(fd);
+    return NULL;
+  }
+  void* map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+
+  const rm_turbo_cache_header_t* header = (const rm_turbo_cache_header_t*)map;
+  if (header->magic != RM_TURBO_CACHE_MAGIC || header->version != RM_TURBO_CACHE_VERSION ||
+      header->nof_tables != NOF_DEINTER_TABLES || header->nof_cb_sizes != SRSLTE_NOF_TC_CB_SIZES ||
+      header->tables_len != sizeof(rm_turbo_deinter_table_t) * NOF_DEINTER_TABLES) {
+    munmap(map, len);
+    return NULL;
+  }
+
+  deinter_tables_map     = map;
+  deinter_tables_map_len = len;
+  return (rm_turbo_deinter_table_t*)((uint8_t*)map + RM_TURBO_CACHE_HEADER_LEN);
+}
+
+// Writes a cache file. It is written under a temporary name and renamed, so other processes never map a partial file
+static int rm_turbo_cache_write(const char* path, rm_turbo_deinter_table_t* tables)
+{
+  char tmp_path[sizeof(rm_turbo_cache_file) + 16];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+
+  FILE* f = fopen(tmp_path, "wb");
+  if (!f) {
+    return SRSLTE_ERROR;
+  }
+
+  static uint8_t           header_page[RM_TURBO_CACHE_HEADER_LEN];
+  rm_turbo_cache_header_t* header = (rm_turbo_cache_header_t*)header_page;
+  header->magic                   = RM_TURBO_CACHE_MAGIC;
+  header->version                 = RM_TURBO_CACHE_VERSION;
+  header->nof_tables              = NOF_DEINTER_TABLES;
+  header->nof_cb_sizes            = SRSLTE_NOF_TC_CB_SIZES;
+  header->tables_len              = sizeof(rm_turbo_deinter_table_t) * NOF_DEINTER_TABLES;
+
+  bool ok = fwrite(header_page, 1, sizeof(header_page), f) == sizeof(header_page) &&
+            fwrite(tables, sizeof(rm_turbo_deinter_table_t), NOF_DEINTER_TABLES, f) == NOF_DEINTER_TABLES;
+  ok = (fclose(f) == 0) && ok;
+  if (!ok || rename(tmp_path, path) < 0) {
+    unlink(tmp_path);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+static void rm_turbo_load_deinter_tables()
+{
+  const char* path = rm_turbo_cache_file[0] ? rm_turbo_cache_file : getenv(RM_TURBO_CACHE_ENV);
+  if (path && strlen(path) >= sizeof(rm_turbo_cache_file)) {
+    ERROR("Rate matching table cache path is too long, ignoring it\n");
+    path = NULL;
+  }
+
+  if (path && path[0]) {
+    deinter_tables = rm_turbo_cache_map(path);
+    if (deinter_tables) {
+      INFO("Mapped rate matching tables from %s\n", path);
+      return;
+    }
+  }
+
+  rm_turbo_deinter_table_t* tables = srslte_vec_malloc(sizeof(rm_turbo_deinter_table_t) * NOF_DEINTER_TABLES);
+  if (!tables) {
+    ERROR("Error allocating rate matching tables\n");
+    return;
+  }
+  rm_turbo_gentables_deinter(tables);
+
+  // Replace the private copy by the shared mapping once it is in the cache
+  if (path && path[0]) {
+    if (rm_turbo_cache_write(path, tables) == SRSLTE_SUCCESS) {
+      deinter_tables = rm_turbo_cache_map(path);
+    } else {
+      ERROR("Error writing rate matching table cache %s\n", path);
+    }
+  }
+  if (deinter_tables) {
+    free(tables);
+  } else {
+    deinter_tables = tables;
+  }
+}
+
+void srslte_rm_turbo_set_cache_file(const char* path)
+{
+  pthread_mutex_lock(&rm_turbo_tables_mutex);
+  if (path == NULL) {
+    rm_turbo_cache_file[0] = '\0';
+  } else if (strlen(path) < sizeof(rm_turbo_cache_file)) {
+    strcpy(rm_turbo_cache_file, path);
+  } else {
+    ERROR("Rate matching table cache path is too long, ignoring it\n");
+  }
+  pthread_mutex_unlock(&rm_turbo_tables_mutex);
+}
+
 void srslte_rm_turbo_gentables()
 {
+  pthread_mutex_lock(&rm_turbo_tables_mutex);
+  rm_turbo_tables_users++;
   if (!rm_turbo_tables_generated) {
     rm_turbo_tables_generated = true;
     for (int cb_idx = 0; cb_idx < SRSLTE_NOF_TC_CB_SIZES; cb_idx++) {
@@ -305,31 +474,34 @@ void srslte_rm_turbo_gentables()
       srslte_bit_interleaver_init(&bit_interleavers_parity_bits[cb_idx],
                                   interleaver_parity_bits[cb_idx],
                                   (uint32_t)(srslte_cbsegm_cbsize(cb_idx) + 4) * 2);
-
-      for (int i = 0; i < 4; i++) {
-        srslte_rm_turbo_gentable_receive(deinterleaver[cb_idx][i], in_len, i);
-
-#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-        for (uint32_t s = 0; s < NOF_DEINTER_TABLE_SB_IDX; s++) {
-          interleave_table_sb(
-              deinterleaver[cb_idx][i], deinterleaver_sb[s][cb_idx][i], cb_idx, deinter_table_sb_idx[s]);
-        }
-#endif
-      }
     }
+
+    rm_turbo_load_deinter_tables();
   }
+  pthread_mutex_unlock(&rm_turbo_tables_mutex);
 }
 
 void srslte_rm_turbo_free_tables()
 {
-  if (rm_turbo_tables_generated) {
+  pthread_mutex_lock(&rm_turbo_tables_mutex);
+  if (rm_turbo_tables_users > 0) {
+    rm_turbo_tables_users--;
+  }
+  if (rm_turbo_tables_generated && rm_turbo_tables_users == 0) {
     for (int i = 0; i < SRSLTE_NOF_TC_CB_SIZES; i++) {
       srslte_bit_interleaver_free(&bit_interleavers_systematic_bits[i]);
       srslte_bit_interleaver_free(&bit_interleavers_parity_bits[i]);
     }
+    if (deinter_tables_map) {
+      munmap(deinter_tables_map, deinter_tables_map_len);
+      deinter_tables_map = NULL;
+    } else if (deinter_tables) {
+      free(deinter_tables);
+    }
+    deinter_tables            = NULL;
     rm_turbo_tables_generated = false;
   }
-  rm_turbo_tables_generated = false;
+  pthread_mutex_unlock(&rm_turbo_tables_mutex);
 }
 
 /**
@@ -415,7 +587,7 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
                             bool     enable_input_tdec)
 {
 
-  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
+  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES && deinter_tables) {
 
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
     int       cb_len  = srslte_cbsegm_cbsize(cb_idx);
@@ -424,7 +596,7 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
     if (idx < 0 || !enable_input_tdec) {
       deinter = deinterleaver[cb_idx][rv_idx];
     } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-      deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
+      deinter = deinterleaver_sb(idx)[cb_idx][rv_idx];
     } else {
       ERROR("Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
       return -1;
@@ -455,7 +627,7 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
 
 int srslte_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
 {
-  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
+  if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES && deinter_tables) {
 
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
     int       cb_len  = srslte_cbsegm_cbsize(cb_idx);
@@ -464,7 +636,7 @@ int srslte_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len,
     if (idx < 0) {
       deinter = deinterleaver[cb_idx][rv_idx];
     } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-      deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
+      deinter = deinterleaver_sb(idx)[cb_idx][rv_idx];
     } else {
       ERROR("Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
       return -1;
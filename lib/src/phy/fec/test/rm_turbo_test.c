@@ -33,6 +33,7 @@
 uint32_t nof_e_bits = 0;
 uint32_t rv_idx     = 0;
 uint32_t cb_idx     = 0;
+char*    cache_file = NULL;
 
 uint8_t systematic[6148], parity[2 * 6148];
 uint8_t systematic_bytes[6148 / 8 + 1], parity_bytes[2 * 6148 / 8 + 1];
@@ -47,13 +48,13 @@ short   bits2_s[3 * 6144 + 12];
 
 void usage(char* prog)
 {
-  printf("Usage: %s -c cb_idx -e nof_e_bits [-i rv_idx]\n", prog);
+  printf("Usage: %s -c cb_idx -e nof_e_bits [-i rv_idx] [-f table_cache_file]\n", prog);
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "cei")) != -1) {
+  while ((opt = getopt(argc, argv, "ceif")) != -1) {
     switch (opt) {
       case 'c':
         cb_idx = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -64,6 +65,9 @@ void parse_args(int argc, char** argv)
       case 'i':
         rv_idx = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'f':
+        cache_file = argv[optind];
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -84,6 +88,12 @@ int main(int argc, char** argv)
 
   parse_args(argc, argv);
 
+  if (cache_file) {
+    // The first run creates the cache, the tables of the second are mapped from it
+    srslte_rm_turbo_set_cache_file(cache_file);
+    srslte_rm_turbo_gentables();
+    srslte_rm_turbo_free_tables();
+  }
   srslte_rm_turbo_gentables();
 
   rm_bits_s = srslte_vec_i16_malloc(nof_e_bits);
@@ -36,6 +36,7 @@ static int      frame_length = 1000, nof_frames = 256;
 static float    ebno_db     = 100.0;
 static uint32_t seed        = 0;
 static bool     tail_biting = false;
+static bool     test_batch  = false;
 
 #define SNR_POINTS 10
 #define SNR_MIN 0.0
@@ -49,12 +50,13 @@ void usage(char* prog)
   printf("\t-e ebno in dB [Default scan]\n");
   printf("\t-s seed [Default 0=time]\n");
   printf("\t-t tail_bitting [Default %s]\n", tail_biting ? "yes" : "no");
+  printf("\t-b also decode with the batched decoder [Default %s]\n", test_batch ? "yes" : "no");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "nlste")) != -1) {
+  while ((opt = getopt(argc, argv, "nlsteb")) != -1) {
     switch (opt) {
       case 'n':
         nof_frames = (int)strtol(argv[optind], NULL, 10);
@@ -71,6 +73,9 @@ void parse_args(int argc, char** argv)
       case 't':
         tail_biting = true;
         break;
+      case 'b':
+        test_batch = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -78,7 +83,7 @@ void parse_args(int argc, char** argv)
   }
 }
 
-#define VITERBI_TEST(FUNC, DEC, LLR, NOF_ERRORS)                                                                       \
+#define VITERBI_TEST(FUNC, DEC, LLR, NOF_ERRORS, TIME_US)                                                              \
   do {                                                                                                                 \
     struct timeval t[3] = {};                                                                                          \
     int            M    = 1;                                                                                           \
@@ -91,7 +96,7 @@ void parse_args(int argc, char** argv)
     }                                                                                                                  \
     gettimeofday(&t[2], NULL);                                                                                         \
     get_time_interval(t);                                                                                              \
-    /*printf("-- "#FUNC" took\t\t%.1f us\n", (float) t[0].tv_sec * 1e6f + (float) t[0].tv_usec/M);*/                   \
+    TIME_US += t[0].tv_sec * 1000000 + t[0].tv_usec;                                                                   \
     if (NOF_ERRORS >= 0) {                                                                                             \
       NOF_ERRORS += srslte_bit_diff(data_tx, data_rx, frame_length);                                                   \
     }                                                                                                                  \
@@ -114,12 +119,20 @@ int main(int argc, char** argv)
   int       errors_c   = 0;
   int       errors_f   = 0;
   int       errors_sse = 0;
+  int       errors_b   = 0;
+  uint64_t  time_f     = 0;
+  uint64_t  time_b     = 0;
+  uint64_t  time_other = 0;
+  uint32_t  nof_b      = 0;
+  float*    llr_b[SRSLTE_VITERBI_BATCH_MAX];
+  uint8_t*  data_b[SRSLTE_VITERBI_BATCH_MAX];
 #ifdef TEST_SSE
   srslte_viterbi_t dec_sse;
 #endif
-  srslte_viterbi_t   dec;
-  srslte_convcoder_t cod;
-  int                coded_length;
+  srslte_viterbi_t       dec;
+  srslte_viterbi_batch_t dec_b;
+  srslte_convcoder_t     cod;
+  int                    coded_length;
 
   parse_args(argc, argv);
 
@@ -139,6 +152,13 @@ int main(int argc, char** argv)
   srslte_viterbi_init(&dec, SRSLTE_VITERBI_37, cod.poly, frame_length, cod.tail_biting);
   printf("Convolutional Code 1/3 K=%d Tail bitting: %s\n", cod.K, cod.tail_biting ? "yes" : "no");
 
+  if (test_batch) {
+    if (srslte_viterbi_batch_init(&dec_b, SRSLTE_VITERBI_37, cod.poly, frame_length, cod.tail_biting)) {
+      ERROR("Error initiating batched decoder\n");
+      exit(-1);
+    }
+  }
+
 #ifdef TEST_SSE
   srslte_viterbi_init_sse(&dec_sse, SRSLTE_VITERBI_37, cod.poly, frame_length, cod.tail_biting);
 #endif
@@ -185,6 +205,14 @@ int main(int argc, char** argv)
     perror("malloc");
     exit(-1);
   }
+  for (uint32_t i = 0; i < SRSLTE_VITERBI_BATCH_MAX; i++) {
+    llr_b[i]  = srslte_vec_f_malloc(coded_length);
+    data_b[i] = srslte_vec_u8_malloc(frame_length);
+    if (!llr_b[i] || !data_b[i]) {
+      perror("malloc");
+      exit(-1);
+    }
+  }
 
   float ebno_inc, esno_db;
   ebno_inc = (SNR_MAX - SNR_MIN) / SNR_POINTS;
@@ -209,6 +237,7 @@ int main(int argc, char** argv)
     errors_c   = 0;
     errors_f   = 0;
     errors_sse = 0;
+    errors_b   = 0;
     while (frame_cnt < nof_frames) {
 
       /* generate data_tx */
@@ -238,14 +267,35 @@ int main(int argc, char** argv)
       srslte_vec_quant_fuc(llr, llr_c, 32, INT8_MAX, UINT8_MAX, coded_length);
       srslte_vec_quant_fus(llr, llr_us, 8192, INT16_MAX, UINT16_MAX, coded_length);
 
-      VITERBI_TEST(srslte_viterbi_decode_s, dec, llr_s, errors_s);
-      VITERBI_TEST(srslte_viterbi_decode_us, dec, llr_us, errors_us);
-      VITERBI_TEST(srslte_viterbi_decode_uc, dec, llr_c, errors_c);
-      VITERBI_TEST(srslte_viterbi_decode_f, dec, llr, errors_f);
+      VITERBI_TEST(srslte_viterbi_decode_s, dec, llr_s, errors_s, time_other);
+      VITERBI_TEST(srslte_viterbi_decode_us, dec, llr_us, errors_us, time_other);
+      VITERBI_TEST(srslte_viterbi_decode_uc, dec, llr_c, errors_c, time_other);
+      VITERBI_TEST(srslte_viterbi_decode_f, dec, llr, errors_f, time_f);
 #ifdef TEST_SSE
-      VITERBI_TEST(srslte_viterbi_decode_uc, dec_sse, llr_c, errors_sse);
+      VITERBI_TEST(srslte_viterbi_decode_uc, dec_sse, llr_c, errors_sse, time_other);
 #endif
       frame_cnt++;
+
+      /* The batched decoder takes the frames in groups, the last one can be partially filled */
+      if (test_batch) {
+        srslte_vec_f_copy(llr_b[nof_b], llr, coded_length);
+        nof_b++;
+        if (nof_b == SRSLTE_VITERBI_BATCH_MAX || frame_cnt == nof_frames) {
+          struct timeval t[3] = {};
+          gettimeofday(&t[1], NULL);
+          if (srslte_viterbi_batch_decode_f(&dec_b, llr_b, data_b, nof_b, frame_length) < SRSLTE_SUCCESS) {
+            ERROR("Error decoding batch\n");
+            exit(-1);
+          }
+          gettimeofday(&t[2], NULL);
+          get_time_interval(t);
+          time_b += t[0].tv_sec * 1000000 + t[0].tv_usec;
+          for (uint32_t j = 0; j < nof_b; j++) {
+            errors_b += srslte_bit_diff(data_tx, data_b[j], frame_length);
+          }
+          nof_b = 0;
+        }
+      }
       printf("     Eb/No: %3.2f %10d/%d   ", SNR_MIN + i * ebno_inc, frame_cnt, nof_frames);
       if (errors_s >= 0)
         printf(" int16 BER: %.2e  ", (float)errors_s / (frame_cnt * frame_length));
@@ -258,6 +308,8 @@ int main(int argc, char** argv)
 #ifdef TEST_SSE
       printf("sse    BER: %.2e  ", (float)errors_sse / (frame_cnt * frame_length));
 #endif
+      if (test_batch)
+        printf("batch  BER: %.2e  ", (float)errors_b / (frame_cnt * frame_length));
       printf("\r\n");
     }
     printf("\n");
@@ -274,9 +326,29 @@ int main(int argc, char** argv)
 #ifdef TEST_SSE
       printf("sse    BER    :    %g\t%u errors\n", (float)errors_sse / (frame_cnt * frame_length), errors_sse);
 #endif
+      if (test_batch)
+        printf("batch  BER    :    %g\t%u errors\n", (float)errors_b / (frame_cnt * frame_length), errors_b);
+    }
+
+    /* Decoded bits per microsecond of the float decoder, one codeword at a time, and of the batched decoder */
+    printf("Throughput: float %.2f Mbps", time_f ? (float)frame_cnt * frame_length / time_f : 0.0f);
+    if (test_batch) {
+      printf(", batch %.2f Mbps (%s)",
+             time_b ? (float)frame_cnt * frame_length / time_b : 0.0f,
+             srslte_isa_to_string(srslte_isa_get()));
     }
+    printf("\n");
+    time_f = 0;
+    time_b = 0;
   }
   srslte_viterbi_free(&dec);
+  if (test_batch) {
+    srslte_viterbi_batch_free(&dec_b);
+  }
+  for (uint32_t i = 0; i < SRSLTE_VITERBI_BATCH_MAX; i++) {
+    free(llr_b[i]);
+    free(data_b[i]);
+  }
 #ifdef TEST_SSE
   srslte_viterbi_free(&dec_sse);
 #endif
@@ -295,14 +367,21 @@ int main(int argc, char** argv)
       ERROR("Test parameters not defined in test_results.h\n");
       exit(-1);
     } else {
-      printf(
-          "errors =(%d,%d,%d,%d,%d), expected =%d\n", errors_s, errors_us, errors_c, errors_f, errors_sse, expected_e);
+      printf("errors =(%d,%d,%d,%d,%d,%d), expected =%d\n",
+             errors_s,
+             errors_us,
+             errors_c,
+             errors_f,
+             errors_sse,
+             errors_b,
+             expected_e);
       bool passed = true;
       passed &= (bool)(errors_us <= expected_e);
       passed &= (bool)(errors_s <= expected_e);
       passed &= (bool)(errors_c <= expected_e);
       passed &= (bool)(errors_f <= expected_e);
       passed &= (bool)(errors_sse <= expected_e);
+      passed &= (bool)(errors_b <= expected_e);
       exit(!passed);
     }
   } else {
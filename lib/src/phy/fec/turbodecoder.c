@@ -25,6 +25,7 @@
 #include <strings.h>
 
 #include "srslte/phy/fec/turbodecoder.h"
+#include "srslte/phy/utils/isa.h"
 #include "srslte/phy/utils/vector.h"
 #include "srslte/srslte.h"
 
@@ -60,16 +61,11 @@ srslte_tdec_16bit_impl_t sse16_win_impl = {tdec_winsse16_init,
                                            tdec_winsse16_decision_byte};
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX16
-#include "srslte/phy/fec/turbodecoder_win.h"
-#undef WINIMP_IS_AVX16
-srslte_tdec_16bit_impl_t avx16_win_impl = {tdec_winavx16_init,
-                                           tdec_winavx16_free,
-                                           tdec_winavx16_dec,
-                                           tdec_winavx16_extract_input,
-                                           tdec_winavx16_decision_byte};
+/* AVX window implementation, see turbodecoder_avx2.c */
+#if defined(LV_HAVE_AVX2) || defined(SRSLTE_ISA_DISPATCH_AVX2)
+#define TDEC_HAVE_AVX2
+extern srslte_tdec_16bit_impl_t avx16_win_impl;
+extern srslte_tdec_8bit_impl_t  avx8_win_impl;
 #endif
 
 /* SSE window implementation */
@@ -85,18 +81,6 @@ srslte_tdec_8bit_impl_t sse8_win_impl = {tdec_winsse8_init,
                                          tdec_winsse8_decision_byte};
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX8
-#include "srslte/phy/fec/turbodecoder_win.h"
-#undef WINIMP_IS_AVX8
-srslte_tdec_8bit_impl_t avx8_win_impl = {tdec_winavx8_init,
-                                         tdec_winavx8_free,
-                                         tdec_winavx8_dec,
-                                         tdec_winavx8_extract_input,
-                                         tdec_winavx8_decision_byte};
-#endif
-
 #ifdef HAVE_NEON
 #define WINIMP_IS_NEON16
 #include "srslte/phy/fec/turbodecoder_win.h"
@@ -109,6 +93,16 @@ srslte_tdec_16bit_impl_t arm16_win_impl = {tdec_winarm16_init,
                                            tdec_winarm16_decision_byte};
 #endif
 
+// The AVX2 decoders are only used if they are built and the running CPU supports them
+static bool tdec_avx2_enabled()
+{
+#ifdef TDEC_HAVE_AVX2
+  return srslte_isa_get() >= SRSLTE_ISA_AVX2;
+#else  /* TDEC_HAVE_AVX2 */
+  return false;
+#endif /* TDEC_HAVE_AVX2 */
+}
+
 #define AUTO_16_SSE 0
 #define AUTO_16_SSEWIN 1
 #define AUTO_16_AVXWIN 2
@@ -185,16 +179,24 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
       h->current_llr_type = SRSLTE_TDEC_16;
       break;
 #endif /* HAVE_NEON */
-#ifdef LV_HAVE_AVX2
+#ifdef TDEC_HAVE_AVX2
     case SRSLTE_TDEC_AVX_WINDOW:
+      if (!tdec_avx2_enabled()) {
+        ERROR("Error decoder %d not supported by this CPU\n", dec_type);
+        goto clean_and_exit;
+      }
       h->dec16[0]         = &avx16_win_impl;
       h->current_llr_type = SRSLTE_TDEC_16;
       break;
     case SRSLTE_TDEC_AVX8_WINDOW:
+      if (!tdec_avx2_enabled()) {
+        ERROR("Error decoder %d not supported by this CPU\n", dec_type);
+        goto clean_and_exit;
+      }
       h->dec8[0]          = &avx8_win_impl;
       h->current_llr_type = SRSLTE_TDEC_8;
       break;
-#endif /* LV_HAVE_AVX2 */
+#endif /* TDEC_HAVE_AVX2 */
     default:
       ERROR("Error decoder %d not supported\n", dec_type);
       goto clean_and_exit;
@@ -251,10 +253,12 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
     h->dec16[AUTO_16_SSE]    = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &sse16_win_impl;
     h->dec8[AUTO_8_SSEWIN]   = &sse8_win_impl;
-#ifdef LV_HAVE_AVX2
-    h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
-    h->dec8[AUTO_8_AVXWIN]   = &avx8_win_impl;
-#endif /* LV_HAVE_AVX2 */
+#ifdef TDEC_HAVE_AVX2
+    if (tdec_avx2_enabled()) {
+      h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
+      h->dec8[AUTO_8_AVXWIN]   = &avx8_win_impl;
+    }
+#endif /* TDEC_HAVE_AVX2 */
 #else  /* HAVE_NEON | LV_HAVE_SSE */
     h->dec16[AUTO_16_SSE]    = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &gen_impl;
@@ -380,12 +384,9 @@ static void tdec_decision_byte(srslte_tdec_t* h, uint8_t* output)
 /* Returns number of subblocks in automatic mode for this long_cb */
 uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb % 16) && long_cb > 800) {
+  if (tdec_avx2_enabled() && !(long_cb % 16) && long_cb > 800) {
     return 16;
-  } else
-#endif
-      if (!(long_cb % 8) && long_cb > 400) {
+  } else if (!(long_cb % 8) && long_cb > 400) {
     return 8;
   } else {
     return 0;
@@ -409,12 +410,9 @@ static int tdec_sb_idx(uint32_t long_cb)
 
 uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb % 32) && long_cb > 2048) {
+  if (tdec_avx2_enabled() && !(long_cb % 32) && long_cb > 2048) {
     return 32;
-  } else
-#endif
-      if (!(long_cb % 16) && long_cb > 800) {
+  } else if (!(long_cb % 16) && long_cb > 800) {
     return 16;
   } else if (!(long_cb % 8) && long_cb > 400) {
     return 8;
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * AVX2 window implementations of the turbo decoder. They live in their own
+ * file so that, with the runtime ISA dispatch, only this file is built with
+ * the AVX2 instruction set.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "srslte/phy/fec/turbodecoder.h"
+#include "srslte/phy/utils/vector.h"
+#include "srslte/srslte.h"
+
+#ifdef LV_HAVE_AVX2
+#define WINIMP_IS_AVX16
+#include "srslte/phy/fec/turbodecoder_win.h"
+#undef WINIMP_IS_AVX16
+srslte_tdec_16bit_impl_t avx16_win_impl = {tdec_winavx16_init,
+                                           tdec_winavx16_free,
+                                           tdec_winavx16_dec,
+                                           tdec_winavx16_extract_input,
+                                           tdec_winavx16_decision_byte};
+
+#define WINIMP_IS_AVX8
+#include "srslte/phy/fec/turbodecoder_win.h"
+#undef WINIMP_IS_AVX8
+srslte_tdec_8bit_impl_t avx8_win_impl = {tdec_winavx8_init,
+                                         tdec_winavx8_free,
+                                         tdec_winavx8_dec,
+                                         tdec_winavx8_extract_input,
+                                         tdec_winavx8_decision_byte};
+#endif /* LV_HAVE_AVX2 */
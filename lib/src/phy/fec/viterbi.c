@@ -29,6 +29,7 @@
 #include "parity.h"
 #include "srslte/phy/fec/viterbi.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/isa.h"
 #include "srslte/phy/utils/vector.h"
 #include "viterbi37.h"
 
@@ -39,12 +40,20 @@
 #define DEFAULT_GAIN 100
 
 #define DEFAULT_GAIN_16 1000
-#define VITERBI_16
 
-#ifndef LV_HAVE_AVX2
-#undef VITERBI_16
+/* The AVX2 decoders are built with the AVX2 flags, either by the whole build or by the runtime ISA dispatch */
+#if defined(LV_HAVE_AVX2) || defined(SRSLTE_ISA_DISPATCH_AVX2)
+#define VITERBI_AVX2
 #endif
 
+#if defined(LV_HAVE_AVX512) || defined(SRSLTE_ISA_DISPATCH_AVX512)
+#define VITERBI_AVX512
+#endif
+
+/* Amplitude of the strongest symbol of each codeword in the batched decoder, it keeps the branch metrics within the
+ * range of the 16-bit path metrics */
+#define BATCH_GAIN 127
+
 //#undef LV_HAVE_SSE
 
 int decode37(void* o, uint8_t* symbols, uint8_t* data, uint32_t frame_length)
@@ -125,7 +134,7 @@ void free37_sse(void* o)
 
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef VITERBI_AVX2
 int decode37_avx2_16bit(void* o, uint16_t* symbols, uint8_t* data, uint32_t frame_length)
 {
   srslte_viterbi_t* q = o;
@@ -328,13 +337,6 @@ int init37_sse(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool tail_b
     perror("malloc");
     return -1;
   }
-#ifdef VITERBI_16
-  q->symbols_us = srslte_vec_u16_malloc(3 * (q->framebits + q->K - 1));
-  if (!q->symbols_us) {
-    perror("malloc");
-    return -1;
-  }
-#endif
   if (q->tail_biting) {
     q->tmp = srslte_vec_u8_malloc(TB_ITER * 3 * (q->framebits + q->K - 1));
     if (!q->tmp) {
@@ -394,7 +396,7 @@ int init37_neon(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool tail_
 }
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef VITERBI_AVX2
 int init37_avx2(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool tail_biting)
 {
   q->K            = 7;
@@ -491,16 +493,12 @@ int srslte_viterbi_init(srslte_viterbi_t*     q,
   switch (type) {
     case SRSLTE_VITERBI_37:
 #ifdef LV_HAVE_SSE
-
-#ifdef LV_HAVE_AVX2
-#ifdef VITERBI_16
-      return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
-#else
-      return init37_avx2(q, poly, max_frame_length, tail_bitting);
+#ifdef VITERBI_AVX2
+      if (srslte_isa_get() >= SRSLTE_ISA_AVX2) {
+        return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
+      }
 #endif
-#else
       return init37_sse(q, poly, max_frame_length, tail_bitting);
-#endif
 #else
 #ifdef HAVE_NEON
       return init37_neon(q, poly, max_frame_length, tail_bitting);
@@ -525,7 +523,7 @@ int srslte_viterbi_init_sse(srslte_viterbi_t*     q,
 }
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef VITERBI_AVX2
 int srslte_viterbi_init_avx2(srslte_viterbi_t*     q,
                              srslte_viterbi_type_t type,
                              int                   poly[3],
@@ -564,13 +562,13 @@ int srslte_viterbi_decode_f(srslte_viterbi_t* q, float* symbols, uint8_t* data,
         max = fabs(symbols[i]);
       }
     }
-#ifdef VITERBI_16
-    srslte_vec_quant_fus(symbols, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
-    return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
-    srslte_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant / max, 127.5, 255, len);
-    return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
+    if (q->decode_s) {
+      srslte_vec_quant_fus(symbols, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
+      return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+    } else {
+      srslte_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant / max, 127.5, 255, len);
+      return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
+    }
   } else {
     return q->decode_f(q, symbols, data, frame_length);
   }
@@ -596,13 +594,13 @@ int srslte_viterbi_decode_s(srslte_viterbi_t* q, int16_t* symbols, uint8_t* data
       max = abs(symbols[i]);
     }
   }
-#ifdef VITERBI_16
-  srslte_vec_quant_sus(symbols, q->symbols_us, 1, (float)INT16_MAX, UINT16_MAX, len);
-  return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
-  srslte_vec_quant_suc(symbols, q->symbols_uc, (float)q->gain_quant / max, 127, 255, len);
-  return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
+  if (q->decode_s) {
+    srslte_vec_quant_sus(symbols, q->symbols_us, 1, (float)INT16_MAX, UINT16_MAX, len);
+    return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+  } else {
+    srslte_vec_quant_suc(symbols, q->symbols_uc, (float)q->gain_quant / max, 127, 255, len);
+    return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
+  }
 }
 
 int srslte_viterbi_decode_us(srslte_viterbi_t* q, uint16_t* symbols, uint8_t* data, uint32_t frame_length)
@@ -626,3 +624,153 @@ int srslte_viterbi_decode_uc(srslte_viterbi_t* q, uint8_t* symbols, uint8_t* dat
 
   return ret;
 }
+
+int srslte_viterbi_batch_init(srslte_viterbi_batch_t* q,
+                              srslte_viterbi_type_t   type,
+                              int                     poly[3],
+                              uint32_t                max_frame_length,
+                              bool                    tail_biting)
+{
+  if (q == NULL || type != SRSLTE_VITERBI_37) {
+    ERROR("Decoder not implemented\n");
+    return SRSLTE_ERROR;
+  }
+
+  bzero(q, sizeof(srslte_viterbi_batch_t));
+  q->K           = 7;
+  q->framebits   = max_frame_length;
+  q->tail_biting = tail_biting;
+  q->gain_quant  = BATCH_GAIN;
+  q->update      = update_viterbi37_batch_blk_gen;
+#ifdef LV_HAVE_SSE
+  q->update = update_viterbi37_batch_blk_sse;
+#endif
+#ifdef VITERBI_AVX2
+  if (srslte_isa_get() >= SRSLTE_ISA_AVX2) {
+    q->update = update_viterbi37_batch_blk_avx2;
+  }
+#endif
+#ifdef VITERBI_AVX512
+  if (srslte_isa_get() >= SRSLTE_ISA_AVX512) {
+    q->update = update_viterbi37_batch_blk_avx512;
+  }
+#endif
+
+  q->symbols = srslte_vec_i16_malloc(3 * (max_frame_length + q->K - 1) * SRSLTE_VITERBI_BATCH_MAX);
+  q->tmp     = srslte_vec_i16_malloc(3 * (max_frame_length + q->K - 1));
+  if (!q->symbols || !q->tmp) {
+    perror("malloc");
+    srslte_viterbi_batch_free(q);
+    return SRSLTE_ERROR;
+  }
+
+  if ((q->ptr = create_viterbi37_batch(poly, TB_ITER * max_frame_length)) == NULL) {
+    ERROR("create_viterbi37_batch failed\n");
+    srslte_viterbi_batch_free(q);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_viterbi_batch_free(srslte_viterbi_batch_t* q)
+{
+  if (q) {
+    if (q->symbols) {
+      free(q->symbols);
+    }
+    if (q->tmp) {
+      free(q->tmp);
+    }
+    delete_viterbi37_batch(q->ptr);
+    bzero(q, sizeof(srslte_viterbi_batch_t));
+  }
+}
+
+int srslte_viterbi_batch_forward_f(srslte_viterbi_batch_t* q, float* symbols[], uint32_t nof_cw, uint32_t frame_length)
+{
+  if (q == NULL || symbols == NULL || nof_cw > SRSLTE_VITERBI_BATCH_MAX) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  if (frame_length > q->framebits) {
+    ERROR("Initialized decoder for max frame length %d bits\n", q->framebits);
+    return SRSLTE_ERROR;
+  }
+
+  uint32_t nof_bits = q->tail_biting ? frame_length : frame_length + q->K - 1;
+  uint32_t len      = 3 * nof_bits;
+  int32_t  sum_abs[SRSLTE_VITERBI_BATCH_MAX];
+
+  /* Quantize every codeword with its own gain and interleave them, symbol-major. Unused lanes decode zeros */
+  bzero(q->symbols, len * SRSLTE_VITERBI_BATCH_MAX * sizeof(int16_t));
+  for (uint32_t l = 0; l < nof_cw; l++) {
+    float max = fabsf(symbols[l][srslte_vec_max_abs_fi(symbols[l], len)]);
+    srslte_vec_convert_fi(symbols[l], q->gain_quant / SRSLTE_MAX(max, 1e-9f), q->tmp, len);
+    sum_abs[l] = 0;
+    for (uint32_t i = 0; i < len; i++) {
+      q->symbols[i * SRSLTE_VITERBI_BATCH_MAX + l] = q->tmp[i];
+      sum_abs[l] += abs(q->tmp[i]);
+    }
+  }
+
+  /* Tail-biting codewords are decoded over TB_ITER repetitions and the middle one is kept, as in the other decoders */
+  uint32_t nof_rep = q->tail_biting ? TB_ITER : 1;
+  init_viterbi37_batch(q->ptr, q->tail_biting ? -1 : 0);
+  for (uint32_t i = 0; i < nof_rep; i++) {
+    if (q->update(q->ptr, q->symbols, nof_bits)) {
+      return SRSLTE_ERROR;
+    }
+  }
+
+  int32_t best_metric[SRSLTE_VITERBI_BATCH_MAX];
+  best_viterbi37_batch(q->ptr, nof_cw, q->best_state, best_metric);
+  for (uint32_t l = 0; l < nof_cw; l++) {
+    q->reliability[l] = sum_abs[l] ? (float)best_metric[l] / (float)(nof_rep * sum_abs[l]) : 0.0f;
+  }
+  if (!q->tail_biting) {
+    /* The tail takes the encoder back to state 0 */
+    bzero(q->best_state, sizeof(q->best_state));
+  }
+
+  q->nof_cw       = nof_cw;
+  q->frame_length = frame_length;
+  return (int)nof_cw;
+}
+
+float srslte_viterbi_batch_reliability(srslte_viterbi_batch_t* q, uint32_t cw)
+{
+  if (q == NULL || cw >= q->nof_cw) {
+    return 0.0f;
+  }
+  return q->reliability[cw];
+}
+
+int srslte_viterbi_batch_chainback(srslte_viterbi_batch_t* q, uint32_t cw, uint8_t* data)
+{
+  if (q == NULL || data == NULL || cw >= q->nof_cw) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  uint32_t first = q->tail_biting ? (TB_ITER / 2) * q->frame_length : 0;
+  if (chainback_viterbi37_batch(q->ptr, cw, data, first, q->frame_length, q->best_state[cw])) {
+    return SRSLTE_ERROR;
+  }
+  return (int)q->frame_length;
+}
+
+int srslte_viterbi_batch_decode_f(srslte_viterbi_batch_t* q,
+                                  float*                  symbols[],
+                                  uint8_t*                data[],
+                                  uint32_t                nof_cw,
+                                  uint32_t                frame_length)
+{
+  if (data == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  int ret = srslte_viterbi_batch_forward_f(q, symbols, nof_cw, frame_length);
+  for (uint32_t l = 0; l < nof_cw && ret >= SRSLTE_SUCCESS; l++) {
+    if (srslte_viterbi_batch_chainback(q, l, data[l]) < SRSLTE_SUCCESS) {
+      ret = SRSLTE_ERROR;
+    }
+  }
+  return ret;
+}
@@ -82,4 +82,22 @@ void delete_viterbi37_avx2_16bit(void* p);
 
 int update_viterbi37_blk_avx2_16bit(void* p, uint16_t* syms, uint32_t nbits, uint32_t* best_state);
 
+void* create_viterbi37_batch(int polys[3], uint32_t len);
+
+int init_viterbi37_batch(void* p, int starting_state);
+
+int chainback_viterbi37_batch(void* p, uint32_t cw, uint8_t* data, uint32_t first, uint32_t nbits, uint32_t endstate);
+
+void delete_viterbi37_batch(void* p);
+
+void best_viterbi37_batch(void* p, uint32_t nof_cw, uint32_t* best_state, int32_t* best_metric);
+
+int update_viterbi37_batch_blk_gen(void* p, const int16_t* syms, uint32_t nbits);
+
+int update_viterbi37_batch_blk_sse(void* p, const int16_t* syms, uint32_t nbits);
+
+int update_viterbi37_batch_blk_avx2(void* p, const int16_t* syms, uint32_t nbits);
+
+int update_viterbi37_batch_blk_avx512(void* p, const int16_t* syms, uint32_t nbits);
+
 #endif /* SRSLTE_VITERBI37_H_ */
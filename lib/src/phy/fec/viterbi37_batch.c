@@ -0,0 +1,175 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "parity.h"
+#include "viterbi37.h"
+#include "viterbi37_batch.h"
+
+void* create_viterbi37_batch(int polys[3], uint32_t len)
+{
+  void*             p;
+  struct v37_batch* vp;
+
+  if (posix_memalign(&p, 64, sizeof(struct v37_batch))) {
+    return NULL;
+  }
+  vp = (struct v37_batch*)p;
+  bzero(vp, sizeof(struct v37_batch));
+
+  if (posix_memalign(&p, 64, (len + 6) * VITERBI37_BATCH_NOF_STATES * sizeof(uint32_t))) {
+    free(vp);
+    return NULL;
+  }
+  vp->decisions = (uint32_t*)p;
+  vp->len       = len + 6;
+
+  for (int state = 0; state < VITERBI37_BATCH_NOF_STATES / 2; state++) {
+    uint32_t b = 0;
+    for (int k = 0; k < 3; k++) {
+      b |= ((polys[k] < 0) ^ parity((2 * state) & polys[k])) << k;
+    }
+    vp->branch[state] = (uint8_t)b;
+  }
+
+  return vp;
+}
+
+void delete_viterbi37_batch(void* p)
+{
+  struct v37_batch* vp = p;
+
+  if (vp != NULL) {
+    free(vp->decisions);
+    free(vp);
+  }
+}
+
+int init_viterbi37_batch(void* p, int starting_state)
+{
+  struct v37_batch* vp = p;
+
+  if (vp == NULL) {
+    return -1;
+  }
+
+  for (int s = 0; s < VITERBI37_BATCH_NOF_STATES; s++) {
+    int16_t m = (starting_state == -1 || s == (starting_state & 63)) ? 0 : VITERBI37_BATCH_MINF;
+    for (int l = 0; l < SRSLTE_VITERBI_BATCH_MAX; l++) {
+      vp->metrics[0][s][l] = m;
+    }
+  }
+  bzero(vp->offset, sizeof(vp->offset));
+  vp->nof_bits = 0;
+  vp->cur      = 0;
+  return 0;
+}
+
+/* Portable version of the trellis, the lane loops are left to the compiler */
+int update_viterbi37_batch_blk_gen(void* p, const int16_t* syms, uint32_t nbits)
+{
+  struct v37_batch* vp = p;
+  int16_t           bm[8][SRSLTE_VITERBI_BATCH_MAX];
+
+  if (vp == NULL || vp->nof_bits + nbits > vp->len) {
+    return -1;
+  }
+
+  while (nbits--) {
+    int16_t(*old)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur];
+    int16_t(*new)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur ^ 1];
+    uint32_t* d                             = &vp->decisions[vp->nof_bits * VITERBI37_BATCH_NOF_STATES];
+
+    viterbi37_batch_branch_metrics(syms, syms + SRSLTE_VITERBI_BATCH_MAX, syms + 2 * SRSLTE_VITERBI_BATCH_MAX, bm);
+    syms += 3 * SRSLTE_VITERBI_BATCH_MAX;
+
+    for (int j = 0; j < VITERBI37_BATCH_NOF_STATES / 2; j++) {
+      const int16_t* b  = bm[vp->branch[j]];
+      uint32_t       d0 = 0;
+      uint32_t       d1 = 0;
+      for (int l = 0; l < SRSLTE_VITERBI_BATCH_MAX; l++) {
+        int16_t m0 = old[j][l] + b[l];
+        int16_t m1 = old[j + 32][l] - b[l];
+        int16_t m2 = old[j][l] - b[l];
+        int16_t m3 = old[j + 32][l] + b[l];
+
+        new[2 * j][l]     = (m1 > m0) ? m1 : m0;
+        new[2 * j + 1][l] = (m3 > m2) ? m3 : m2;
+        d0 |= (uint32_t)(m1 > m0) << l;
+        d1 |= (uint32_t)(m3 > m2) << l;
+      }
+      d[2 * j]     = d0;
+      d[2 * j + 1] = d1;
+    }
+
+    vp->cur ^= 1;
+    vp->nof_bits++;
+    if (vp->nof_bits % VITERBI37_BATCH_NORM_PERIOD == 0) {
+      viterbi37_batch_normalize(vp, new);
+    }
+  }
+  return 0;
+}
+
+void best_viterbi37_batch(void* p, uint32_t nof_cw, uint32_t* best_state, int32_t* best_metric)
+{
+  struct v37_batch* vp = p;
+
+  int16_t(*m)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur];
+  for (uint32_t l = 0; l < nof_cw; l++) {
+    uint32_t bst = 0;
+    for (uint32_t s = 1; s < VITERBI37_BATCH_NOF_STATES; s++) {
+      if (m[s][l] >= m[bst][l]) {
+        bst = s;
+      }
+    }
+    if (best_state) {
+      best_state[l] = bst;
+    }
+    if (best_metric) {
+      best_metric[l] = vp->offset[l] + m[bst][l];
+    }
+  }
+}
+
+/* Walks back from the last decoded bit and writes the bits [first, first + nbits) of the survivor of codeword cw */
+int chainback_viterbi37_batch(void* p, uint32_t cw, uint8_t* data, uint32_t first, uint32_t nbits, uint32_t endstate)
+{
+  struct v37_batch* vp = p;
+
+  if (vp == NULL || first + nbits > vp->nof_bits || cw >= SRSLTE_VITERBI_BATCH_MAX) {
+    return -1;
+  }
+
+  /* The state after every bit holds the last 6 input bits, the newest one in the LSB */
+  uint32_t state = endstate % 64;
+  for (uint32_t i = vp->nof_bits; i-- > first;) {
+    if (i < first + nbits) {
+      data[i - first] = (uint8_t)(state & 1);
+    }
+    uint32_t k = (vp->decisions[i * VITERBI37_BATCH_NOF_STATES + state] >> cw) & 1;
+    state      = (state >> 1) | (k << 5);
+  }
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Batched r=1/3 K=7 Viterbi decoder. The trellis of up to SRSLTE_VITERBI_BATCH_MAX codewords of the same length is
+ * run at once with one 16-bit lane per codeword, so every butterfly is a handful of vertical SIMD operations and no
+ * shuffles are needed. Path metrics are correlations (larger is better) and are renormalized against state 0 every
+ * VITERBI37_BATCH_NORM_PERIOD bits; the subtracted amount is kept per codeword so that the absolute metric of the
+ * survivor can be used as a reliability measure before the traceback.
+ */
+
+#ifndef SRSLTE_VITERBI37_BATCH_H_
+#define SRSLTE_VITERBI37_BATCH_H_
+
+#include "srslte/phy/fec/viterbi.h"
+#include <stdint.h>
+
+#define VITERBI37_BATCH_NOF_STATES 64
+#define VITERBI37_BATCH_NORM_PERIOD 8
+
+/* Metric of the states that can not be the starting state of a non tail-biting codeword */
+#define VITERBI37_BATCH_MINF (-4096)
+
+struct v37_batch {
+  int16_t   metrics[2][VITERBI37_BATCH_NOF_STATES][SRSLTE_VITERBI_BATCH_MAX]; /* old and new path metrics */
+  int32_t   offset[SRSLTE_VITERBI_BATCH_MAX];                                /* subtracted from each codeword */
+  uint8_t   branch[VITERBI37_BATCH_NOF_STATES / 2];                          /* encoder output of each butterfly */
+  uint32_t* decisions;                                                       /* lane bitmask per bit and state */
+  uint32_t  len;                                                             /* maximum number of bits */
+  uint32_t  nof_bits;                                                        /* bits since the last init */
+  uint32_t  cur;                                                             /* index of the old path metrics */
+};
+
+/* Branch metrics of the 8 encoder outputs for 3 symbols of every lane, larger is better */
+static inline void viterbi37_batch_branch_metrics(const int16_t* y0,
+                                                  const int16_t* y1,
+                                                  const int16_t* y2,
+                                                  int16_t        bm[8][SRSLTE_VITERBI_BATCH_MAX])
+{
+  for (uint32_t p = 0; p < 8; p++) {
+    for (uint32_t l = 0; l < SRSLTE_VITERBI_BATCH_MAX; l++) {
+      bm[p][l] = (int16_t)(((p & 1) ? y0[l] : -y0[l]) + ((p & 2) ? y1[l] : -y1[l]) + ((p & 4) ? y2[l] : -y2[l]));
+    }
+  }
+}
+
+/* Subtracts the metric of state 0 from every state and accumulates it in the codeword offset */
+static inline void viterbi37_batch_normalize(struct v37_batch* vp, int16_t m[][SRSLTE_VITERBI_BATCH_MAX])
+{
+  int16_t ref[SRSLTE_VITERBI_BATCH_MAX];
+  for (uint32_t l = 0; l < SRSLTE_VITERBI_BATCH_MAX; l++) {
+    ref[l] = m[0][l];
+    vp->offset[l] += ref[l];
+  }
+  for (uint32_t s = 0; s < VITERBI37_BATCH_NOF_STATES; s++) {
+    for (uint32_t l = 0; l < SRSLTE_VITERBI_BATCH_MAX; l++) {
+      m[s][l] -= ref[l];
+    }
+  }
+}
+
+#endif /* SRSLTE_VITERBI37_BATCH_H_ */
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * AVX-512 trellis of the batched decoder, see viterbi37_batch.h. The 32 codewords of a state fill one register and
+ * the compare mask of every butterfly is directly the decision word of the state.
+ */
+
+#include <stdint.h>
+
+#include "viterbi37.h"
+#include "viterbi37_batch.h"
+
+#ifdef LV_HAVE_AVX512
+#include <immintrin.h>
+
+int update_viterbi37_batch_blk_avx512(void* p, const int16_t* syms, uint32_t nbits)
+{
+  struct v37_batch* vp = p;
+  __m512i           bm[8];
+
+  if (vp == NULL || vp->nof_bits + nbits > vp->len) {
+    return -1;
+  }
+
+  while (nbits--) {
+    int16_t(*old)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur];
+    int16_t(*new)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur ^ 1];
+    uint32_t* d                             = &vp->decisions[vp->nof_bits * VITERBI37_BATCH_NOF_STATES];
+
+    __m512i y0 = _mm512_loadu_si512(syms);
+    __m512i y1 = _mm512_loadu_si512(syms + SRSLTE_VITERBI_BATCH_MAX);
+    __m512i y2 = _mm512_loadu_si512(syms + 2 * SRSLTE_VITERBI_BATCH_MAX);
+    syms += 3 * SRSLTE_VITERBI_BATCH_MAX;
+
+    /* The metric of an encoder output is the negated metric of its complement */
+    __m512i s01 = _mm512_add_epi16(y0, y1);
+    __m512i d01 = _mm512_sub_epi16(y0, y1);
+    bm[7]       = _mm512_add_epi16(s01, y2);
+    bm[3]       = _mm512_sub_epi16(s01, y2);
+    bm[5]       = _mm512_add_epi16(d01, y2);
+    bm[1]       = _mm512_sub_epi16(d01, y2);
+    bm[0]       = _mm512_sub_epi16(_mm512_setzero_si512(), bm[7]);
+    bm[4]       = _mm512_sub_epi16(_mm512_setzero_si512(), bm[3]);
+    bm[2]       = _mm512_sub_epi16(_mm512_setzero_si512(), bm[5]);
+    bm[6]       = _mm512_sub_epi16(_mm512_setzero_si512(), bm[1]);
+
+    for (int j = 0; j < VITERBI37_BATCH_NOF_STATES / 2; j++) {
+      __m512i b  = bm[vp->branch[j]];
+      __m512i a0 = _mm512_load_si512(old[j]);
+      __m512i a1 = _mm512_load_si512(old[j + 32]);
+
+      __m512i m0 = _mm512_add_epi16(a0, b);
+      __m512i m1 = _mm512_sub_epi16(a1, b);
+      __m512i m2 = _mm512_sub_epi16(a0, b);
+      __m512i m3 = _mm512_add_epi16(a1, b);
+
+      d[2 * j]     = (uint32_t)_mm512_cmpgt_epi16_mask(m1, m0);
+      d[2 * j + 1] = (uint32_t)_mm512_cmpgt_epi16_mask(m3, m2);
+      _mm512_store_si512(new[2 * j], _mm512_max_epi16(m0, m1));
+      _mm512_store_si512(new[2 * j + 1], _mm512_max_epi16(m2, m3));
+    }
+
+    vp->cur ^= 1;
+    vp->nof_bits++;
+    if (vp->nof_bits % VITERBI37_BATCH_NORM_PERIOD == 0) {
+      viterbi37_batch_normalize(vp, new);
+    }
+  }
+  return 0;
+}
+
+#endif /* LV_HAVE_AVX512 */
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * SSE trellis of the batched decoder, see viterbi37_batch.h. The 32 codewords of a state take 4 registers and the
+ * decisions are packed to bytes before extracting their sign.
+ */
+
+#include <stdint.h>
+
+#include "viterbi37.h"
+#include "viterbi37_batch.h"
+
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+
+#define NOF_REGS (SRSLTE_VITERBI_BATCH_MAX / 8)
+
+int update_viterbi37_batch_blk_sse(void* p, const int16_t* syms, uint32_t nbits)
+{
+  struct v37_batch* vp = p;
+  __m128i           bm[8][NOF_REGS];
+
+  if (vp == NULL || vp->nof_bits + nbits > vp->len) {
+    return -1;
+  }
+
+  while (nbits--) {
+    int16_t(*old)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur];
+    int16_t(*new)[SRSLTE_VITERBI_BATCH_MAX] = vp->metrics[vp->cur ^ 1];
+    uint32_t* d                             = &vp->decisions[vp->nof_bits * VITERBI37_BATCH_NOF_STATES];
+
+    /* The metric of an encoder output is the negated metric of its complement */
+    for (int r = 0; r < NOF_REGS; r++) {
+      __m128i y0  = _mm_loadu_si128((__m128i*)&syms[8 * r]);
+      __m128i y1  = _mm_loadu_si128((__m128i*)&syms[SRSLTE_VITERBI_BATCH_MAX + 8 * r]);
+      __m128i y2  = _mm_loadu_si128((__m128i*)&syms[2 * SRSLTE_VITERBI_BATCH_MAX + 8 * r]);
+      __m128i s01 = _mm_add_epi16(y0, y1);
+      __m128i d01 = _mm_sub_epi16(y0, y1);
+      bm[7][r]    = _mm_add_epi16(s01, y2);
+      bm[3][r]    = _mm_sub_epi16(s01, y2);
+      bm[5][r]    = _mm_add_epi16(d01, y2);
+      bm[1][r]    = _mm_sub_epi16(d01, y2);
+      bm[0][r]    = _mm_sub_epi16(_mm_setzero_si128(), bm[7][r]);
+      bm[4][r]    = _mm_sub_epi16(_mm_setzero_si128(), bm[3][r]);
+      bm[2][r]    = _mm_sub_epi16(_mm_setzero_si128(), bm[5][r]);
+      bm[6][r]    = _mm_sub_epi16(_mm_setzero_si128(), bm[1][r]);
+    }
+    syms += 3 * SRSLTE_VITERBI_BATCH_MAX;
+
+    for (int j = 0; j < VITERBI37_BATCH_NOF_STATES / 2; j++) {
+      __m128i* b = bm[vp->branch[j]];
+      __m128i  c0[NOF_REGS], c1[NOF_REGS];
+
+      for (int r = 0; r < NOF_REGS; r++) {
+        __m128i a0 = _mm_load_si128((__m128i*)&old[j][8 * r]);
+        __m128i a1 = _mm_load_si128((__m128i*)&old[j + 32][8 * r]);
+
+        __m128i m0 = _mm_add_epi16(a0, b[r]);
+        __m128i m1 = _mm_sub_epi16(a1, b[r]);
+        __m128i m2 = _mm_sub_epi16(a0, b[r]);
+        __m128i m3 = _mm_add_epi16(a1, b[r]);
+
+        c0[r] = _mm_cmpgt_epi16(m1, m0);
+        c1[r] = _mm_cmpgt_epi16(m3, m2);
+        _mm_store_si128((__m128i*)&new[2 * j][8 * r], _mm_max_epi16(m0, m1));
+        _mm_store_si128((__m128i*)&new[2 * j + 1][8 * r], _mm_max_epi16(m2, m3));
+      }
+
+      d[2 * j] = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(c0[0], c0[1])) |
+                 ((uint32_t)_mm_movemask_epi8(_mm_packs_epi16(c0[2], c0[3])) << 16);
+      d[2 * j + 1] = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(c1[0], c1[1])) |
+                     ((uint32_t)_mm_movemask_epi8(_mm_packs_epi16(c1[2], c1[3])) << 16);
+    }
+
+    vp->cur ^= 1;
+    vp->nof_bits++;
+    if (vp->nof_bits % VITERBI37_BATCH_NORM_PERIOD == 0) {
+      viterbi37_batch_normalize(vp, new);
+    }
+  }
+  return 0;
+}
+
+#endif /* LV_HAVE_SSE */
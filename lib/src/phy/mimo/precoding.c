@@ -62,6 +62,58 @@ int srslte_predecoding_single_avx(cf_t* y[SRSLTE_MAX_PORTS],
 
 static srslte_mimo_decoder_t mimo_decoder = SRSLTE_MIMO_DECODER_MMSE;
 
+/* 36.211 v10.3.0 Table 6.3.4.2.3-2, generating vectors u_n of the four antenna port codebook */
+static const float codebook_4tx_u[16][4][2] = {
+    {{1, 0}, {-1, 0}, {-1, 0}, {-1, 0}},
+    {{1, 0}, {0, -1}, {1, 0}, {0, 1}},
+    {{1, 0}, {1, 0}, {-1, 0}, {1, 0}},
+    {{1, 0}, {0, 1}, {1, 0}, {0, -1}},
+    {{1, 0}, {-M_SQRT1_2, -M_SQRT1_2}, {0, -1}, {M_SQRT1_2, -M_SQRT1_2}},
+    {{1, 0}, {M_SQRT1_2, -M_SQRT1_2}, {0, 1}, {-M_SQRT1_2, -M_SQRT1_2}},
+    {{1, 0}, {M_SQRT1_2, M_SQRT1_2}, {0, -1}, {-M_SQRT1_2, M_SQRT1_2}},
+    {{1, 0}, {-M_SQRT1_2, M_SQRT1_2}, {0, 1}, {M_SQRT1_2, M_SQRT1_2}},
+    {{1, 0}, {-1, 0}, {1, 0}, {1, 0}},
+    {{1, 0}, {0, -1}, {-1, 0}, {0, -1}},
+    {{1, 0}, {1, 0}, {1, 0}, {-1, 0}},
+    {{1, 0}, {0, 1}, {-1, 0}, {0, 1}},
+    {{1, 0}, {-1, 0}, {-1, 0}, {1, 0}},
+    {{1, 0}, {-1, 0}, {1, 0}, {-1, 0}},
+    {{1, 0}, {1, 0}, {-1, 0}, {-1, 0}},
+    {{1, 0}, {1, 0}, {1, 0}, {1, 0}},
+};
+
+/* Columns of W_n taken by the layers 2, 3 and 4 of the same table, the first layer always takes the first column */
+static const uint8_t codebook_4tx_columns[16][3][4] = {
+    {{0, 3}, {0, 1, 3}, {0, 1, 2, 3}}, {{0, 1}, {0, 1, 2}, {0, 1, 2, 3}}, {{0, 1}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0, 1}, {0, 1, 2}, {2, 1, 0, 3}}, {{0, 3}, {0, 1, 3}, {0, 1, 2, 3}}, {{0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0, 2}, {0, 2, 3}, {0, 2, 1, 3}}, {{0, 2}, {0, 2, 3}, {0, 2, 1, 3}}, {{0, 1}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0, 3}, {0, 2, 3}, {0, 1, 2, 3}}, {{0, 2}, {0, 1, 2}, {0, 2, 1, 3}}, {{0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0, 1}, {0, 1, 2}, {0, 1, 2, 3}}, {{0, 2}, {0, 1, 2}, {0, 2, 1, 3}}, {{0, 2}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+};
+
+/* Precoding matrix W[port][layer] of the four antenna port codebook, including the 1/sqrt(nof_layers) scaling.
+ * W_n = I - 2 * u_n * u_n' / (u_n' * u_n), where u_n' * u_n = 4 for every u_n */
+static int srslte_precoding_codebook_4tx(int codebook_idx, int nof_layers, cf_t W[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS])
+{
+  if (codebook_idx < 0 || codebook_idx > 15 || nof_layers < 1 || nof_layers > 4) {
+    ERROR("Invalid multiplex combination: codebook_idx=%d, nof_layers=%d, nof_ports=4\n", codebook_idx, nof_layers);
+    return SRSLTE_ERROR;
+  }
+
+  const float(*u)[2] = codebook_4tx_u[codebook_idx];
+  float norm          = 1.0f / sqrtf((float)nof_layers);
+  for (uint32_t l = 0; l < nof_layers; l++) {
+    uint32_t c = (nof_layers == 1) ? 0 : codebook_4tx_columns[codebook_idx][nof_layers - 2][l];
+    for (uint32_t p = 0; p < SRSLTE_MAX_PORTS; p++) {
+      cf_t up = u[p][0] + _Complex_I * u[p][1];
+      cf_t uc = u[c][0] + _Complex_I * u[c][1];
+      W[p][l] = ((p == c ? 1.0f : 0.0f) - 0.5f * up * conjf(uc)) * norm;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 /************************************************
  *
  * RECEIVER SIDE FUNCTIONS
@@ -1821,6 +1873,141 @@ static int srslte_predecoding_multiplex_2x1_mrc_csi(cf_t*  y[SRSLTE_MAX_PORTS],
   return SRSLTE_SUCCESS;
 }
 
+/* Stores the CSI of the layers of one resource element in the codeword symbol order of the layer mapping */
+static inline void
+srslte_predecoding_multiplex_4tx_csi(float* csi[SRSLTE_MAX_CODEWORDS], int nof_layers, int i, const float* c)
+{
+  switch (nof_layers) {
+    case 1:
+      csi[0][i] = c[0];
+      break;
+    case 2:
+      csi[0][i] = c[0];
+      if (csi[1]) {
+        csi[1][i] = c[1];
+      }
+      break;
+    case 3:
+      csi[0][i] = c[0];
+      if (csi[1]) {
+        csi[1][2 * i]     = c[1];
+        csi[1][2 * i + 1] = c[2];
+      }
+      break;
+    default:
+      csi[0][2 * i]     = c[0];
+      csi[0][2 * i + 1] = c[1];
+      if (csi[1]) {
+        csi[1][2 * i]     = c[2];
+        csi[1][2 * i + 1] = c[3];
+      }
+      break;
+  }
+}
+
+/* Four antenna port spatial multiplexing. The channel of every resource element is combined with the precoding
+ * matrix into the effective channel of the layers, which is equalized by the NxL solver. ZF is MMSE without noise. */
+static int srslte_predecoding_multiplex_4tx(cf_t*  y[SRSLTE_MAX_PORTS],
+                                            cf_t*  h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                            cf_t*  x[SRSLTE_MAX_LAYERS],
+                                            float* csi[SRSLTE_MAX_CODEWORDS],
+                                            int    nof_rxant,
+                                            int    nof_layers,
+                                            int    codebook_idx,
+                                            int    nof_symbols,
+                                            float  scaling,
+                                            float  noise_estimate)
+{
+  cf_t W[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+  int  i = 0;
+
+  if (nof_layers > nof_rxant) {
+    ERROR("Error predecoding multiplex: %d layers can not be decoded with %d rx antennas\n", nof_layers, nof_rxant);
+    return SRSLTE_ERROR;
+  }
+  if (srslte_precoding_codebook_4tx(codebook_idx, nof_layers, W) != SRSLTE_SUCCESS) {
+    return SRSLTE_ERROR;
+  }
+
+  float norm    = 1.0f / scaling;
+  float n0      = (mimo_decoder == SRSLTE_MIMO_DECODER_MMSE) ? noise_estimate : 0.0f;
+  bool  has_csi = (csi && csi[0]);
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+  simd_cf_t w[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+  for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      w[p][l] = srslte_simd_cf_set1(W[p][l]);
+    }
+  }
+
+  for (; i < nof_symbols - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _y[SRSLTE_MAT_NxL_MAX], _h[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX], _x[SRSLTE_MAT_NxL_MAX];
+    simd_f_t  _csi[SRSLTE_MAT_NxL_MAX];
+
+    /* Effective channel H x W */
+    for (int r = 0; r < nof_rxant; r++) {
+      simd_cf_t hp[SRSLTE_MAX_PORTS];
+      for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+        hp[p] = srslte_simd_cfi_load(&h[p][r][i]);
+      }
+      for (int l = 0; l < nof_layers; l++) {
+        _h[r][l] = srslte_simd_cf_prod(hp[0], w[0][l]);
+        for (int p = 1; p < SRSLTE_MAX_PORTS; p++) {
+          _h[r][l] = srslte_simd_cf_add(_h[r][l], srslte_simd_cf_prod(hp[p], w[p][l]));
+        }
+      }
+      _y[r] = srslte_simd_cfi_load(&y[r][i]);
+    }
+
+    srslte_mat_NxL_mmse_csi_simd(nof_rxant, nof_layers, _y, _h, _x, _csi, n0, norm);
+
+    for (int l = 0; l < nof_layers; l++) {
+      srslte_simd_cfi_store(&x[l][i], _x[l]);
+    }
+
+    if (has_csi) {
+      float c[SRSLTE_SIMD_CF_SIZE][SRSLTE_MAT_NxL_MAX];
+      for (int l = 0; l < nof_layers; l++) {
+        float srslte_simd_aligned c_l[SRSLTE_SIMD_CF_SIZE];
+        srslte_simd_f_store(c_l, srslte_simd_f_cfi_to_split(_csi[l]));
+        for (int k = 0; k < SRSLTE_SIMD_CF_SIZE; k++) {
+          c[k][l] = c_l[k];
+        }
+      }
+      for (int k = 0; k < SRSLTE_SIMD_CF_SIZE; k++) {
+        srslte_predecoding_multiplex_4tx_csi(csi, nof_layers, i + k, c[k]);
+      }
+    }
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    cf_t  _y[SRSLTE_MAT_NxL_MAX], _h[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX], _x[SRSLTE_MAT_NxL_MAX];
+    float _csi[SRSLTE_MAT_NxL_MAX];
+
+    for (int r = 0; r < nof_rxant; r++) {
+      for (int l = 0; l < nof_layers; l++) {
+        _h[r][l] = 0;
+        for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+          _h[r][l] += h[p][r][i] * W[p][l];
+        }
+      }
+      _y[r] = y[r][i];
+    }
+
+    srslte_mat_NxL_mmse_csi_gen(nof_rxant, nof_layers, _y, _h, _x, _csi, n0, norm);
+
+    for (int l = 0; l < nof_layers; l++) {
+      x[l][i] = _x[l];
+    }
+    if (has_csi) {
+      srslte_predecoding_multiplex_4tx_csi(csi, nof_layers, i, _csi);
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 static int srslte_predecoding_multiplex(cf_t*  y[SRSLTE_MAX_PORTS],
                                         cf_t*  h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                                         cf_t*  x[SRSLTE_MAX_LAYERS],
@@ -1859,8 +2046,9 @@ static int srslte_predecoding_multiplex(cf_t*  y[SRSLTE_MAX_PORTS],
         return srslte_predecoding_multiplex_2x1_mrc(y, h, x, codebook_idx, nof_symbols, scaling);
       }
     }
-  } else if (nof_ports == 4) {
-    ERROR("Error predecoding multiplex: not implemented for %d Tx ports", nof_ports);
+  } else if (nof_ports == 4 && nof_rxant <= 4) {
+    return srslte_predecoding_multiplex_4tx(
+        y, h, x, csi, nof_rxant, nof_layers, codebook_idx, nof_symbols, scaling, noise_estimate);
   } else {
     ERROR("Error predecoding multiplex: Invalid combination of ports %d and rx antennas %d\n", nof_ports, nof_rxant);
   }
@@ -2007,7 +2195,8 @@ int srslte_precoding_diversity(cf_t* x[SRSLTE_MAX_LAYERS],
 int srslte_precoding_cdd_2x2_avx(cf_t* x[SRSLTE_MAX_LAYERS], cf_t* y[SRSLTE_MAX_PORTS], int nof_symbols, float scaling)
 {
   __m256 norm_avx = _mm256_set1_ps(0.5f * scaling);
-  for (int i = 0; i < nof_symbols - 3; i += 4) {
+  int    i        = 0;
+  for (; i < nof_symbols - 3; i += 4) {
     __m256 x0 = _mm256_load_ps((float*)&x[0][i]);
     __m256 x1 = _mm256_load_ps((float*)&x[1][i]);
 
@@ -2022,6 +2211,14 @@ int srslte_precoding_cdd_2x2_avx(cf_t* x[SRSLTE_MAX_LAYERS], cf_t* y[SRSLTE_MAX_
     _mm256_store_ps((float*)&y[1][i], y1);
   }
 
+  // Remaining pair of symbols when nof_symbols is not a multiple of 4
+  for (; i < nof_symbols - 1; i += 2) {
+    y[0][i]     = (x[0][i] + x[1][i]) * 0.5f * scaling;
+    y[1][i]     = (x[0][i] - x[1][i]) * 0.5f * scaling;
+    y[0][i + 1] = (x[0][i + 1] + x[1][i + 1]) * 0.5f * scaling;
+    y[1][i + 1] = (-x[0][i + 1] + x[1][i + 1]) * 0.5f * scaling;
+  }
+
   return 2 * nof_symbols;
 }
 
@@ -2095,6 +2292,61 @@ int srslte_precoding_cdd(cf_t* x[SRSLTE_MAX_LAYERS],
   }
 }
 
+/* Four antenna port spatial multiplexing, y = W x */
+static int srslte_precoding_multiplex_4tx(cf_t*    x[SRSLTE_MAX_LAYERS],
+                                          cf_t*    y[SRSLTE_MAX_PORTS],
+                                          int      nof_layers,
+                                          int      codebook_idx,
+                                          uint32_t nof_symbols,
+                                          float    scaling)
+{
+  cf_t     W[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+  uint32_t i = 0;
+
+  if (srslte_precoding_codebook_4tx(codebook_idx, nof_layers, W) != SRSLTE_SUCCESS) {
+    return SRSLTE_ERROR;
+  }
+  for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      W[p][l] *= scaling;
+    }
+  }
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+  simd_cf_t w[SRSLTE_MAX_PORTS][SRSLTE_MAX_LAYERS];
+  for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      w[p][l] = srslte_simd_cf_set1(W[p][l]);
+    }
+  }
+
+  for (; i + SRSLTE_SIMD_CF_SIZE < nof_symbols + 1; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _x[SRSLTE_MAX_LAYERS];
+    for (int l = 0; l < nof_layers; l++) {
+      _x[l] = srslte_simd_cfi_load(&x[l][i]);
+    }
+    for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+      simd_cf_t _y = srslte_simd_cf_prod(w[p][0], _x[0]);
+      for (int l = 1; l < nof_layers; l++) {
+        _y = srslte_simd_cf_add(_y, srslte_simd_cf_prod(w[p][l], _x[l]));
+      }
+      srslte_simd_cfi_store(&y[p][i], _y);
+    }
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
+      cf_t acc = 0;
+      for (int l = 0; l < nof_layers; l++) {
+        acc += W[p][l] * x[l][i];
+      }
+      y[p][i] = acc;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_precoding_multiplex(cf_t*    x[SRSLTE_MAX_LAYERS],
                                cf_t*    y[SRSLTE_MAX_PORTS],
                                int      nof_layers,
@@ -2215,6 +2467,8 @@ int srslte_precoding_multiplex(cf_t*    x[SRSLTE_MAX_LAYERS],
     } else {
       ERROR("Not implemented");
     }
+  } else if (nof_ports == 4) {
+    return srslte_precoding_multiplex_4tx(x, y, nof_layers, codebook_idx, nof_symbols, scaling);
   } else {
     ERROR("Not implemented");
   }
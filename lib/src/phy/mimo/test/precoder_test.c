@@ -41,6 +41,7 @@ char*                  mimo_type_name        = NULL;
 char                   decoder_type_name[17] = "zf";
 float                  snr_db                = 100.0f;
 float                  scaling               = 0.1f;
+int                    nof_repetitions       = 0;
 static srslte_random_t random_gen            = NULL;
 
 void usage(char* prog)
@@ -57,6 +58,7 @@ void usage(char* prog)
   printf("\t-s SNR in dB [Default %.1fdB]*\n", snr_db);
   printf("\t-g Scaling [Default %.1f]*\n", scaling);
   printf("\t-d decoder type [zf|mmse] [Default %s]\n", decoder_type_name);
+  printf("\t-t predecoding repetitions of the throughput test [Default %d]\n", nof_repetitions);
   printf("\n");
   printf("* Performance test example:\n\t for snr in {0..20..1}; do ./precoding_test -m single -s $snr; done; \n\n");
 }
@@ -64,7 +66,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "mplnrcdsg")) != -1) {
+  while ((opt = getopt(argc, argv, "mplnrcdsgt")) != -1) {
     switch (opt) {
       case 'n':
         nof_symbols = (int)strtol(argv[optind], NULL, 10);
@@ -94,6 +96,9 @@ void parse_args(int argc, char** argv)
       case 'g':
         scaling = strtof(argv[optind], NULL);
         break;
+      case 't':
+        nof_repetitions = (int)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -176,6 +181,7 @@ int main(int argc, char** argv)
   float mse;
   cf_t *x[SRSLTE_MAX_LAYERS], *r[SRSLTE_MAX_PORTS], *y[SRSLTE_MAX_PORTS], *h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
       *xr[SRSLTE_MAX_LAYERS];
+  float* csi[SRSLTE_MAX_CODEWORDS] = {};
   srslte_tx_scheme_t type;
 
   parse_args(argc, argv);
@@ -339,6 +345,77 @@ int main(int argc, char** argv)
     ret = SRSLTE_ERROR;
   }
 
+  /* Four port spatial multiplexing gives the same symbols with CSI, which must be positive for every codeword symbol */
+  if (type == SRSLTE_TXSCHEME_SPATIALMUX && nof_tx_ports == 4) {
+    uint32_t nof_cw_symbols[SRSLTE_MAX_CODEWORDS] = {};
+    for (i = 0; i < nof_layers; i++) {
+      nof_cw_symbols[(nof_layers == 1 || i < nof_layers / 2) ? 0 : 1] += nof_symbols;
+    }
+    for (i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+      csi[i] = srslte_vec_f_malloc(2 * nof_re);
+      if (!csi[i]) {
+        perror("srslte_vec_malloc");
+        exit(-1);
+      }
+    }
+    srslte_predecoding_type(r,
+                            h,
+                            xr,
+                            csi,
+                            nof_rx_ports,
+                            nof_tx_ports,
+                            nof_layers,
+                            codebook_idx,
+                            nof_re,
+                            type,
+                            scaling,
+                            srslte_convert_dB_to_power(-snr_db));
+    mse = 0;
+    for (i = 0; i < nof_layers; i++) {
+      for (j = 0; j < nof_symbols; j++) {
+        mse += cabsf(xr[i][j] - x[i][j]);
+      }
+    }
+    if (mse / nof_layers / nof_symbols > MSE_THRESHOLD) {
+      printf("MSE with CSI: %.6f\n", mse / nof_layers / nof_symbols);
+      ret = SRSLTE_ERROR;
+    }
+    for (i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+      for (j = 0; j < nof_cw_symbols[i]; j++) {
+        if (!isnormal(csi[i][j]) || csi[i][j] < 0.0f) {
+          printf("Invalid CSI %f for codeword %d symbol %d\n", csi[i][j], i, j);
+          ret = SRSLTE_ERROR;
+          break;
+        }
+      }
+    }
+  }
+
+  /* Throughput test, the same resource elements are equalized several times */
+  if (nof_repetitions > 0) {
+    gettimeofday(&t[1], NULL);
+    for (int n = 0; n < nof_repetitions; n++) {
+      srslte_predecoding_type(r,
+                              h,
+                              xr,
+                              csi,
+                              nof_rx_ports,
+                              nof_tx_ports,
+                              nof_layers,
+                              codebook_idx,
+                              nof_re,
+                              type,
+                              scaling,
+                              srslte_convert_dB_to_power(-snr_db));
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    double elapsed_us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+    printf("Throughput: %.1f MRE/s; %.1f Mbps (QPSK)\n",
+           (double)nof_re * nof_repetitions / elapsed_us,
+           2.0 * nof_layers * nof_symbols * nof_repetitions / elapsed_us);
+  }
+
 quit:
   srslte_random_free(random_gen);
 
@@ -364,5 +441,11 @@ quit:
     }
   }
 
+  for (i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+    if (csi[i]) {
+      free(csi[i]);
+    }
+  }
+
   exit(ret);
 }
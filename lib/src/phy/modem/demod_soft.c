@@ -23,9 +23,11 @@
 #include <stdlib.h>
 #include <strings.h>
 
+#include "demod_soft_simd.h"
 #include "srslte/phy/modem/demod_soft.h"
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/isa.h"
 #include "srslte/phy/utils/vector.h"
 
 #ifdef HAVE_NEONv8
@@ -108,6 +110,41 @@ void demod_16qam_lte_s_sse(const cf_t* symbols, short* llr, int nsymbols);
 #define SCALE_BYTE_CONV_QAM64 40
 #define SCALE_BYTE_CONV_QAM256 50
 
+// Runs the widest QAM demapper the CPU supports, returns false if there is none wider than SSE
+static bool demod_qam_lte_s_wide(const cf_t* symbols, short* llr, int nsymbols, uint32_t nof_levels, float scale)
+{
+#ifdef DEMOD_SOFT_HAVE_AVX512
+  if (srslte_isa_get() >= SRSLTE_ISA_AVX512) {
+    demod_qam_lte_s_avx512(symbols, llr, nsymbols, nof_levels, scale);
+    return true;
+  }
+#endif /* DEMOD_SOFT_HAVE_AVX512 */
+#ifdef DEMOD_SOFT_HAVE_AVX2
+  if (srslte_isa_get() >= SRSLTE_ISA_AVX2) {
+    demod_qam_lte_s_avx2(symbols, llr, nsymbols, nof_levels, scale);
+    return true;
+  }
+#endif /* DEMOD_SOFT_HAVE_AVX2 */
+  return false;
+}
+
+static bool demod_qam_lte_b_wide(const cf_t* symbols, int8_t* llr, int nsymbols, uint32_t nof_levels, float scale)
+{
+#ifdef DEMOD_SOFT_HAVE_AVX512
+  if (srslte_isa_get() >= SRSLTE_ISA_AVX512) {
+    demod_qam_lte_b_avx512(symbols, llr, nsymbols, nof_levels, scale);
+    return true;
+  }
+#endif /* DEMOD_SOFT_HAVE_AVX512 */
+#ifdef DEMOD_SOFT_HAVE_AVX2
+  if (srslte_isa_get() >= SRSLTE_ISA_AVX2) {
+    demod_qam_lte_b_avx2(symbols, llr, nsymbols, nof_levels, scale);
+    return true;
+  }
+#endif /* DEMOD_SOFT_HAVE_AVX2 */
+  return false;
+}
+
 void demod_bpsk_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
   for (int i = 0; i < nsymbols; i++) {
@@ -385,6 +422,10 @@ void demod_16qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 void demod_16qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
+  if (demod_qam_lte_s_wide(symbols, llr, nsymbols, 2, SCALE_SHORT_CONV_QAM16)) {
+    return;
+  }
+
 #ifdef LV_HAVE_SSE
   demod_16qam_lte_s_sse(symbols, llr, nsymbols);
 #else
@@ -406,6 +447,10 @@ void demod_16qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 
 void demod_16qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
+  if (demod_qam_lte_b_wide(symbols, llr, nsymbols, 2, SCALE_BYTE_CONV_QAM16)) {
+    return;
+  }
+
 #ifdef LV_HAVE_SSE
   demod_16qam_lte_b_sse(symbols, llr, nsymbols);
 #else
@@ -758,6 +803,10 @@ void demod_64qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 void demod_64qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
+  if (demod_qam_lte_s_wide(symbols, llr, nsymbols, 3, SCALE_SHORT_CONV_QAM64)) {
+    return;
+  }
+
 #ifdef LV_HAVE_SSE
   demod_64qam_lte_s_sse(symbols, llr, nsymbols);
 #else
@@ -781,6 +830,10 @@ void demod_64qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 
 void demod_64qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
+  if (demod_qam_lte_b_wide(symbols, llr, nsymbols, 3, SCALE_BYTE_CONV_QAM64)) {
+    return;
+  }
+
 #ifdef LV_HAVE_SSE
   demod_64qam_lte_b_sse(symbols, llr, nsymbols);
 #else
@@ -826,6 +879,10 @@ void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
 
 void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
+  if (demod_qam_lte_b_wide(symbols, llr, nsymbols, 4, SCALE_BYTE_CONV_QAM256)) {
+    return;
+  }
+
   for (int i = 0; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
     float imag = -__imag__ symbols[i];
@@ -848,6 +905,10 @@ void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
 {
+  if (demod_qam_lte_s_wide(symbols, llr, nsymbols, 4, SCALE_SHORT_CONV_QAM256)) {
+    return;
+  }
+
   for (int i = 0; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
     float imag = -__imag__ symbols[i];
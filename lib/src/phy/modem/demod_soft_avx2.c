@@ -0,0 +1,200 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * AVX2 max-log QAM demappers, see demod_soft_simd.h. The symbols are converted to int16 (re, im) pairs and every
+ * level is computed for 8 symbols at once. The levels are then interleaved in the LLR order with unpacks (16QAM and
+ * 256QAM) or with a rotation and blends (64QAM). The int8 demappers compute the levels in int16 and saturate them
+ * at the end.
+ */
+
+#include <string.h>
+
+#include "demod_soft_simd.h"
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+#define DEMOD_AVX2_NSYMB 8
+#define DEMOD_MAX_LEVELS 4
+
+typedef struct {
+  __m256  scale;
+  __m256i threshold[DEMOD_MAX_LEVELS];
+} demod_avx2_t;
+
+static void demod_avx2_init(demod_avx2_t* q, uint32_t nof_levels, float scale)
+{
+  q->scale = _mm256_set1_ps(-scale);
+  for (uint32_t k = 1; k < nof_levels; k++) {
+    q->threshold[k] = _mm256_set1_epi16((int16_t)lrintf(scale * demod_soft_qam_threshold(nof_levels, k)));
+  }
+}
+
+// Interleaves the levels of 8 symbols in the LLR order, every 32-bit word is the (re, im) pair of one level
+static inline __attribute__((always_inline)) void
+demod_avx2_interleave(const __m256i* level, const uint32_t nof_levels, __m256i* out)
+{
+  if (nof_levels == 2) {
+    __m256i lo = _mm256_unpacklo_epi32(level[0], level[1]); // Symbols 0, 1, 4 and 5
+    __m256i hi = _mm256_unpackhi_epi32(level[0], level[1]); // Symbols 2, 3, 6 and 7
+    out[0]     = _mm256_permute2x128_si256(lo, hi, 0x20);
+    out[1]     = _mm256_permute2x128_si256(lo, hi, 0x31);
+  } else if (nof_levels == 3) {
+    // Each level is rotated so that every output takes its words at fixed positions: 0, 3, 6 / 1, 4, 7 / 2, 5
+    __m256i t0 = _mm256_permutevar8x32_epi32(level[0], _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+    __m256i t1 = _mm256_permutevar8x32_epi32(level[1], _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+    __m256i t2 = _mm256_permutevar8x32_epi32(level[2], _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+    out[0]     = _mm256_blend_epi32(_mm256_blend_epi32(t0, t1, 0x92), t2, 0x24);
+    out[1]     = _mm256_blend_epi32(_mm256_blend_epi32(t0, t1, 0x24), t2, 0x49);
+    out[2]     = _mm256_blend_epi32(_mm256_blend_epi32(t0, t1, 0x49), t2, 0x92);
+  } else {
+    // 4x4 transpose of the words in every 128-bit lane
+    __m256i t0 = _mm256_unpacklo_epi32(level[0], level[1]);
+    __m256i t1 = _mm256_unpacklo_epi32(level[2], level[3]);
+    __m256i t2 = _mm256_unpackhi_epi32(level[0], level[1]);
+    __m256i t3 = _mm256_unpackhi_epi32(level[2], level[3]);
+    __m256i s0 = _mm256_unpacklo_epi64(t0, t1); // Symbols 0 and 4
+    __m256i s1 = _mm256_unpackhi_epi64(t0, t1); // Symbols 1 and 5
+    __m256i s2 = _mm256_unpacklo_epi64(t2, t3); // Symbols 2 and 6
+    __m256i s3 = _mm256_unpackhi_epi64(t2, t3); // Symbols 3 and 7
+    out[0]     = _mm256_permute2x128_si256(s0, s1, 0x20);
+    out[1]     = _mm256_permute2x128_si256(s2, s3, 0x20);
+    out[2]     = _mm256_permute2x128_si256(s0, s1, 0x31);
+    out[3]     = _mm256_permute2x128_si256(s2, s3, 0x31);
+  }
+}
+
+// Demodulates 8 symbols into nof_levels vectors of int16 LLR
+static inline __attribute__((always_inline)) void
+demod_avx2_run(const demod_avx2_t* q, const float* ptr, const uint32_t nof_levels, __m256i* out)
+{
+  __m256i level[DEMOD_MAX_LEVELS];
+  __m256i a = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(ptr), q->scale));
+  __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(ptr + 8), q->scale));
+
+  // The pack works on each 128-bit lane, put the symbols back in order
+  level[0] = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+  for (uint32_t k = 1; k < nof_levels; k++) {
+    level[k] = _mm256_subs_epi16(_mm256_abs_epi16(level[k - 1]), q->threshold[k]);
+  }
+
+  demod_avx2_interleave(level, nof_levels, out);
+}
+
+static inline __attribute__((always_inline)) void
+demod_qam_s_avx2(const cf_t* symbols, int16_t* llr, int nsymbols, const uint32_t nof_levels, float scale)
+{
+  demod_avx2_t q;
+  __m256i      out[DEMOD_MAX_LEVELS];
+  demod_avx2_init(&q, nof_levels, scale);
+
+  int i = 0;
+  for (; i + DEMOD_AVX2_NSYMB <= nsymbols; i += DEMOD_AVX2_NSYMB) {
+    demod_avx2_run(&q, (const float*)&symbols[i], nof_levels, out);
+    for (uint32_t j = 0; j < nof_levels; j++) {
+      _mm256_storeu_si256((__m256i*)&llr[2 * nof_levels * i + 16 * j], out[j]);
+    }
+  }
+
+  // The last symbols are demodulated from a zero padded copy
+  if (i < nsymbols) {
+    cf_t    tail_symbols[DEMOD_AVX2_NSYMB] = {};
+    int16_t tail_llr[DEMOD_AVX2_NSYMB * 2 * DEMOD_MAX_LEVELS];
+    memcpy(tail_symbols, &symbols[i], sizeof(cf_t) * (nsymbols - i));
+    demod_avx2_run(&q, (const float*)tail_symbols, nof_levels, out);
+    for (uint32_t j = 0; j < nof_levels; j++) {
+      _mm256_storeu_si256((__m256i*)&tail_llr[16 * j], out[j]);
+    }
+    memcpy(&llr[2 * nof_levels * i], tail_llr, sizeof(int16_t) * 2 * nof_levels * (nsymbols - i));
+  }
+}
+
+static inline __attribute__((always_inline)) void
+demod_qam_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols, const uint32_t nof_levels, float scale)
+{
+  demod_avx2_t q;
+  __m256i      out[2 * DEMOD_MAX_LEVELS];
+  demod_avx2_init(&q, nof_levels, scale);
+
+  // Two blocks of 8 symbols are packed into nof_levels vectors of int8 LLR
+  int i = 0;
+  for (; i < nsymbols; i += 2 * DEMOD_AVX2_NSYMB) {
+    const float* ptr = (const float*)&symbols[i];
+    int8_t*      dst = &llr[2 * nof_levels * i];
+
+    // The last symbols are demodulated from a zero padded copy
+    cf_t   tail_symbols[2 * DEMOD_AVX2_NSYMB] = {};
+    int8_t tail_llr[2 * DEMOD_AVX2_NSYMB * 2 * DEMOD_MAX_LEVELS];
+    if (i + 2 * DEMOD_AVX2_NSYMB > nsymbols) {
+      memcpy(tail_symbols, &symbols[i], sizeof(cf_t) * (nsymbols - i));
+      ptr = (const float*)tail_symbols;
+      dst = tail_llr;
+    }
+
+    demod_avx2_run(&q, ptr, nof_levels, out);
+    demod_avx2_run(&q, ptr + 2 * DEMOD_AVX2_NSYMB, nof_levels, &out[nof_levels]);
+    for (uint32_t j = 0; j < nof_levels; j++) {
+      __m256i v = _mm256_packs_epi16(out[2 * j], out[2 * j + 1]);
+      _mm256_storeu_si256((__m256i*)&dst[32 * j], _mm256_permute4x64_epi64(v, 0xd8));
+    }
+
+    if (dst == tail_llr) {
+      memcpy(&llr[2 * nof_levels * i], tail_llr, 2 * nof_levels * (nsymbols - i));
+    }
+  }
+}
+
+void demod_qam_lte_s_avx2(const cf_t* symbols, int16_t* llr, int nsymbols, uint32_t nof_levels, float scale)
+{
+  switch (nof_levels) {
+    case 2:
+      demod_qam_s_avx2(symbols, llr, nsymbols, 2, scale);
+      break;
+    case 3:
+      demod_qam_s_avx2(symbols, llr, nsymbols, 3, scale);
+      break;
+    case 4:
+      demod_qam_s_avx2(symbols, llr, nsymbols, 4, scale);
+      break;
+    default:
+      break;
+  }
+}
+
+void demod_qam_lte_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols, uint32_t nof_levels, float scale)
+{
+  switch (nof_levels) {
+    case 2:
+      demod_qam_b_avx2(symbols, llr, nsymbols, 2, scale);
+      break;
+    case 3:
+      demod_qam_b_avx2(symbols, llr, nsymbols, 3, scale);
+      break;
+    case 4:
+      demod_qam_b_avx2(symbols, llr, nsymbols, 4, scale);
+      break;
+    default:
+      break;
+  }
+}
+
+#endif /* LV_HAVE_AVX2 */
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * AVX-512 max-log QAM demappers, see demod_soft_simd.h and demod_soft_avx512.c. Every level is computed for 16
+ * symbols at once and the levels are interleaved with two-source permutes (16QAM and 256QAM) or with a rotation and
+ * masked moves (64QAM).
+ */
+
+#include <string.h>
+#include <strings.h>
+
+#include "demod_soft_simd.h"
+
+#ifdef LV_HAVE_AVX512
+#include <immintrin.h>
+
+#define DEMOD_AVX512_NSYMB 16
+#define DEMOD_MAX_LEVELS 4
+
+typedef struct {
+  __m512    scale;
+  __m512i   lane_order;
+  __m512i   threshold[DEMOD_MAX_LEVELS];
+  __m512i   pair_idx[2];
+  __m512i   quad_idx[2];
+  __m512i   rot_idx[3];
+  __mmask16 rot_mask[3][3];
+} demod_avx512_t;
+
+static void demod_avx512_init(demod_avx512_t* q, uint32_t nof_levels, float scale)
+{
+  q->scale      = _mm512_set1_ps(-scale);
+  q->lane_order = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+  for (uint32_t k = 1; k < nof_levels; k++) {
+    q->threshold[k] = _mm512_set1_epi16((int16_t)lrintf(scale * demod_soft_qam_threshold(nof_levels, k)));
+  }
+
+  int32_t pair_idx[2][DEMOD_AVX512_NSYMB];
+  int64_t quad_idx[2][DEMOD_AVX512_NSYMB / 2];
+  int32_t rot_idx[3][DEMOD_AVX512_NSYMB];
+  bzero(q->rot_mask, sizeof(q->rot_mask));
+  for (uint32_t w = 0; w < DEMOD_AVX512_NSYMB; w++) {
+    for (uint32_t h = 0; h < 2; h++) {
+      // Two levels of the symbols 8h to 8h + 7
+      pair_idx[h][w] = (8 * h + w / 2) | ((w % 2) << 4);
+      // 64-bit pairs of levels 0-1 and 2-3 of the symbols 4h to 4h + 3
+      if (w < DEMOD_AVX512_NSYMB / 2) {
+        quad_idx[h][w] = (4 * h + w / 2) | ((w % 2) << 3);
+      }
+    }
+    // 64QAM: the word w of the output j is the level (16j + w) % 3 of the symbol (16j + w) / 3
+    for (uint32_t j = 0; j < 3; j++) {
+      uint32_t n            = DEMOD_AVX512_NSYMB * j + w;
+      rot_idx[n % 3][w]     = n / 3;
+      q->rot_mask[j][n % 3] = (__mmask16)(q->rot_mask[j][n % 3] | (1U << w));
+    }
+  }
+  for (uint32_t i = 0; i < 2; i++) {
+    q->pair_idx[i] = _mm512_loadu_si512(pair_idx[i]);
+    q->quad_idx[i] = _mm512_loadu_si512(quad_idx[i]);
+  }
+  for (uint32_t k = 0; k < 3; k++) {
+    q->rot_idx[k] = _mm512_loadu_si512(rot_idx[k]);
+  }
+}
+
+// Interleaves the levels of 16 symbols in the LLR order, every 32-bit word is the (re, im) pair of one level
+static inline __attribute__((always_inline)) void
+demod_avx512_interleave(const demod_avx512_t* q, const __m512i* level, const uint32_t nof_levels, __m512i* out)
+{
+  if (nof_levels == 2) {
+    out[0] = _mm512_permutex2var_epi32(level[0], q->pair_idx[0], level[1]);
+    out[1] = _mm512_permutex2var_epi32(level[0], q->pair_idx[1], level[1]);
+  } else if (nof_levels == 3) {
+    __m512i t0 = _mm512_permutexvar_epi32(q->rot_idx[0], level[0]);
+    __m512i t1 = _mm512_permutexvar_epi32(q->rot_idx[1], level[1]);
+    __m512i t2 = _mm512_permutexvar_epi32(q->rot_idx[2], level[2]);
+    for (uint32_t j = 0; j < 3; j++) {
+      out[j] = _mm512_mask_mov_epi32(_mm512_mask_mov_epi32(t0, q->rot_mask[j][1], t1), q->rot_mask[j][2], t2);
+    }
+  } else {
+    for (uint32_t h = 0; h < 2; h++) {
+      __m512i p01    = _mm512_permutex2var_epi32(level[0], q->pair_idx[h], level[1]);
+      __m512i p23    = _mm512_permutex2var_epi32(level[2], q->pair_idx[h], level[3]);
+      out[2 * h]     = _mm512_permutex2var_epi64(p01, q->quad_idx[0], p23);
+      out[2 * h + 1] = _mm512_permutex2var_epi64(p01, q->quad_idx[1], p23);
+    }
+  }
+}
+
+// Demodulates 16 symbols into nof_levels vectors of int16 LLR
+static inline __attribute__((always_inline)) void
+demod_avx512_run(const demod_avx512_t* q, const float* ptr, const uint32_t nof_levels, __m512i* out)
+{
+  __m512i level[DEMOD_MAX_LEVELS];
+  __m512i a = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(ptr), q->scale));
+  __m512i b = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(ptr + 16), q->scale));
+
+  // The pack works on each 128-bit lane, put the symbols back in order
+  level[0] = _mm512_permutexvar_epi64(q->lane_order, _mm512_packs_epi32(a, b));
+  for (uint32_t k = 1; k < nof_levels; k++) {
+    level[k] = _mm512_subs_epi16(_mm512_abs_epi16(level[k - 1]), q->threshold[k]);
+  }
+
+  demod_avx512_interleave(q, level, nof_levels, out);
+}
+
+static inline __attribute__((always_inline)) void
+demod_qam_s_avx512(const cf_t* symbols, int16_t* llr, int nsymbols, const uint32_t nof_levels, float scale)
+{
+  demod_avx512_t q;
+  __m512i      out[DEMOD_MAX_LEVELS];
+  demod_avx512_init(&q, nof_levels, scale);
+
+  int i = 0;
+  for (; i + DEMOD_AVX512_NSYMB <= nsymbols; i += DEMOD_AVX512_NSYMB) {
+    demod_avx512_run(&q, (const float*)&symbols[i], nof_levels, out);
+    for (uint32_t j = 0; j < nof_levels; j++) {
+      _mm512_storeu_si512(&llr[2 * nof_levels * i + 32 * j], out[j]);
+    }
+  }
+
+  // The last symbols are demodulated from a zero padded copy
+  if (i < nsymbols) {
+    cf_t    tail_symbols[DEMOD_AVX512_NSYMB] = {};
+    int16_t tail_llr[DEMOD_AVX512_NSYMB * 2 * DEMOD_MAX_LEVELS];
+    memcpy(tail_symbols, &symbols[i], sizeof(cf_t) * (nsymbols - i));
+    demod_avx512_run(&q, (const float*)tail_symbols, nof_levels, out);
+    for (uint32_t j = 0; j < nof_levels; j++) {
+      _mm512_storeu_si512(&tail_llr[32 * j], out[j]);
+    }
+    memcpy(&llr[2 * nof_levels * i], tail_llr, sizeof(int16_t) * 2 * nof_levels * (nsymbols - i));
+  }
+}
+
+static inline __attribute__((always_inline)) void
+demod_qam_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols, const uint32_t nof_levels, float scale)
+{
+  demod_avx512_t q;
+  __m512i      out[2 * DEMOD_MAX_LEVELS];
+  demod_avx512_init(&q, nof_levels, scale);
+
+  // Two blocks of 16 symbols are packed into nof_levels vectors of int8 LLR
+  int i = 0;
+  for (; i < nsymbols; i += 2 * DEMOD_AVX512_NSYMB) {
+    const float* ptr = (const float*)&symbols[i];
+    int8_t*      dst = &llr[2 * nof_levels * i];
+
+    // The last symbols are demodulated from a zero padded copy
+    cf_t   tail_symbols[2 * DEMOD_AVX512_NSYMB] = {};
+    int8_t tail_llr[2 * DEMOD_AVX512_NSYMB * 2 * DEMOD_MAX_LEVELS];
+    if (i + 2 * DEMOD_AVX512_NSYMB > nsymbols) {
+      memcpy(tail_symbols, &symbols[i], sizeof(cf_t) * (nsymbols - i));
+      ptr = (const float*)tail_symbols;
+      dst = tail_llr;
+    }
+
+    demod_avx512_run(&q, ptr, nof_levels, out);
+    demod_avx512_run(&q, ptr + 2 * DEMOD_AVX512_NSYMB, nof_levels, &out[nof_levels]);
+    for (uint32_t j = 0; j < nof_levels; j++) {
+      __m512i v = _mm512_packs_epi16(out[2 * j], out[2 * j + 1]);
+      _mm512_storeu_si512(&dst[64 * j], _mm512_permutexvar_epi64(q.lane_order, v));
+    }
+
+    if (dst == tail_llr) {
+      memcpy(&llr[2 * nof_levels * i], tail_llr, 2 * nof_levels * (nsymbols - i));
+    }
+  }
+}
+
+void demod_qam_lte_s_avx512(const cf_t* symbols, int16_t* llr, int nsymbols, uint32_t nof_levels, float scale)
+{
+  switch (nof_levels) {
+    case 2:
+      demod_qam_s_avx512(symbols, llr, nsymbols, 2, scale);
+      break;
+    case 3:
+      demod_qam_s_avx512(symbols, llr, nsymbols, 3, scale);
+      break;
+    case 4:
+      demod_qam_s_avx512(symbols, llr, nsymbols, 4, scale);
+      break;
+    default:
+      break;
+  }
+}
+
+void demod_qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols, uint32_t nof_levels, float scale)
+{
+  switch (nof_levels) {
+    case 2:
+      demod_qam_b_avx512(symbols, llr, nsymbols, 2, scale);
+      break;
+    case 3:
+      demod_qam_b_avx512(symbols, llr, nsymbols, 3, scale);
+      break;
+    case 4:
+      demod_qam_b_avx512(symbols, llr, nsymbols, 4, scale);
+      break;
+    default:
+      break;
+  }
+}
+
+#endif /* LV_HAVE_AVX512 */
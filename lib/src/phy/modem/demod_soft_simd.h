@@ -0,0 +1,58 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_DEMOD_SOFT_SIMD_H
+#define SRSLTE_DEMOD_SOFT_SIMD_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+/*
+ * Wide SIMD max-log demappers for 16QAM (2 levels), 64QAM (3 levels) and 256QAM (4 levels). Every level of the
+ * LTE Gray mapping gives one LLR of the real and one of the imaginary part:
+ *
+ *   llr_0 = -scale * y,  llr_k = |llr_{k-1}| - scale * 2^(L - k) / sqrt(2 * (4^L - 1) / 3)
+ *
+ * They are built in their own files, so that with the runtime ISA dispatch they are the only ones built with the
+ * wider instruction set. They are only called if the running CPU supports it.
+ */
+
+/* Threshold of the level k (1 <= k < nof_levels) of the unscaled constellation */
+static inline float demod_soft_qam_threshold(uint32_t nof_levels, uint32_t k)
+{
+  return (float)(1U << (nof_levels - k)) / sqrtf(2.0f * ((1U << (2 * nof_levels)) - 1) / 3.0f);
+}
+
+#if defined(LV_HAVE_AVX2) || defined(SRSLTE_ISA_DISPATCH_AVX2)
+#define DEMOD_SOFT_HAVE_AVX2
+void demod_qam_lte_s_avx2(const cf_t* symbols, int16_t* llr, int nsymbols, uint32_t nof_levels, float scale);
+void demod_qam_lte_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols, uint32_t nof_levels, float scale);
+#endif /* defined(LV_HAVE_AVX2) || defined(SRSLTE_ISA_DISPATCH_AVX2) */
+
+#if defined(LV_HAVE_AVX512) || defined(SRSLTE_ISA_DISPATCH_AVX512)
+#define DEMOD_SOFT_HAVE_AVX512
+void demod_qam_lte_s_avx512(const cf_t* symbols, int16_t* llr, int nsymbols, uint32_t nof_levels, float scale);
+void demod_qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols, uint32_t nof_levels, float scale);
+#endif /* defined(LV_HAVE_AVX512) || defined(SRSLTE_ISA_DISPATCH_AVX512) */
+
+#endif // SRSLTE_DEMOD_SOFT_SIMD_H
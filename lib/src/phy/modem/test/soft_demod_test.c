@@ -36,7 +36,7 @@ static srslte_mod_t modulation = SRSLTE_MOD_NITEMS;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64)\n", prog);
+  printf("Usage: %s [nfv] -m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256)\n", prog);
   printf("\t-n num_bits [Default %d]\n", num_bits);
   printf("\t-f nof_frames [Default %d]\n", nof_frames);
   printf("\t-v srslte_verbose [Default None]\n");
@@ -91,6 +91,43 @@ void parse_args(int argc, char** argv)
   }
 }
 
+/* Fixed-point scales of the int16 and int8 soft demodulators */
+float llr_scale(bool is_byte)
+{
+  switch (modulation) {
+    case SRSLTE_MOD_BPSK:
+    case SRSLTE_MOD_QPSK:
+      return is_byte ? 20 : 100;
+    case SRSLTE_MOD_16QAM:
+      return is_byte ? 30 : 400;
+    case SRSLTE_MOD_64QAM:
+      return is_byte ? 40 : 700;
+    case SRSLTE_MOD_256QAM:
+      return is_byte ? 50 : 1000;
+    default:
+      return 0.0f;
+  }
+}
+
+// Every level of the QAM demappers adds up to one unit of rounding error
+int check_llr_fixed(const float* llr, const short* llr_s, const int8_t* llr_b, uint32_t nbits, uint32_t nbits_x_symbol)
+{
+  int max_error = nbits_x_symbol / 2 + 1;
+  for (uint32_t i = 0; i < nbits; i++) {
+    float ref_s = SRSLTE_MAX(SRSLTE_MIN(llr_scale(false) * llr[i], INT16_MAX), INT16_MIN);
+    float ref_b = SRSLTE_MAX(SRSLTE_MIN(llr_scale(true) * llr[i], INT8_MAX), INT8_MIN);
+    if (fabsf(llr_s[i] - ref_s) > max_error) {
+      printf("Error in int16 LLR %d: %d, expected %.1f\n", i, llr_s[i], ref_s);
+      return SRSLTE_ERROR;
+    }
+    if (fabsf(llr_b[i] - ref_b) > max_error) {
+      printf("Error in int8 LLR %d: %d, expected %.1f\n", i, llr_b[i], ref_b);
+      return SRSLTE_ERROR;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 float mse_threshold()
 {
   switch (modulation) {
@@ -129,6 +166,7 @@ int main(int argc, char** argv)
 
   /* check that num_bits is multiple of num_bits x symbol */
   num_bits = mod.nbits_x_symbol * (num_bits / mod.nbits_x_symbol);
+  uint32_t nsymbols = num_bits / mod.nbits_x_symbol;
 
   /* allocate buffers */
   input = srslte_vec_u8_malloc(num_bits);
@@ -233,6 +271,11 @@ int main(int argc, char** argv)
         goto clean_exit;
       }
     }
+
+    // The fixed-point LLR must match the float reference
+    if (check_llr_fixed(llr, llr_s, llr_b, num_bits, mod.nbits_x_symbol) != SRSLTE_SUCCESS) {
+      goto clean_exit;
+    }
   }
   ret = 0;
 
@@ -253,5 +296,10 @@ clean_exit:
          mean_texec,
          mean_texec_s,
          mean_texec_b);
+  printf("Mean Throughput (%s): %.1f/%.1f/%.1f Msymbols/s\n",
+         srslte_isa_to_string(srslte_isa_get()),
+         nsymbols / mean_texec,
+         nsymbols / mean_texec_s,
+         nsymbols / mean_texec_b);
   exit(ret);
 }
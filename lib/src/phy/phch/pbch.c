@@ -150,7 +150,7 @@ int srslte_pbch_init(srslte_pbch_t* q)
       goto clean;
     }
     int poly[3] = {0x6D, 0x4F, 0x57};
-    if (srslte_viterbi_init(&q->decoder, SRSLTE_VITERBI_37, poly, 40, true)) {
+    if (srslte_viterbi_batch_init(&q->decoder, SRSLTE_VITERBI_37, poly, SRSLTE_BCH_PAYLOADCRC_LEN, true)) {
       goto clean;
     }
     if (srslte_crc_init(&q->crc, SRSLTE_LTE_CRC16, 16)) {
@@ -161,7 +161,8 @@ int srslte_pbch_init(srslte_pbch_t* q)
     q->encoder.tail_biting = true;
     memcpy(q->encoder.poly, poly, 3 * sizeof(int));
 
-    q->nof_symbols = PBCH_RE_CP_NORM;
+    q->nof_symbols          = PBCH_RE_CP_NORM;
+    q->early_exit_threshold = SRSLTE_PBCH_EARLY_EXIT_THRESHOLD;
 
     q->d = srslte_vec_cf_malloc(q->nof_symbols);
     if (!q->d) {
@@ -208,7 +209,7 @@ void srslte_pbch_free(srslte_pbch_t* q)
 {
   srslte_sequence_free(&q->seq);
   srslte_modem_table_free(&q->mod);
-  srslte_viterbi_free(&q->decoder);
+  srslte_viterbi_batch_free(&q->decoder);
   int i;
   for (i = 0; i < SRSLTE_MAX_PORTS; i++) {
     if (q->ce[i]) {
@@ -361,6 +362,14 @@ void srslte_pbch_decode_reset(srslte_pbch_t* q)
   q->frame_idx = 0;
 }
 
+/* Candidates whose decoder reliability is below the threshold are not checked, see SRSLTE_PBCH_EARLY_EXIT_THRESHOLD */
+void srslte_pbch_set_early_exit_threshold(srslte_pbch_t* q, float threshold)
+{
+  if (q) {
+    q->early_exit_threshold = threshold;
+  }
+}
+
 void srslte_crc_set_mask(uint8_t* data, int nof_ports)
 {
   int i;
@@ -396,11 +405,15 @@ uint32_t srslte_pbch_crc_check(srslte_pbch_t* q, uint8_t* bits, uint32_t nof_por
   }
 }
 
-int decode_frame(srslte_pbch_t* q, uint32_t src, uint32_t dst, uint32_t n, uint32_t nof_bits, uint32_t nof_ports)
+/* Descrambles and de-rate-matches n frames starting at src into the positions of the 40 ms period starting at dst,
+ * and appends the result to the candidates of the batch */
+static int pbch_add_candidate(srslte_pbch_t* q, uint32_t src, uint32_t dst, uint32_t n, uint32_t nof_bits)
 {
   int j;
 
-  if (dst + n <= 4 && src + n <= 4) {
+  if (dst + n <= 4 && src + n <= 4 && q->nof_candidates < SRSLTE_PBCH_MAX_CANDIDATES) {
+    float* rm_f = q->rm_f[q->nof_candidates];
+
     srslte_vec_f_copy(&q->temp[dst * nof_bits], &q->llr[src * nof_bits], n * nof_bits);
 
     /* descramble */
@@ -414,23 +427,49 @@ int decode_frame(srslte_pbch_t* q, uint32_t src, uint32_t dst, uint32_t n, uint3
     }
 
     /* unrate matching */
-    srslte_rm_conv_rx(q->temp, 4 * nof_bits, q->rm_f, SRSLTE_BCH_ENCODED_LEN);
+    srslte_rm_conv_rx(q->temp, 4 * nof_bits, rm_f, SRSLTE_BCH_ENCODED_LEN);
 
     /* Normalize LLR */
-    srslte_vec_sc_prod_fff(q->rm_f, 1.0 / ((float)2 * n), q->rm_f, SRSLTE_BCH_ENCODED_LEN);
+    srslte_vec_sc_prod_fff(rm_f, 1.0 / ((float)2 * n), rm_f, SRSLTE_BCH_ENCODED_LEN);
+
+    q->candidate_src[q->nof_candidates] = (uint8_t)src;
+    q->candidate_dst[q->nof_candidates] = (uint8_t)dst;
+    q->candidate_n[q->nof_candidates]   = (uint8_t)n;
+    q->nof_candidates++;
+    return SRSLTE_SUCCESS;
+  } else {
+    ERROR("Error in PBCH decoder: Invalid frame pointers dst=%d, src=%d, n=%d\n", src, dst, n);
+    return SRSLTE_ERROR;
+  }
+}
+
+/* Decodes all the candidates of the batch at once. The ones that are not reliable enough to be a PBCH codeword are
+ * discarded before the traceback and the CRC check, the others are checked in order.
+ *
+ * Returns the index of the first candidate that passes the CRC, -1 if none of them does
+ */
+static int pbch_decode_candidates(srslte_pbch_t* q, uint32_t nof_ports)
+{
+  float* symbols[SRSLTE_PBCH_MAX_CANDIDATES];
+  for (uint32_t i = 0; i < q->nof_candidates; i++) {
+    symbols[i] = q->rm_f[i];
+  }
 
-    /* decode */
-    srslte_viterbi_decode_f(&q->decoder, q->rm_f, q->data, SRSLTE_BCH_PAYLOADCRC_LEN);
+  if (srslte_viterbi_batch_forward_f(&q->decoder, symbols, q->nof_candidates, SRSLTE_BCH_PAYLOADCRC_LEN) <
+      SRSLTE_SUCCESS) {
+    return SRSLTE_ERROR;
+  }
 
+  for (uint32_t i = 0; i < q->nof_candidates; i++) {
+    if (srslte_viterbi_batch_reliability(&q->decoder, i) < q->early_exit_threshold) {
+      continue;
+    }
+    srslte_viterbi_batch_chainback(&q->decoder, i, q->data);
     if (!srslte_pbch_crc_check(q, q->data, nof_ports)) {
-      return 1;
-    } else {
-      return SRSLTE_SUCCESS;
+      return (int)i;
     }
-  } else {
-    ERROR("Error in PBCH decoder: Invalid frame pointers dst=%d, src=%d, n=%d\n", src, dst, n);
-    return -1;
   }
+  return SRSLTE_ERROR;
 }
 
 /* Decodes the PBCH channel
@@ -516,33 +555,41 @@ int srslte_pbch_decode(srslte_pbch_t*         q,
 
         /* We don't know where the 40 ms begin, so we try all combinations. E.g. if we received
          * 4 frames, try 1,2,3,4 individually, 12, 23, 34 in pairs, 123, 234 and finally 1234.
-         * We know they are ordered.
+         * We know they are ordered. All of them are decoded in one batch.
          */
+        q->nof_candidates = 0;
         for (nb = 0; nb < frame_idx; nb++) {
           for (dst = 0; (dst < 4 - nb); dst++) {
             for (src = 0; src < frame_idx - nb; src++) {
-              ret = decode_frame(q, src, dst, nb + 1, nof_bits, nant);
-              if (ret == 1) {
-                if (sfn_offset) {
-                  *sfn_offset = (int)dst - src + frame_idx - 1;
-                }
-                if (nof_tx_ports) {
-                  *nof_tx_ports = nant;
-                }
-                if (bch_payload) {
-                  memcpy(bch_payload, q->data, sizeof(uint8_t) * SRSLTE_BCH_PAYLOAD_LEN);
-                }
-                INFO("Decoded PBCH: src=%d, dst=%d, nb=%d, sfn_offset=%d\n",
-                     src,
-                     dst,
-                     nb + 1,
-                     (int)dst - src + frame_idx - 1);
-                srslte_pbch_decode_reset(q);
-                return 1;
+              if (pbch_add_candidate(q, src, dst, nb + 1, nof_bits)) {
+                return SRSLTE_ERROR;
               }
             }
           }
         }
+
+        int c = pbch_decode_candidates(q, nant);
+        if (c >= 0) {
+          src = q->candidate_src[c];
+          dst = q->candidate_dst[c];
+          nb  = q->candidate_n[c] - 1;
+          if (sfn_offset) {
+            *sfn_offset = (int)dst - src + frame_idx - 1;
+          }
+          if (nof_tx_ports) {
+            *nof_tx_ports = nant;
+          }
+          if (bch_payload) {
+            memcpy(bch_payload, q->data, sizeof(uint8_t) * SRSLTE_BCH_PAYLOAD_LEN);
+          }
+          INFO("Decoded PBCH: src=%d, dst=%d, nb=%d, sfn_offset=%d\n",
+               src,
+               dst,
+               nb + 1,
+               (int)dst - src + frame_idx - 1);
+          srslte_pbch_decode_reset(q);
+          return 1;
+        }
       }
       nant++;
     } while (nant <= q->cell.nof_ports);
@@ -21,6 +21,7 @@
 
 #include "srslte/phy/resampling/resample_arb.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd.h"
 #include "srslte/phy/utils/vector.h"
 #include <math.h>
 #include <string.h>
@@ -101,18 +102,36 @@ float srslte_resample_arb_polyfilt[SRSLTE_RESAMPLE_ARB_N][SRSLTE_RESAMPLE_ARB_M]
 {0.000722236729272,  -0.032053439082436,   0.171322660416961,   0.704261032406613,   0.188481383863832,  -0.033395686652146,   0.000657994314549 ,  0.000002955485215}};
 
 // clang-format on
-static inline cf_t srslte_resample_arb_dot_prod(cf_t* x, float* y, int len)
-{
-  cf_t res1 = srslte_vec_dot_prod_cfc(x, y, len);
-  return res1;
-}
 
-// Right-shift our window of samples
-void srslte_resample_arb_push(srslte_resample_arb_t* q, cf_t x)
+/*
+ * Multiply-accumulate kernel: x holds SRSLTE_RESAMPLE_ARB_M interleaved complex samples and h the duplicated real
+ * coefficients of one phase, so the product is a plain element-wise float product that maps on any SIMD width.
+ */
+static inline cf_t resample_arb_mac(const cf_t* x, const float* h)
 {
+  const float* xf  = (const float*)x;
+  cf_t         ret = 0;
+
+#if SRSLTE_SIMD_F_SIZE && (2 * SRSLTE_RESAMPLE_ARB_M) % SRSLTE_SIMD_F_SIZE == 0
+  simd_f_t acc = srslte_simd_f_mul(srslte_simd_f_loadu(xf), srslte_simd_f_loadu(h));
+  for (uint32_t i = SRSLTE_SIMD_F_SIZE; i < 2 * SRSLTE_RESAMPLE_ARB_M; i += SRSLTE_SIMD_F_SIZE) {
+    acc = srslte_simd_f_add(acc, srslte_simd_f_mul(srslte_simd_f_loadu(&xf[i]), srslte_simd_f_loadu(&h[i])));
+  }
+
+  float sum[SRSLTE_SIMD_F_SIZE];
+  srslte_simd_f_storeu(sum, acc);
+  for (uint32_t i = 0; i < SRSLTE_SIMD_F_SIZE; i += 2) {
+    __real__ ret += sum[i];
+    __imag__ ret += sum[i + 1];
+  }
+#else  /* SRSLTE_SIMD_F_SIZE */
+  for (uint32_t i = 0; i < 2 * SRSLTE_RESAMPLE_ARB_M; i += 2) {
+    __real__ ret += xf[i] * h[i];
+    __imag__ ret += xf[i + 1] * h[i + 1];
+  }
+#endif /* SRSLTE_SIMD_F_SIZE */
 
-  memmove(&q->reg[1], &q->reg[0], (SRSLTE_RESAMPLE_ARB_M - 1) * sizeof(cf_t));
-  q->reg[0] = x;
+  return ret;
 }
 
 // Initialize our struct
@@ -124,6 +143,14 @@ void srslte_resample_arb_init(srslte_resample_arb_t* q, float rate, bool interpo
   q->rate        = rate;
   q->interpolate = interpolate;
   q->step        = (1 / rate) * SRSLTE_RESAMPLE_ARB_N;
+
+  // Expand the polyphase filter bank
+  for (uint32_t p = 0; p < SRSLTE_RESAMPLE_ARB_N; p++) {
+    for (uint32_t m = 0; m < SRSLTE_RESAMPLE_ARB_M; m++) {
+      q->filt[p][2 * m]     = srslte_resample_arb_polyfilt[p][m];
+      q->filt[p][2 * m + 1] = srslte_resample_arb_polyfilt[p][m];
+    }
+  }
 }
 
 // Resample a block of input data
@@ -131,35 +158,33 @@ int srslte_resample_arb_compute(srslte_resample_arb_t* q, cf_t* input, cf_t* out
 {
   int   cnt   = 0;
   int   n_out = 0;
-  int   idx   = 0;
-  cf_t  res1, res2;
-  cf_t* filter_input;
-  float frac = 0;
-  memset(q->reg, 0, SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
+  int   idx   = (int)q->acc;
+  float coeff[2 * SRSLTE_RESAMPLE_ARB_M];
 
-  while (cnt < n_in) {
+  // The first windows overlap the history of the previous block
+  cf_t head[2 * SRSLTE_RESAMPLE_ARB_M];
+  int  n_head = SRSLTE_MIN(n_in, SRSLTE_RESAMPLE_ARB_M);
+  memcpy(head, q->reg, SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
+  memcpy(&head[SRSLTE_RESAMPLE_ARB_M], input, n_head * sizeof(cf_t));
+  memset(&head[SRSLTE_RESAMPLE_ARB_M + n_head], 0, (SRSLTE_RESAMPLE_ARB_M - n_head) * sizeof(cf_t));
 
-    if (cnt < SRSLTE_RESAMPLE_ARB_M) {
-      memcpy(&q->reg[SRSLTE_RESAMPLE_ARB_M - cnt], input, (cnt) * sizeof(cf_t));
-      filter_input = q->reg;
-    } else {
-      filter_input = &input[cnt - SRSLTE_RESAMPLE_ARB_M];
-    }
+  while (cnt < n_in) {
+    // Window of M samples finishing at the current input sample
+    const cf_t*  filter_input = (cnt < SRSLTE_RESAMPLE_ARB_M) ? &head[cnt] : &input[cnt - SRSLTE_RESAMPLE_ARB_M];
+    const float* h            = q->filt[idx];
 
-    res1 = srslte_resample_arb_dot_prod(filter_input, srslte_resample_arb_polyfilt[idx], SRSLTE_RESAMPLE_ARB_M);
     if (q->interpolate) {
-      res2 = srslte_resample_arb_dot_prod(
-          filter_input, srslte_resample_arb_polyfilt[(idx + 1) % SRSLTE_RESAMPLE_ARB_N], SRSLTE_RESAMPLE_ARB_M);
+      // Linear interpolation between adjacent phases is applied on the coefficients, one MAC per output
+      const float* h1   = q->filt[(idx + 1) % SRSLTE_RESAMPLE_ARB_N];
+      float        frac = fabsf(q->acc - idx);
+      for (uint32_t i = 0; i < 2 * SRSLTE_RESAMPLE_ARB_M; i++) {
+        coeff[i] = h[i] + (h1[i] - h[i]) * frac;
+      }
+      h = coeff;
     }
 
-    if (idx == SRSLTE_RESAMPLE_ARB_N) {
-      *output = res1;
-    } else {
-      *output = (q->interpolate) ? (res1 + (res2 - res1) * frac) : res1;
-    }
+    output[n_out++] = resample_arb_mac(filter_input, h);
 
-    output++;
-    n_out++;
     q->acc += q->step;
     idx = (int)(q->acc);
 
@@ -170,12 +195,33 @@ int srslte_resample_arb_compute(srslte_resample_arb_t* q, cf_t* input, cf_t* out
         cnt++;
       }
     }
+  }
 
-    if (q->interpolate) {
-      frac = q->acc - idx;
-      if (frac < 0)
-        frac = frac * (-1);
-    }
+  // Save the last M samples for the next block
+  if (n_in >= SRSLTE_RESAMPLE_ARB_M) {
+    memcpy(q->reg, &input[n_in - SRSLTE_RESAMPLE_ARB_M], SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
+  } else if (n_in > 0) {
+    memcpy(q->reg, &head[n_in], SRSLTE_RESAMPLE_ARB_M * sizeof(cf_t));
   }
+
   return n_out;
 }
+
+uint32_t srslte_resample_arb_nof_input(const srslte_resample_arb_t* q, uint32_t n_out)
+{
+  // Replay the phase accumulator exactly as srslte_resample_arb_compute() does
+  float    acc = q->acc;
+  uint32_t cnt = 0;
+
+  for (uint32_t i = 0; i < n_out; i++) {
+    acc += q->step;
+    int idx = (int)acc;
+    while (idx >= SRSLTE_RESAMPLE_ARB_N) {
+      acc -= SRSLTE_RESAMPLE_ARB_N;
+      idx -= SRSLTE_RESAMPLE_ARB_N;
+      cnt++;
+    }
+  }
+
+  return cnt;
+}
@@ -29,30 +29,70 @@
 #include "srslte/phy/resampling/resample_arb.h"
 #include "srslte/srslte.h"
 
-#define ITERATIONS 10000
+static int   iterations  = 10000;
+static int   N           = 9000;
+static float rate        = 24.0 / 25.0;
+static bool  interpolate = false;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [rnti]\n", prog);
+  printf("\t-r Resampling rate [Default %f]\n", rate);
+  printf("\t-n Number of input samples per block [Default %d]\n", N);
+  printf("\t-t Number of iterations [Default %d]\n", iterations);
+  printf("\t-i Interpolate between filter phases [Default %s]\n", interpolate ? "true" : "false");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "rnti")) != -1) {
+    switch (opt) {
+      case 'r':
+        rate = strtof(argv[optind], NULL);
+        break;
+      case 'n':
+        N = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        iterations = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'i':
+        interpolate = true;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
-  int   N    = 9000;
-  float rate = 24.0 / 25.0;
-  cf_t* in   = srslte_vec_cf_malloc(N);
-  cf_t* out  = srslte_vec_cf_malloc(N);
+  parse_args(argc, argv);
+
+  cf_t* in  = srslte_vec_cf_malloc(N);
+  cf_t* out = srslte_vec_cf_malloc((int)(N * rate) + 2);
+  if (!in || !out) {
+    perror("malloc");
+    exit(-1);
+  }
 
   for (int i = 0; i < N; i++)
     in[i] = sin(i * 2 * M_PI / 100);
 
   srslte_resample_arb_t r;
-  srslte_resample_arb_init(&r, rate, 0);
+  srslte_resample_arb_init(&r, rate, interpolate);
 
   clock_t start = clock(), diff;
-  for (int xx = 0; xx < ITERATIONS; xx++) {
+  for (int xx = 0; xx < iterations; xx++) {
     srslte_resample_arb_compute(&r, in, out, N);
   }
   diff = clock() - start;
 
-  diff       = diff / ITERATIONS;
-  int   msec = diff * 1000 / CLOCKS_PER_SEC;
-  float thru = (CLOCKS_PER_SEC / (float)diff) * (N / 1e6);
-  printf("Time taken %d seconds %d milliseconds\n", msec / 1000, msec % 1000);
+  double sec  = (double)diff / CLOCKS_PER_SEC / iterations;
+  double thru = (N / 1e6) / sec;
+  printf("Time taken %.1f us per block of %d samples\n", sec * 1e6, N);
   printf("Rate = %f MS/sec\n", thru);
 
   free(in);
@@ -76,6 +76,57 @@ int main(int argc, char** argv)
     free(out);
   }
 
+  // Resampling a stream in blocks must match resampling it at once
+  for (int interpolate = 0; interpolate < 2; interpolate++) {
+    int   len   = 1920;
+    float rate  = 23.04f / 30.72f;
+    cf_t* in    = srslte_vec_cf_malloc(len);
+    cf_t* out1  = srslte_vec_cf_malloc(len);
+    cf_t* out2  = srslte_vec_cf_malloc(len);
+    int   n_out = 0;
+    if (!in || !out1 || !out2) {
+      perror("malloc");
+      exit(-1);
+    }
+
+    for (int i = 0; i < len; i++) {
+      in[i] = cexpf(_Complex_I * 2.0f * (float)M_PI * i / 50.0f);
+    }
+
+    srslte_resample_arb_t r;
+    srslte_resample_arb_init(&r, rate, interpolate);
+    int n_ref = srslte_resample_arb_compute(&r, in, out1, len);
+
+    srslte_resample_arb_init(&r, rate, interpolate);
+    int consumed = 0;
+    while (consumed < len) {
+      // Ask for the exact number of input samples that gives 180 output samples
+      int n_in = SRSLTE_MIN((int)srslte_resample_arb_nof_input(&r, 180), len - consumed);
+      int n    = srslte_resample_arb_compute(&r, &in[consumed], &out2[n_out], n_in);
+      if (consumed + n_in < len && n != 180) {
+        printf("Block resampling produced %d samples, 180 expected\n", n);
+        exit(-1);
+      }
+      n_out += n;
+      consumed += n_in;
+    }
+
+    if (n_out != n_ref) {
+      printf("Block resampling produced %d samples, %d expected\n", n_out, n_ref);
+      exit(-1);
+    }
+    for (int i = 0; i < n_out; i++) {
+      if (cabsf(out1[i] - out2[i]) > 1e-5f) {
+        printf("Block resampling mismatch at sample %d\n", i);
+        exit(-1);
+      }
+    }
+
+    free(in);
+    free(out1);
+    free(out2);
+  }
+
   printf("Ok\n");
   exit(0);
 }
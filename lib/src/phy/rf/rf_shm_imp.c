@@ -0,0 +1,1021 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp.h"
+#include "rf_helper.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <srslte/phy/common/phy_common.h>
+#include <srslte/phy/common/timestamp.h>
+#include <srslte/phy/utils/vector.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Definitions */
+#define SHM_MAGIC (0x53484d31) // "SHM1", written last by the eNB once the segment is initialised
+#define SHM_VERSION (1)
+#define SHM_BASERATE_DEFAULT_HZ (23040000)
+#define SHM_RING_MS_DEFAULT (20)
+#define SHM_MAX_UES_DEFAULT (16)
+#define SHM_TIMEOUT_MS_DEFAULT (1000)
+#define SHM_ATTACH_TIMEOUT_MS_DEFAULT (10000)
+#define SHM_WAIT_SLICE_MS (10)
+#define SHM_MAX_GAIN_DB (30.0f)
+#define SHM_MIN_GAIN_DB (0.0f)
+#define SHM_ALIGN(X) (((size_t)(X) + 63) & ~((size_t)63))
+
+typedef enum { SHM_SLOT_FREE = 0, SHM_SLOT_ATTACHING, SHM_SLOT_ACTIVE } rf_shm_slot_state_t;
+
+/* Per UE slot, located in the shared segment */
+typedef struct {
+  uint32_t state;     // rf_shm_slot_state_t, claimed by the UE with a CAS
+  uint32_t gen;       // Ownership token, bumped on every claim and release
+  int32_t  pid;       // Owner process, informative only
+  uint32_t nof_ports; // Number of uplink ports written by the UE
+  uint64_t start_ts;  // First base-rate timestamp the UE contributes to
+  uint64_t ul_ts[SRSLTE_MAX_CHANNELS]; // Uplink write cursor per port
+} rf_shm_slot_t;
+
+/* Segment header, located at the beginning of the shared segment */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  int32_t  owner_pid; // eNB process that created the segment
+  uint32_t base_srate;
+  uint32_t nof_ports;
+  uint32_t max_ues;
+  uint32_t ring_len; // Ring length in samples
+  uint32_t dl_seq;   // Futex word, bumped every time a downlink cursor advances
+  uint32_t ul_seq;   // Futex word, bumped every time an uplink cursor advances
+  uint64_t dl_ts[SRSLTE_MAX_CHANNELS]; // Downlink write cursor per port
+} rf_shm_hdr_t;
+
+typedef struct {
+  // Common attributes
+  srslte_rf_info_t info;
+  uint32_t         nof_channels;
+  char             id[RF_PARAM_LEN];
+  char             shm_name[RF_PARAM_LEN];
+  bool             is_enb;
+
+  // Shared segment
+  int            fd;
+  void*          segment;
+  size_t         segment_size;
+  rf_shm_hdr_t*  hdr;
+  rf_shm_slot_t* slots;
+  int32_t        slot;     // Own UE slot, -1 for the eNB. Only accessed from the Rx thread
+  uint32_t       slot_gen; // Ownership token of the own UE slot
+  uint64_t       owner;    // Own slot and token published to the Tx thread, see shm_owner_pack()
+
+  // RF State
+  uint32_t srate;
+  uint32_t base_srate;
+  uint32_t decim_factor;
+  double   rx_gain;
+  uint32_t timeout_ms;
+  bool     realtime;
+
+  // Rx timestamp and real-time pacing reference
+  uint64_t        next_rx_ts;
+  bool            pace_init;
+  uint64_t        pace_ts;
+  struct timespec pace_ref;
+
+  // Sample buffers at base rate
+  cf_t* buffer_rx[SRSLTE_MAX_CHANNELS];
+  cf_t* buffer_tx;
+
+  pthread_mutex_t decim_mutex;
+} rf_shm_handler_t;
+
+static const char shm_devname[4] = "shm";
+
+/*
+ * Segment layout: header | slots[max_ues] | DL rings[nof_ports] | UL rings[max_ues][nof_ports]
+ */
+static size_t shm_segment_size(uint32_t nof_ports, uint32_t max_ues, uint32_t ring_len)
+{
+  size_t ring_size = SHM_ALIGN(sizeof(cf_t) * ring_len);
+  return SHM_ALIGN(sizeof(rf_shm_hdr_t)) + SHM_ALIGN(sizeof(rf_shm_slot_t) * max_ues) +
+         ring_size * nof_ports * (1 + max_ues);
+}
+
+static cf_t* shm_dl_ring(rf_shm_handler_t* handler, uint32_t port)
+{
+  size_t ring_size = SHM_ALIGN(sizeof(cf_t) * handler->hdr->ring_len);
+  size_t offset    = SHM_ALIGN(sizeof(rf_shm_hdr_t)) + SHM_ALIGN(sizeof(rf_shm_slot_t) * handler->hdr->max_ues);
+  return (cf_t*)((uint8_t*)handler->segment + offset + ring_size * port);
+}
+
+static cf_t* shm_ul_ring(rf_shm_handler_t* handler, uint32_t slot, uint32_t port)
+{
+  size_t ring_size = SHM_ALIGN(sizeof(cf_t) * handler->hdr->ring_len);
+  return (cf_t*)((uint8_t*)shm_dl_ring(handler, 0) +
+                 ring_size * (handler->hdr->nof_ports * (1 + slot) + port));
+}
+
+static inline void shm_futex_wake(uint32_t* word)
+{
+  __atomic_add_fetch(word, 1, __ATOMIC_RELEASE);
+  syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static inline void shm_futex_wait(uint32_t* word, uint32_t expected)
+{
+  struct timespec timeout = {0, SHM_WAIT_SLICE_MS * 1000000L};
+  syscall(SYS_futex, word, FUTEX_WAIT, expected, &timeout, NULL, 0);
+}
+
+static inline uint64_t shm_elapsed_ms(const struct timespec* start)
+{
+  struct timespec now = {};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)(now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+static void shm_ring_write(cf_t* ring, uint32_t ring_len, uint64_t ts, const cf_t* src, uint32_t nsamples)
+{
+  uint32_t idx   = (uint32_t)(ts % ring_len);
+  uint32_t first = SRSLTE_MIN(nsamples, ring_len - idx);
+  if (src) {
+    memcpy(&ring[idx], src, sizeof(cf_t) * first);
+    memcpy(ring, &src[first], sizeof(cf_t) * (nsamples - first));
+  } else {
+    memset(&ring[idx], 0, sizeof(cf_t) * first);
+    memset(ring, 0, sizeof(cf_t) * (nsamples - first));
+  }
+}
+
+static void shm_ring_read(const cf_t* ring, uint32_t ring_len, uint64_t ts, cf_t* dst, uint32_t nsamples, bool acc)
+{
+  uint32_t idx   = (uint32_t)(ts % ring_len);
+  uint32_t first = SRSLTE_MIN(nsamples, ring_len - idx);
+  if (acc) {
+    srslte_vec_sum_ccc(dst, &ring[idx], dst, first);
+    srslte_vec_sum_ccc(&dst[first], ring, &dst[first], nsamples - first);
+  } else {
+    memcpy(dst, &ring[idx], sizeof(cf_t) * first);
+    memcpy(&dst[first], ring, sizeof(cf_t) * (nsamples - first));
+  }
+}
+
+/*
+ * Writes n samples at timestamp ts into a ring (zeros if src is NULL) and advances the write cursor to ts + n. The same
+ * cursor is pushed from the Rx and Tx threads, so it is only moved forward with a CAS and the gap between the value the
+ * CAS succeeds against and ts is zeroed before it is published. Late writes overwrite the ring in place.
+ */
+static void shm_ring_push(cf_t* ring, uint32_t ring_len, uint64_t* cursor, uint64_t ts, const cf_t* src, uint32_t n)
+{
+  if (n > 0) {
+    shm_ring_write(ring, ring_len, ts, src, n);
+  }
+
+  uint64_t end = ts + n;
+  uint64_t cur = __atomic_load_n(cursor, __ATOMIC_ACQUIRE);
+  while (end > cur) {
+    if (ts > cur) {
+      // Only the samples not overlapping the new data are observable in a long gap
+      uint64_t from = SRSLTE_MAX(cur, end - ring_len);
+      shm_ring_write(ring, ring_len, from, NULL, (uint32_t)(ts - from));
+    }
+    if (__atomic_compare_exchange_n(cursor, &cur, end, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      break;
+    }
+  }
+}
+
+/* Slot and ownership token in a single word, so the Tx thread reads both consistently while the Rx thread re-attaches */
+static inline uint64_t shm_owner_pack(uint32_t slot, uint32_t gen)
+{
+  return ((uint64_t)gen << 32) | slot;
+}
+
+/* True while slot s is still owned with token gen, i.e. the eNB did not release it and no other UE claimed it since */
+static bool shm_slot_owned(rf_shm_handler_t* handler, uint32_t s, uint32_t gen)
+{
+  rf_shm_slot_t* slot = &handler->slots[s];
+  return __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) == SHM_SLOT_ACTIVE &&
+         __atomic_load_n(&slot->gen, __ATOMIC_ACQUIRE) == gen;
+}
+
+/* Releases a slot if its ownership token is still gen, returns false if somebody else released or claimed it first */
+static bool shm_slot_release(rf_shm_slot_t* slot, uint32_t gen)
+{
+  if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != SHM_SLOT_ACTIVE ||
+      !__atomic_compare_exchange_n(&slot->gen, &gen, gen + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  __atomic_store_n(&slot->state, SHM_SLOT_FREE, __ATOMIC_RELEASE);
+  return true;
+}
+
+static void shm_update_rates(rf_shm_handler_t* handler, double srate)
+{
+  pthread_mutex_lock(&handler->decim_mutex);
+  // Decimation must be full integer
+  if (((uint64_t)handler->base_srate % (uint64_t)srate) == 0) {
+    handler->srate        = (uint32_t)srate;
+    handler->decim_factor = handler->base_srate / handler->srate;
+  } else {
+    fprintf(stderr,
+            "[shm] Error: couldn't update sample rate. %.2f is not divisible by %.2f\n",
+            srate / 1e6,
+            handler->base_srate / 1e6);
+  }
+  pthread_mutex_unlock(&handler->decim_mutex);
+}
+
+static uint32_t shm_get_decim_factor(rf_shm_handler_t* handler)
+{
+  pthread_mutex_lock(&handler->decim_mutex);
+  uint32_t decim_factor = handler->decim_factor;
+  pthread_mutex_unlock(&handler->decim_mutex);
+  return decim_factor;
+}
+
+/* Sleeps until the wall-clock time corresponding to the base-rate timestamp ts */
+static void shm_pace(rf_shm_handler_t* handler, uint64_t ts)
+{
+  if (!handler->pace_init) {
+    clock_gettime(CLOCK_MONOTONIC, &handler->pace_ref);
+    handler->pace_ts   = ts;
+    handler->pace_init = true;
+    return;
+  }
+
+  uint64_t        delta  = ts - handler->pace_ts;
+  struct timespec target = handler->pace_ref;
+  target.tv_sec += (time_t)(delta / handler->base_srate);
+  target.tv_nsec += (long)(((delta % handler->base_srate) * 1000000000ULL) / handler->base_srate);
+  if (target.tv_nsec >= 1000000000L) {
+    target.tv_sec++;
+    target.tv_nsec -= 1000000000L;
+  }
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL);
+}
+
+static int shm_create_segment(rf_shm_handler_t* handler, uint32_t max_ues, uint32_t ring_ms)
+{
+  uint32_t ring_len = (uint32_t)(((uint64_t)handler->base_srate * ring_ms) / 1000);
+  size_t   size     = shm_segment_size(handler->nof_channels, max_ues, ring_len);
+
+  // Refuse to take over the segment of a running eNB, remove stale segments left behind by a crashed one
+  int fd = shm_open(handler->shm_name, O_RDWR, 0);
+  if (fd >= 0) {
+    int32_t     owner = 0;
+    struct stat st    = {};
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(rf_shm_hdr_t)) {
+      rf_shm_hdr_t* old = (rf_shm_hdr_t*)mmap(NULL, sizeof(rf_shm_hdr_t), PROT_READ, MAP_SHARED, fd, 0);
+      if (old != MAP_FAILED) {
+        if (__atomic_load_n(&old->magic, __ATOMIC_ACQUIRE) == SHM_MAGIC) {
+          owner = old->owner_pid;
+        }
+        munmap(old, sizeof(rf_shm_hdr_t));
+      }
+    }
+    close(fd);
+
+    if (owner > 0 && (kill(owner, 0) == 0 || errno == EPERM)) {
+      fprintf(stderr, "[shm] Error: %s is in use by a running eNB (pid %d)\n", handler->shm_name, owner);
+      return SRSLTE_ERROR;
+    }
+    shm_unlink(handler->shm_name);
+  }
+
+  handler->fd = shm_open(handler->shm_name, O_CREAT | O_EXCL | O_RDWR, 0660);
+  if (handler->fd < 0) {
+    perror("shm_open");
+    return SRSLTE_ERROR;
+  }
+
+  if (ftruncate(handler->fd, (off_t)size) < 0) {
+    perror("ftruncate");
+    return SRSLTE_ERROR;
+  }
+
+  handler->segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handler->fd, 0);
+  if (handler->segment == MAP_FAILED) {
+    handler->segment = NULL;
+    perror("mmap");
+    return SRSLTE_ERROR;
+  }
+  handler->segment_size = size;
+
+  handler->hdr             = (rf_shm_hdr_t*)handler->segment;
+  handler->slots           = (rf_shm_slot_t*)((uint8_t*)handler->segment + SHM_ALIGN(sizeof(rf_shm_hdr_t)));
+  handler->hdr->version    = SHM_VERSION;
+  handler->hdr->owner_pid  = getpid();
+  handler->hdr->base_srate = handler->base_srate;
+  handler->hdr->nof_ports  = handler->nof_channels;
+  handler->hdr->max_ues    = max_ues;
+  handler->hdr->ring_len   = ring_len;
+  __atomic_store_n(&handler->hdr->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+
+  printf("[shm] %s created %s with %d port(s), %d UE slot(s) and %.1f MB\n",
+         handler->id,
+         handler->shm_name,
+         handler->nof_channels,
+         max_ues,
+         size / 1e6);
+
+  return SRSLTE_SUCCESS;
+}
+
+static int shm_attach_segment(rf_shm_handler_t* handler, uint32_t attach_wait_ms)
+{
+  struct timespec start = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  // Wait for the eNB to create and initialise the segment
+  rf_shm_hdr_t* hdr = NULL;
+  while (hdr == NULL) {
+    if (handler->fd < 0) {
+      handler->fd = shm_open(handler->shm_name, O_RDWR, 0);
+    }
+
+    struct stat st = {};
+    if (handler->fd >= 0 && fstat(handler->fd, &st) == 0 && st.st_size >= (off_t)sizeof(rf_shm_hdr_t)) {
+      hdr = (rf_shm_hdr_t*)mmap(NULL, sizeof(rf_shm_hdr_t), PROT_READ, MAP_SHARED, handler->fd, 0);
+      if (hdr == MAP_FAILED) {
+        perror("mmap");
+        return SRSLTE_ERROR;
+      }
+      if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC) {
+        munmap(hdr, sizeof(rf_shm_hdr_t));
+        hdr = NULL;
+      }
+    }
+
+    if (hdr == NULL) {
+      if (shm_elapsed_ms(&start) > attach_wait_ms) {
+        fprintf(stderr, "[shm] Error: timeout waiting for segment %s\n", handler->shm_name);
+        return SRSLTE_ERROR;
+      }
+      usleep(SHM_WAIT_SLICE_MS * 1000);
+    }
+  }
+
+  if (hdr->version != SHM_VERSION || hdr->nof_ports < handler->nof_channels) {
+    fprintf(stderr,
+            "[shm] Error: incompatible segment %s (version %d, %d ports)\n",
+            handler->shm_name,
+            hdr->version,
+            hdr->nof_ports);
+    munmap(hdr, sizeof(rf_shm_hdr_t));
+    return SRSLTE_ERROR;
+  }
+
+  size_t size         = shm_segment_size(hdr->nof_ports, hdr->max_ues, hdr->ring_len);
+  handler->base_srate = hdr->base_srate;
+  munmap(hdr, sizeof(rf_shm_hdr_t));
+
+  handler->segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, handler->fd, 0);
+  if (handler->segment == MAP_FAILED) {
+    handler->segment = NULL;
+    perror("mmap");
+    return SRSLTE_ERROR;
+  }
+  handler->segment_size = size;
+  handler->hdr          = (rf_shm_hdr_t*)handler->segment;
+  handler->slots        = (rf_shm_slot_t*)((uint8_t*)handler->segment + SHM_ALIGN(sizeof(rf_shm_hdr_t)));
+
+  return SRSLTE_SUCCESS;
+}
+
+/* Claims a free UE slot, starting its uplink at the current downlink time */
+static int shm_attach_slot(rf_shm_handler_t* handler, int32_t requested_slot)
+{
+  for (uint32_t s = 0; s < handler->hdr->max_ues; s++) {
+    if (requested_slot >= 0 && s != (uint32_t)requested_slot) {
+      continue;
+    }
+
+    rf_shm_slot_t* slot     = &handler->slots[s];
+    uint32_t       expected = SHM_SLOT_FREE;
+    if (__atomic_compare_exchange_n(
+            &slot->state, &expected, SHM_SLOT_ATTACHING, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      uint64_t now    = __atomic_load_n(&handler->hdr->dl_ts[0], __ATOMIC_ACQUIRE);
+      slot->pid       = getpid();
+      slot->nof_ports = handler->nof_channels;
+      slot->start_ts  = now;
+      for (uint32_t p = 0; p < handler->hdr->nof_ports; p++) {
+        __atomic_store_n(&slot->ul_ts[p], now, __ATOMIC_RELAXED);
+      }
+      handler->slot_gen = __atomic_add_fetch(&slot->gen, 1, __ATOMIC_ACQ_REL);
+      __atomic_store_n(&slot->state, SHM_SLOT_ACTIVE, __ATOMIC_RELEASE);
+
+      handler->slot       = (int32_t)s;
+      handler->next_rx_ts = now;
+      __atomic_store_n(&handler->owner, shm_owner_pack(s, handler->slot_gen), __ATOMIC_RELEASE);
+      printf("[shm] %s attached to %s slot %d\n", handler->id, handler->shm_name, s);
+      return SRSLTE_SUCCESS;
+    }
+  }
+
+  fprintf(stderr, "[shm] Error: no free UE slot in %s\n", handler->shm_name);
+  return SRSLTE_ERROR;
+}
+
+/*
+ * Public methods
+ */
+
+void rf_shm_suppress_stdout(void* h)
+{
+  // do nothing
+}
+
+void rf_shm_register_error_handler(void* h, srslte_rf_error_handler_t new_handler, void* arg)
+{
+  // do nothing
+}
+
+const char* rf_shm_devname(void* h)
+{
+  return shm_devname;
+}
+
+int rf_shm_start_rx_stream(void* h, bool now)
+{
+  return SRSLTE_SUCCESS;
+}
+
+int rf_shm_stop_rx_stream(void* h)
+{
+  return SRSLTE_SUCCESS;
+}
+
+void rf_shm_flush_buffer(void* h)
+{
+  // do nothing
+}
+
+bool rf_shm_has_rssi(void* h)
+{
+  return false;
+}
+
+float rf_shm_get_rssi(void* h)
+{
+  return 0.0;
+}
+
+int rf_shm_open(char* args, void** h)
+{
+  return rf_shm_open_multi(args, h, 1);
+}
+
+int rf_shm_open_multi(char* args, void** h, uint32_t nof_channels)
+{
+  int ret = SRSLTE_ERROR;
+  if (h && nof_channels > 0 && nof_channels < SRSLTE_MAX_CHANNELS) {
+    *h = NULL;
+
+    // The device is only selected when a role is given, so auto mode skips it
+    char role[RF_PARAM_LEN] = {};
+    if (args == NULL || parse_string(args, "role", -1, role) != SRSLTE_SUCCESS) {
+      return SRSLTE_ERROR;
+    }
+
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)malloc(sizeof(rf_shm_handler_t));
+    if (!handler) {
+      perror("malloc");
+      return SRSLTE_ERROR;
+    }
+    bzero(handler, sizeof(rf_shm_handler_t));
+    *h                        = handler;
+    handler->fd               = -1;
+    handler->slot             = -1;
+    handler->base_srate       = SHM_BASERATE_DEFAULT_HZ;
+    handler->info.max_rx_gain = SHM_MAX_GAIN_DB;
+    handler->info.min_rx_gain = SHM_MIN_GAIN_DB;
+    handler->info.max_tx_gain = SHM_MAX_GAIN_DB;
+    handler->info.min_tx_gain = SHM_MIN_GAIN_DB;
+    handler->nof_channels     = nof_channels;
+    handler->timeout_ms       = SHM_TIMEOUT_MS_DEFAULT;
+    handler->realtime         = true;
+    strcpy(handler->id, "shm\0");
+
+    if (pthread_mutex_init(&handler->decim_mutex, NULL)) {
+      perror("Mutex init");
+    }
+
+    if (!strcmp(role, "enb")) {
+      handler->is_enb = true;
+    } else if (strcmp(role, "ue") != 0) {
+      fprintf(stderr, "[shm] Error: unsupported role %s\n", role);
+      goto clean_exit;
+    }
+
+    // parse args
+    char     shm_name[RF_PARAM_LEN] = "srslte";
+    uint32_t max_ues                = SHM_MAX_UES_DEFAULT;
+    uint32_t ring_ms                = SHM_RING_MS_DEFAULT;
+    uint32_t attach_wait_ms         = SHM_ATTACH_TIMEOUT_MS_DEFAULT;
+    uint32_t requested_slot         = UINT32_MAX;
+    char     tmp[RF_PARAM_LEN]      = {};
+    parse_string(args, "shm_name", -1, shm_name);
+    parse_string(args, "id", -1, handler->id);
+    parse_uint32(args, "base_srate", -1, &handler->base_srate);
+    parse_uint32(args, "max_ues", -1, &max_ues);
+    parse_uint32(args, "ring_ms", -1, &ring_ms);
+    parse_uint32(args, "timeout_ms", -1, &handler->timeout_ms);
+    parse_uint32(args, "attach_wait_ms", -1, &attach_wait_ms);
+    parse_uint32(args, "slot", -1, &requested_slot);
+    if (parse_string(args, "realtime", -1, tmp) == SRSLTE_SUCCESS) {
+      handler->realtime = (strcmp(tmp, "true") == 0 || strcmp(tmp, "yes") == 0);
+    }
+    snprintf(handler->shm_name, RF_PARAM_LEN, "/srslte_shm_%s", shm_name);
+
+    if (max_ues == 0 || ring_ms == 0) {
+      fprintf(stderr, "[shm] Error: max_ues and ring_ms must be greater than zero\n");
+      goto clean_exit;
+    }
+
+    if (handler->is_enb) {
+      if (shm_create_segment(handler, max_ues, ring_ms) != SRSLTE_SUCCESS) {
+        goto clean_exit;
+      }
+    } else {
+      if (shm_attach_segment(handler, attach_wait_ms) != SRSLTE_SUCCESS) {
+        goto clean_exit;
+      }
+      if (shm_attach_slot(handler, requested_slot == UINT32_MAX ? -1 : (int32_t)requested_slot) != SRSLTE_SUCCESS) {
+        goto clean_exit;
+      }
+    }
+
+    shm_update_rates(handler, 1.92e6);
+
+    // Create base-rate buffers, one ring is the longest period that can be exchanged at once
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      handler->buffer_rx[i] = srslte_vec_cf_malloc(handler->hdr->ring_len);
+      if (!handler->buffer_rx[i]) {
+        fprintf(stderr, "[shm] Error: allocating rx buffer\n");
+        goto clean_exit;
+      }
+    }
+
+    handler->buffer_tx = srslte_vec_cf_malloc(handler->hdr->ring_len);
+    if (!handler->buffer_tx) {
+      fprintf(stderr, "[shm] Error: allocating tx buffer\n");
+      goto clean_exit;
+    }
+
+    ret = SRSLTE_SUCCESS;
+
+  clean_exit:
+    if (ret) {
+      rf_shm_close(handler);
+      *h = NULL;
+    }
+  }
+  return ret;
+}
+
+int rf_shm_close(void* h)
+{
+  rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+  if (handler == NULL) {
+    return SRSLTE_ERROR;
+  }
+
+  if (handler->segment) {
+    if (handler->is_enb) {
+      // Tell attached UEs that the eNB is gone
+      __atomic_store_n(&handler->hdr->magic, 0, __ATOMIC_RELEASE);
+      shm_futex_wake(&handler->hdr->dl_seq);
+    } else if (handler->slot >= 0) {
+      shm_slot_release(&handler->slots[handler->slot], handler->slot_gen);
+      shm_futex_wake(&handler->hdr->ul_seq);
+    }
+    munmap(handler->segment, handler->segment_size);
+  }
+
+  if (handler->fd >= 0) {
+    close(handler->fd);
+    if (handler->is_enb) {
+      shm_unlink(handler->shm_name);
+    }
+  }
+
+  for (uint32_t i = 0; i < handler->nof_channels; i++) {
+    if (handler->buffer_rx[i]) {
+      free(handler->buffer_rx[i]);
+    }
+  }
+
+  if (handler->buffer_tx) {
+    free(handler->buffer_tx);
+  }
+
+  pthread_mutex_destroy(&handler->decim_mutex);
+
+  free(handler);
+
+  return SRSLTE_SUCCESS;
+}
+
+double rf_shm_set_rx_srate(void* h, double srate)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    shm_update_rates(handler, srate);
+    ret = handler->srate;
+  }
+  return ret;
+}
+
+double rf_shm_set_tx_srate(void* h, double srate)
+{
+  return rf_shm_set_rx_srate(h, srate);
+}
+
+int rf_shm_set_rx_gain(void* h, double gain)
+{
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    handler->rx_gain          = gain;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int rf_shm_set_rx_gain_ch(void* h, uint32_t ch, double gain)
+{
+  return rf_shm_set_rx_gain(h, gain);
+}
+
+int rf_shm_set_tx_gain(void* h, double gain)
+{
+  return SRSLTE_SUCCESS;
+}
+
+int rf_shm_set_tx_gain_ch(void* h, uint32_t ch, double gain)
+{
+  return rf_shm_set_tx_gain(h, gain);
+}
+
+double rf_shm_get_rx_gain(void* h)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    ret                       = handler->rx_gain;
+  }
+  return ret;
+}
+
+double rf_shm_get_tx_gain(void* h)
+{
+  return 0.0;
+}
+
+srslte_rf_info_t* rf_shm_get_info(void* h)
+{
+  srslte_rf_info_t* info = NULL;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    info                      = &handler->info;
+  }
+  return info;
+}
+
+// Ports are mapped one to one to channels, frequencies are not matched
+double rf_shm_set_rx_freq(void* h, uint32_t ch, double freq)
+{
+  return freq;
+}
+
+double rf_shm_set_tx_freq(void* h, uint32_t ch, double freq)
+{
+  return freq;
+}
+
+void rf_shm_get_time(void* h, time_t* secs, double* frac_secs)
+{
+  if (h) {
+    rf_shm_handler_t*  handler = (rf_shm_handler_t*)h;
+    srslte_timestamp_t ts      = {};
+    srslte_timestamp_init_uint64(&ts, handler->next_rx_ts, handler->base_srate);
+    if (secs) {
+      *secs = ts.full_secs;
+    }
+    if (frac_secs) {
+      *frac_secs = ts.frac_secs;
+    }
+  }
+}
+
+/*
+ * eNB side: publishes the downlink up to the end of the requested period, then waits until every attached UE has
+ * written its uplink for that period and sums all contributions.
+ */
+static int shm_enb_receive(rf_shm_handler_t* handler, uint64_t rx_ts, uint32_t nsamples)
+{
+  rf_shm_hdr_t* hdr    = handler->hdr;
+  uint64_t      rx_end = rx_ts + nsamples;
+
+  for (uint32_t p = 0; p < handler->nof_channels; p++) {
+    shm_ring_push(shm_dl_ring(handler, p), hdr->ring_len, &hdr->dl_ts[p], rx_end, NULL, 0);
+  }
+  shm_futex_wake(&hdr->dl_seq);
+
+  if (handler->realtime) {
+    shm_pace(handler, rx_end);
+  }
+
+  struct timespec start = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool ready = false;
+  while (!ready) {
+    uint32_t seq = __atomic_load_n(&hdr->ul_seq, __ATOMIC_ACQUIRE);
+    bool     expired = shm_elapsed_ms(&start) > handler->timeout_ms;
+
+    ready = true;
+    for (uint32_t s = 0; s < hdr->max_ues; s++) {
+      rf_shm_slot_t* slot = &handler->slots[s];
+      uint32_t       gen  = __atomic_load_n(&slot->gen, __ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != SHM_SLOT_ACTIVE) {
+        continue;
+      }
+      // A UE only writes the ports it opened
+      uint32_t nof_ports = SRSLTE_MIN(slot->nof_ports, handler->nof_channels);
+      for (uint32_t p = 0; p < nof_ports; p++) {
+        if (__atomic_load_n(&slot->ul_ts[p], __ATOMIC_ACQUIRE) < rx_end) {
+          if (expired) {
+            // Stalled or dead UE, release its slot so it no longer blocks the cell
+            if (shm_slot_release(slot, gen)) {
+              fprintf(stderr, "[shm] %s detaching unresponsive UE slot %d (pid %d)\n", handler->id, s, slot->pid);
+            }
+          } else {
+            ready = false;
+          }
+          break;
+        }
+      }
+    }
+
+    if (!ready) {
+      shm_futex_wait(&hdr->ul_seq, seq);
+    }
+  }
+
+  for (uint32_t p = 0; p < handler->nof_channels; p++) {
+    srslte_vec_cf_zero(handler->buffer_rx[p], nsamples);
+  }
+
+  for (uint32_t s = 0; s < hdr->max_ues; s++) {
+    rf_shm_slot_t* slot = &handler->slots[s];
+    if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != SHM_SLOT_ACTIVE || slot->start_ts >= rx_end) {
+      continue;
+    }
+    uint64_t from      = SRSLTE_MAX(slot->start_ts, rx_ts);
+    uint32_t nof_ports = SRSLTE_MIN(slot->nof_ports, handler->nof_channels);
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      shm_ring_read(shm_ul_ring(handler, s, p),
+                    hdr->ring_len,
+                    from,
+                    &handler->buffer_rx[p][from - rx_ts],
+                    (uint32_t)(rx_end - from),
+                    true);
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * UE side: advances the own uplink up to the end of the requested period, so the eNB is never blocked by a silent UE,
+ * then waits for the eNB downlink.
+ */
+static int shm_ue_receive(rf_shm_handler_t* handler, uint64_t rx_ts, uint32_t nsamples)
+{
+  rf_shm_hdr_t*  hdr    = handler->hdr;
+  rf_shm_slot_t* slot   = &handler->slots[handler->slot];
+  uint64_t       rx_end = rx_ts + nsamples;
+
+  for (uint32_t p = 0; p < handler->nof_channels; p++) {
+    shm_ring_push(shm_ul_ring(handler, handler->slot, p), hdr->ring_len, &slot->ul_ts[p], rx_end, NULL, 0);
+  }
+  shm_futex_wake(&hdr->ul_seq);
+
+  struct timespec start  = {};
+  bool            warned = false;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint32_t p = 0; p < handler->nof_channels; p++) {
+    while (__atomic_load_n(&hdr->dl_ts[p], __ATOMIC_ACQUIRE) < rx_end) {
+      uint32_t seq = __atomic_load_n(&hdr->dl_seq, __ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC) {
+        fprintf(stderr, "[shm] %s eNB closed %s\n", handler->id, handler->shm_name);
+        return SRSLTE_ERROR;
+      }
+      if (shm_elapsed_ms(&start) > handler->timeout_ms) {
+        // A crashed eNB never clears the magic, check that its process still exists
+        if (kill(hdr->owner_pid, 0) != 0 && errno == ESRCH) {
+          fprintf(stderr, "[shm] %s eNB process %d of %s is gone\n", handler->id, hdr->owner_pid, handler->shm_name);
+          return SRSLTE_ERROR;
+        }
+        if (!warned) {
+          fprintf(stderr, "[shm] %s waiting for eNB downlink\n", handler->id);
+          warned = true;
+        }
+      }
+      if (__atomic_load_n(&hdr->dl_ts[p], __ATOMIC_ACQUIRE) < rx_end) {
+        shm_futex_wait(&hdr->dl_seq, seq);
+      }
+    }
+  }
+
+  for (uint32_t p = 0; p < handler->nof_channels; p++) {
+    shm_ring_read(shm_dl_ring(handler, p), hdr->ring_len, rx_ts, handler->buffer_rx[p], nsamples, false);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int rf_shm_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+{
+  return rf_shm_recv_with_time_multi(h, &data, nsamples, blocking, secs, frac_secs);
+}
+
+int rf_shm_recv_with_time_multi(void*    h,
+                                void**   data,
+                                uint32_t nsamples,
+                                bool     blocking,
+                                time_t*  secs,
+                                double*  frac_secs)
+{
+  int ret = SRSLTE_ERROR;
+
+  if (h && data) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+    uint32_t decim_factor      = shm_get_decim_factor(handler);
+    uint32_t nsamples_baserate = nsamples * decim_factor;
+    if (nsamples_baserate > handler->hdr->ring_len) {
+      fprintf(stderr,
+              "[shm] Error: trying to receive %d samples but the ring holds only %d\n",
+              nsamples_baserate,
+              handler->hdr->ring_len);
+      return SRSLTE_ERROR;
+    }
+
+    // The eNB may have released the slot of a stalled UE, attach again at the current time
+    if (!handler->is_enb && !shm_slot_owned(handler, (uint32_t)handler->slot, handler->slot_gen)) {
+      fprintf(stderr, "[shm] %s lost slot %d, re-attaching\n", handler->id, handler->slot);
+      if (shm_attach_slot(handler, -1) != SRSLTE_SUCCESS) {
+        return SRSLTE_ERROR;
+      }
+    }
+
+    // set timestamp for this reception
+    if (secs != NULL && frac_secs != NULL) {
+      srslte_timestamp_t ts = {};
+      srslte_timestamp_init_uint64(&ts, handler->next_rx_ts, handler->base_srate);
+      *secs      = ts.full_secs;
+      *frac_secs = ts.frac_secs;
+    }
+
+    if (handler->is_enb) {
+      ret = shm_enb_receive(handler, handler->next_rx_ts, nsamples_baserate);
+    } else {
+      ret = shm_ue_receive(handler, handler->next_rx_ts, nsamples_baserate);
+    }
+    if (ret != SRSLTE_SUCCESS) {
+      return ret;
+    }
+
+    // Decimate by averaging and apply gain
+    float scale = srslte_convert_dB_to_amplitude(handler->rx_gain) / (float)decim_factor;
+    for (uint32_t c = 0; c < handler->nof_channels; c++) {
+      cf_t* dst = (cf_t*)data[c];
+      if (dst == NULL) {
+        continue;
+      }
+      cf_t* src = handler->buffer_rx[c];
+      for (uint32_t i = 0, n = 0; i < nsamples; i++) {
+        cf_t acc = 0.0f;
+        for (uint32_t j = 0; j < decim_factor; j++, n++) {
+          acc += src[n];
+        }
+        dst[i] = acc;
+      }
+      srslte_vec_sc_prod_cfc(dst, scale, dst, nsamples);
+    }
+
+    handler->next_rx_ts += nsamples_baserate;
+    ret = nsamples;
+  }
+
+  return ret;
+}
+
+int rf_shm_send_timed(void*  h,
+                      void*  data,
+                      int    nsamples,
+                      time_t secs,
+                      double frac_secs,
+                      bool   has_time_spec,
+                      bool   blocking,
+                      bool   is_start_of_burst,
+                      bool   is_end_of_burst)
+{
+  void* _data[4] = {data, NULL, NULL, NULL};
+
+  return rf_shm_send_timed_multi(
+      h, _data, nsamples, secs, frac_secs, has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
+}
+
+int rf_shm_send_timed_multi(void*  h,
+                            void*  data[4],
+                            int    nsamples,
+                            time_t secs,
+                            double frac_secs,
+                            bool   has_time_spec,
+                            bool   blocking,
+                            bool   is_start_of_burst,
+                            bool   is_end_of_burst)
+{
+  if (h && data && nsamples > 0) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    rf_shm_hdr_t*     hdr     = handler->hdr;
+
+    uint32_t decim_factor      = shm_get_decim_factor(handler);
+    uint32_t nsamples_baserate = (uint32_t)nsamples * decim_factor;
+    if (nsamples_baserate > hdr->ring_len) {
+      fprintf(stderr,
+              "[shm] Error: trying to transmit %d samples but the ring holds only %d\n",
+              nsamples_baserate,
+              hdr->ring_len);
+      return SRSLTE_ERROR;
+    }
+
+    // A UE whose slot was released by the eNB stays silent until its next reception re-attaches it. The Rx thread may
+    // re-attach concurrently, so the slot is taken from a single snapshot that is both checked and written to
+    uint32_t slot = 0;
+    if (!handler->is_enb) {
+      uint64_t owner = __atomic_load_n(&handler->owner, __ATOMIC_ACQUIRE);
+      slot           = (uint32_t)owner;
+      if (!shm_slot_owned(handler, slot, (uint32_t)(owner >> 32))) {
+        return SRSLTE_SUCCESS;
+      }
+    }
+
+    for (uint32_t p = 0; p < handler->nof_channels; p++) {
+      uint64_t* cursor = handler->is_enb ? &hdr->dl_ts[p] : &handler->slots[slot].ul_ts[p];
+      cf_t*     ring   = handler->is_enb ? shm_dl_ring(handler, p) : shm_ul_ring(handler, slot, p);
+
+      uint64_t tx_ts = __atomic_load_n(cursor, __ATOMIC_ACQUIRE);
+      if (has_time_spec) {
+        srslte_timestamp_t ts = {};
+        srslte_timestamp_init(&ts, secs, frac_secs);
+        tx_ts = srslte_timestamp_uint64(&ts, handler->base_srate);
+      }
+
+      // Interpolate with zero order hold if required
+      cf_t* src = (cf_t*)data[p];
+      if (src != NULL && decim_factor != 1) {
+        for (uint32_t k = 0, n = 0; k < (uint32_t)nsamples; k++) {
+          for (uint32_t j = 0; j < decim_factor; j++, n++) {
+            handler->buffer_tx[n] = src[k];
+          }
+        }
+        src = handler->buffer_tx;
+      }
+
+      shm_ring_push(ring, hdr->ring_len, cursor, tx_ts, src, nsamples_baserate);
+    }
+
+    shm_futex_wake(handler->is_enb ? &hdr->dl_seq : &hdr->ul_seq);
+  }
+
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Loopback test of the shared-memory device: one 2-port eNB and two 1-port UEs run in separate processes without
+ * real-time pacing. Checks the downlink copy, the uplink sum across UEs, timestamp continuity and that a stalled UE is
+ * detached by the eNB and attaches again on its own.
+ */
+
+#include "srslte/phy/common/phy_common.h"
+#include "srslte/phy/common/timestamp.h"
+#include "srslte/phy/rf/rf.h"
+#include "srslte/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SRATE (1920000)
+#define SF_LEN (SRATE / 1000)
+#define TX_OFFSET_MS (4)
+#define NOF_UES (2)
+#define ENB_PORTS (2)
+#define STALL_UE (1)
+#define STALL_SF (300)
+#define STALL_MS (400)
+#define TEST_TIMEOUT_S (20)
+
+static char shm_name[32];
+
+// Downlink value transmitted by the eNB for the subframe starting at ts
+static float dl_value(uint64_t ts)
+{
+  return (float)((ts / SF_LEN) % 1000 + 1);
+}
+
+static uint64_t to_samples(time_t secs, double frac_secs)
+{
+  srslte_timestamp_t ts = {};
+  srslte_timestamp_init(&ts, secs, frac_secs);
+  return srslte_timestamp_uint64(&ts, SRATE);
+}
+
+// Returns the value all samples share, or NAN if they differ
+static float uniform_value(const cf_t* x, uint32_t n)
+{
+  for (uint32_t i = 1; i < n; i++) {
+    if (cabsf(x[i] - x[0]) > 1e-3f) {
+      return NAN;
+    }
+  }
+  return crealf(x[0]);
+}
+
+static bool timed_out(const struct timespec* start)
+{
+  struct timespec now = {};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec - start->tv_sec > TEST_TIMEOUT_S;
+}
+
+static int ue_process(uint32_t ue_id)
+{
+  char        args[RF_PARAM_LEN];
+  srslte_rf_t rf = {};
+  snprintf(args, RF_PARAM_LEN, "role=ue,shm_name=%s,id=ue%d,attach_wait_ms=5000", shm_name, ue_id);
+  if (srslte_rf_open_devname(&rf, "shm", args, 1)) {
+    fprintf(stderr, "UE %d: error opening device\n", ue_id);
+    return SRSLTE_ERROR;
+  }
+  srslte_rf_set_rx_srate(&rf, SRATE);
+  srslte_rf_set_tx_srate(&rf, SRATE);
+
+  cf_t*           rx       = srslte_vec_cf_malloc(SF_LEN);
+  cf_t*           tx       = srslte_vec_cf_malloc(SF_LEN);
+  uint32_t        nof_dl   = 0;
+  uint64_t        prev_ts  = 0;
+  bool            resumed  = false;
+  int             ret      = SRSLTE_SUCCESS;
+  struct timespec start    = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint32_t i = 0; i < SF_LEN; i++) {
+    tx[i] = (float)(ue_id + 1);
+  }
+
+  for (uint32_t sf = 0; !timed_out(&start); sf++) {
+    time_t secs      = 0;
+    double frac_secs = 0;
+    if (srslte_rf_recv_with_time(&rf, rx, SF_LEN, true, &secs, &frac_secs) != SF_LEN) {
+      // The eNB closed the segment
+      break;
+    }
+    uint64_t ts = to_samples(secs, frac_secs);
+
+    // Timestamps are contiguous, except across a re-attach after the stall
+    if (sf > 0 && ts != prev_ts + SF_LEN && !(resumed && ts > prev_ts)) {
+      fprintf(stderr, "UE %d: timestamp jumped from %ld to %ld\n", ue_id, (long)prev_ts, (long)ts);
+      ret = SRSLTE_ERROR;
+      break;
+    }
+    prev_ts = ts;
+    resumed = false;
+
+    // Either silence or exactly what the eNB transmitted on port 0 for this subframe
+    float v = uniform_value(rx, SF_LEN);
+    if (isnan(v) || (v != 0.0f && fabsf(v - dl_value(ts)) > 1e-3f)) {
+      fprintf(stderr, "UE %d: unexpected downlink at %ld\n", ue_id, (long)ts);
+      ret = SRSLTE_ERROR;
+      break;
+    }
+    if (v != 0.0f) {
+      nof_dl++;
+    }
+
+    srslte_rf_send_timed(&rf, tx, SF_LEN, secs, frac_secs + TX_OFFSET_MS * 1e-3);
+
+    if (ue_id == STALL_UE && sf == STALL_SF) {
+      usleep(STALL_MS * 1000);
+      resumed = true;
+    }
+  }
+
+  if (ret == SRSLTE_SUCCESS && nof_dl == 0) {
+    fprintf(stderr, "UE %d: no downlink received\n", ue_id);
+    ret = SRSLTE_ERROR;
+  }
+  printf("UE %d: received %d downlink subframes\n", ue_id, nof_dl);
+
+  srslte_rf_close(&rf);
+  free(rx);
+  free(tx);
+  return ret;
+}
+
+static int enb_process()
+{
+  char        args[RF_PARAM_LEN];
+  srslte_rf_t rf = {};
+  snprintf(args,
+           RF_PARAM_LEN,
+           "role=enb,shm_name=%s,max_ues=4,base_srate=%d,realtime=false,timeout_ms=100",
+           shm_name,
+           SRATE);
+  if (srslte_rf_open_devname(&rf, "shm", args, ENB_PORTS)) {
+    fprintf(stderr, "eNB: error opening device\n");
+    return SRSLTE_ERROR;
+  }
+  srslte_rf_set_rx_srate(&rf, SRATE);
+  srslte_rf_set_tx_srate(&rf, SRATE);
+
+  cf_t* rx[SRSLTE_MAX_CHANNELS] = {};
+  cf_t* tx[SRSLTE_MAX_CHANNELS] = {};
+  for (uint32_t p = 0; p < ENB_PORTS; p++) {
+    rx[p] = srslte_vec_cf_malloc(SF_LEN);
+    tx[p] = srslte_vec_cf_malloc(SF_LEN);
+  }
+
+  // Uplink sum expected in each phase: both UEs, only the one that did not stall, both again after the re-attach
+  const float     phases[] = {1.0f + 2.0f, 1.0f, 1.0f + 2.0f};
+  uint32_t        phase    = 0;
+  uint32_t        tail     = 0;
+  uint64_t        prev_ts  = 0;
+  int             ret      = SRSLTE_ERROR;
+  struct timespec start    = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (uint32_t sf = 0; !timed_out(&start); sf++) {
+    time_t secs      = 0;
+    double frac_secs = 0;
+    if (srslte_rf_recv_with_time_multi(&rf, (void**)rx, SF_LEN, true, &secs, &frac_secs) != SF_LEN) {
+      fprintf(stderr, "eNB: error receiving\n");
+      break;
+    }
+    uint64_t ts = to_samples(secs, frac_secs);
+    if (sf > 0 && ts != prev_ts + SF_LEN) {
+      fprintf(stderr, "eNB: timestamp jumped from %ld to %ld\n", (long)prev_ts, (long)ts);
+      break;
+    }
+    prev_ts = ts;
+
+    // Every subframe carries the sum of the UEs transmitting in it, UEs only write port 0
+    float v = uniform_value(rx[0], SF_LEN);
+    if (isnan(v) || v < 0.0f || v > 3.0f || uniform_value(rx[1], SF_LEN) != 0.0f) {
+      fprintf(stderr, "eNB: unexpected uplink at %ld\n", (long)ts);
+      break;
+    }
+    if (phase < 3 && v == phases[phase]) {
+      printf("eNB: uplink sum %.0f at subframe %d\n", v, sf);
+      phase++;
+    }
+    if (phase == 3 && ++tail == 100) {
+      ret = SRSLTE_SUCCESS;
+      break;
+    }
+
+    uint64_t tx_ts = ts + TX_OFFSET_MS * SF_LEN;
+    for (uint32_t i = 0; i < SF_LEN; i++) {
+      tx[0][i] = dl_value(tx_ts);
+      tx[1][i] = -dl_value(tx_ts);
+    }
+    srslte_rf_send_timed_multi(&rf, (void**)tx, SF_LEN, secs, frac_secs + TX_OFFSET_MS * 1e-3, true, true, false);
+  }
+
+  if (ret != SRSLTE_SUCCESS) {
+    fprintf(stderr, "eNB: stopped in phase %d\n", phase);
+  }
+
+  srslte_rf_close(&rf);
+  for (uint32_t p = 0; p < ENB_PORTS; p++) {
+    free(rx[p]);
+    free(tx[p]);
+  }
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  snprintf(shm_name, sizeof(shm_name), "rftest%d", getpid());
+  setvbuf(stdout, NULL, _IONBF, 0);
+
+  pid_t ue_pids[NOF_UES];
+  for (uint32_t i = 0; i < NOF_UES; i++) {
+    ue_pids[i] = fork();
+    if (ue_pids[i] == 0) {
+      exit(ue_process(i) == SRSLTE_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  }
+
+  int ret = enb_process();
+
+  for (uint32_t i = 0; i < NOF_UES; i++) {
+    int status = 0;
+    if (waitpid(ue_pids[i], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      fprintf(stderr, "UE %d failed\n", i);
+      ret = SRSLTE_ERROR;
+    }
+  }
+
+  printf("%s\n", ret == SRSLTE_SUCCESS ? "Ok" : "Failed");
+  return ret == SRSLTE_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
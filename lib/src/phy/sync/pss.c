@@ -539,6 +539,76 @@ int srslte_pss_find_pss(srslte_pss_t* q, const cf_t* input, float* corr_peak_val
   return ret;
 }
 
+/** Batched version of srslte_pss_find_pss() for the three N_id_2 hypotheses.
+ * The input block is transformed once and the three correlations share that FFT, so searching all the sequences costs
+ * one FFT plus three frequency-domain products and inverse FFTs, instead of three full correlations.
+ * The correlation average of consecutive calls is not applied and it is reset on return.
+ *
+ * Input buffer must be subframe_size long.
+ */
+int srslte_pss_find_pss_all(srslte_pss_t* q, const cf_t* input, int peak_pos[3], float corr_peak_value[3])
+{
+  if (q == NULL || input == NULL || peak_pos == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  // Without FFT correlation, run the regular search for every sequence
+  if (q->frame_size < q->fft_size) {
+    uint32_t N_id_2 = q->N_id_2;
+    for (uint32_t n = 0; n < 3; n++) {
+      srslte_pss_reset(q);
+      srslte_pss_set_N_id_2(q, n);
+      peak_pos[n] = srslte_pss_find_pss(q, input, corr_peak_value ? &corr_peak_value[n] : NULL);
+    }
+    q->N_id_2 = N_id_2;
+    srslte_pss_reset(q);
+    return SRSLTE_SUCCESS;
+  }
+
+  const cf_t* conv_input = q->tmp_input;
+  memcpy(q->tmp_input, input, (q->frame_size * q->decimate) * sizeof(cf_t));
+  if (q->decimate > 1) {
+    srslte_filt_decim_cc_execute(&(q->filter),
+                                 q->tmp_input,
+                                 q->filter.downsampled_input,
+                                 q->filter.filter_output,
+                                 (q->frame_size * q->decimate));
+    conv_input = q->filter.filter_output;
+  }
+
+  // Single forward transform of the input
+  srslte_dft_run_c(&q->conv_fft.input_plan, conv_input, q->conv_fft.input_fft);
+  uint32_t conv_output_len = q->conv_fft.output_len - 1;
+
+  for (uint32_t n = 0; n < 3; n++) {
+    srslte_vec_prod_ccc(
+        q->conv_fft.input_fft, q->pss_signal_freq_full[n], q->conv_fft.output_fft, q->conv_fft.output_len);
+    srslte_dft_run_c(&q->conv_fft.output_plan, q->conv_fft.output_fft, q->conv_output);
+
+    srslte_vec_abs_square_cf(q->conv_output, q->conv_output_avg, conv_output_len - 1);
+    uint32_t corr_peak_pos = srslte_vec_max_fi(q->conv_output_avg, conv_output_len - 1);
+
+    if (corr_peak_value) {
+#ifdef SRSLTE_PSS_RETURN_PSR
+      corr_peak_value[n] = compute_peak_sidelobe(q, corr_peak_pos, conv_output_len);
+#else
+      corr_peak_value[n] = q->conv_output_avg[corr_peak_pos];
+#endif
+    }
+
+    if (q->decimate > 1) {
+      int decimation_correction = (q->filter.num_taps - 2);
+      corr_peak_pos             = corr_peak_pos - decimation_correction;
+      corr_peak_pos             = corr_peak_pos * q->decimate;
+    }
+    peak_pos[n] = (int)corr_peak_pos;
+  }
+
+  srslte_pss_reset(q);
+
+  return SRSLTE_SUCCESS;
+}
+
 /* Computes frequency-domain channel estimation of the PSS symbol
  * input signal is in the time-domain.
  * ce is the returned frequency-domain channel estimates.
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/phy/channel/ch_awgn.h"
+#include "srslte/phy/io/filesink.h"
+#include "srslte/phy/io/filesource.h"
+#include "srslte/phy/ue/ue_cell_search.h"
+#include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/vector.h"
+#include "srslte/srslte.h"
+#include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define MAX_EARFCN 32
+#define NOF_SF 20
+
+static uint32_t nof_earfcn  = 8;
+static uint32_t nof_threads = 4;
+static float    snr_dB      = 0.0f;
+static bool     prescan     = true;
+
+// Every EARFCN is stored in its own file, every other EARFCN carries a cell
+typedef struct {
+  char                filename[64];
+  int                 cell_id; // -1 if there is no cell
+  srslte_filesource_t source;
+  int                 nof_found;
+  int                 found_cell_id;
+} earfcn_t;
+
+static earfcn_t        earfcn[MAX_EARFCN] = {};
+static uint32_t        next_earfcn        = 0;
+static pthread_mutex_t earfcn_mutex       = PTHREAD_MUTEX_INITIALIZER;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [ntsdv]\n", prog);
+  printf("\t-n Number of EARFCN to scan [Default %d]\n", nof_earfcn);
+  printf("\t-t Number of scan threads [Default %d]\n", nof_threads);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr_dB);
+  printf("\t-d Disable batched PSS prescan\n");
+  printf("\t-v srslte_verbose\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ntsdv")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_earfcn = SRSLTE_MIN((uint32_t)strtol(argv[optind], NULL, 10), MAX_EARFCN);
+        break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_dB = strtof(argv[optind], NULL);
+        break;
+      case 'd':
+        prescan = false;
+        break;
+      case 'v':
+        srslte_verbose++;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Writes two radio frames at 1.92 MHz with PSS/SSS of the given cell (if any) plus AWGN
+static int generate_file(earfcn_t* e, uint32_t seed)
+{
+  int                   ret    = SRSLTE_ERROR;
+  uint32_t              sf_len = SRSLTE_SF_LEN_PRB(SRSLTE_CS_NOF_PRB);
+  cf_t*                 grid   = srslte_vec_cf_malloc(sf_len);
+  cf_t*                 signal = srslte_vec_cf_malloc(sf_len * NOF_SF);
+  srslte_ofdm_t         ifft   = {};
+  srslte_channel_awgn_t awgn   = {};
+  srslte_filesink_t     sink   = {};
+  cf_t                  pss[SRSLTE_PSS_LEN];
+  float                 sss0[SRSLTE_SSS_LEN];
+  float                 sss5[SRSLTE_SSS_LEN];
+
+  if (!grid || !signal) {
+    goto clean_exit;
+  }
+  if (srslte_ofdm_tx_init(&ifft, SRSLTE_CP_NORM, grid, signal, SRSLTE_CS_NOF_PRB)) {
+    goto clean_exit;
+  }
+
+  srslte_vec_cf_zero(signal, sf_len * NOF_SF);
+  if (e->cell_id >= 0) {
+    srslte_pss_generate(pss, (uint32_t)e->cell_id % 3);
+    srslte_sss_generate(sss0, sss5, (uint32_t)e->cell_id);
+    for (uint32_t sf = 0; sf < NOF_SF; sf += 5) {
+      srslte_vec_cf_zero(grid, sf_len);
+      srslte_pss_put_slot(pss, grid, SRSLTE_CS_NOF_PRB, SRSLTE_CP_NORM);
+      srslte_sss_put_slot(sf % 10 ? sss5 : sss0, grid, SRSLTE_CS_NOF_PRB, SRSLTE_CP_NORM);
+      srslte_ofdm_tx_sf(&ifft);
+      srslte_vec_cf_copy(&signal[sf * sf_len], signal, sf_len);
+    }
+
+    // Normalise the average power of the synchronization subframes
+    float scale = 1.0f / sqrtf(srslte_vec_avg_power_cf(&signal[5 * sf_len], sf_len));
+    srslte_vec_sc_prod_cfc(signal, scale, signal, sf_len * NOF_SF);
+  }
+
+  if (srslte_channel_awgn_init(&awgn, seed)) {
+    goto clean_exit;
+  }
+  srslte_channel_awgn_set_n0(&awgn, -snr_dB);
+  srslte_channel_awgn_run_c(&awgn, signal, signal, sf_len * NOF_SF);
+
+  if (srslte_filesink_init(&sink, e->filename, SRSLTE_COMPLEX_FLOAT_BIN)) {
+    goto clean_exit;
+  }
+  srslte_filesink_write(&sink, signal, sf_len * NOF_SF);
+  srslte_filesink_free(&sink);
+
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_channel_awgn_free(&awgn);
+  srslte_ofdm_tx_free(&ifft);
+  if (grid) {
+    free(grid);
+  }
+  if (signal) {
+    free(signal);
+  }
+  return ret;
+}
+
+// File based I/Q source, rewinds the file when it reaches the end
+static int file_recv(void* h, cf_t* data[SRSLTE_MAX_CHANNELS], uint32_t nsamples, srslte_timestamp_t* t)
+{
+  earfcn_t* e     = (earfcn_t*)h;
+  uint32_t  count = 0;
+
+  while (count < nsamples) {
+    int n = srslte_filesource_read(&e->source, &data[0][count], nsamples - count);
+    if (n < 0) {
+      return SRSLTE_ERROR;
+    }
+    if (n == 0) {
+      srslte_filesource_seek(&e->source, 0);
+    }
+    count += (uint32_t)n;
+  }
+
+  return (int)nsamples;
+}
+
+// Worker, takes EARFCN from the shared list until all of them have been scanned
+static void* scan_thread(void* arg)
+{
+  srslte_ue_cellsearch_result_t found_cells[3];
+  srslte_ue_cellsearch_t        cs;
+
+  while (true) {
+    pthread_mutex_lock(&earfcn_mutex);
+    uint32_t idx = next_earfcn++;
+    pthread_mutex_unlock(&earfcn_mutex);
+    if (idx >= nof_earfcn) {
+      break;
+    }
+
+    earfcn_t* e = &earfcn[idx];
+    if (srslte_filesource_init(&e->source, e->filename, SRSLTE_COMPLEX_FLOAT_BIN)) {
+      e->nof_found = SRSLTE_ERROR;
+      continue;
+    }
+    if (srslte_ue_cellsearch_init_multi(&cs, 8, file_recv, 1, e)) {
+      e->nof_found = SRSLTE_ERROR;
+      srslte_filesource_free(&e->source);
+      continue;
+    }
+    srslte_ue_cellsearch_set_nof_valid_frames(&cs, 4);
+    srslte_ue_cellsearch_set_prescan(&cs, prescan);
+
+    uint32_t max_N_id_2 = 0;
+    e->nof_found        = srslte_ue_cellsearch_scan(&cs, found_cells, &max_N_id_2);
+    e->found_cell_id    = e->nof_found > 0 ? (int)found_cells[max_N_id_2].cell_id : -1;
+
+    srslte_ue_cellsearch_free(&cs);
+    srslte_filesource_free(&e->source);
+  }
+
+  return NULL;
+}
+
+int main(int argc, char** argv)
+{
+  int            ret                 = SRSLTE_SUCCESS;
+  pthread_t      threads[MAX_EARFCN] = {};
+  struct timeval t[3]                = {};
+  uint32_t       nof_started         = 0;
+
+  parse_args(argc, argv);
+
+  for (uint32_t i = 0; i < nof_earfcn; i++) {
+    snprintf(earfcn[i].filename, sizeof(earfcn[i].filename), "ue_cell_search_test_%d.bin", i);
+    earfcn[i].cell_id = (i % 2 == 0) ? (int)(37 * i + 1) % 504 : -1;
+    if (generate_file(&earfcn[i], 1234 + i)) {
+      ERROR("Error generating I/Q file for EARFCN %d\n", i);
+      return SRSLTE_ERROR;
+    }
+  }
+
+  gettimeofday(&t[1], NULL);
+  for (uint32_t i = 0; i < SRSLTE_MAX(1, SRSLTE_MIN(nof_threads, MAX_EARFCN)); i++) {
+    if (pthread_create(&threads[i], NULL, scan_thread, NULL)) {
+      break;
+    }
+    nof_started++;
+  }
+  for (uint32_t i = 0; i < nof_started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  for (uint32_t i = 0; i < nof_earfcn; i++) {
+    printf("EARFCN %2d: cell_id=%3d; found=%d; found_cell_id=%3d\n",
+           i,
+           earfcn[i].cell_id,
+           earfcn[i].nof_found,
+           earfcn[i].found_cell_id);
+    if (earfcn[i].found_cell_id != earfcn[i].cell_id) {
+      ret = SRSLTE_ERROR;
+    }
+    unlink(earfcn[i].filename);
+  }
+
+  printf("Scanned %d EARFCN with %d threads in %.1f ms\n",
+         nof_earfcn,
+         nof_started,
+         t[0].tv_sec * 1e3 + t[0].tv_usec / 1e3);
+  printf("%s\n", ret == SRSLTE_SUCCESS ? "Ok" : "Failed");
+
+  return ret;
+}
@@ -252,6 +252,43 @@ static void get_cell(srslte_ue_cellsearch_t* q, uint32_t nof_detected_frames, sr
   found_cell->cfo = q->candidates[nof_detected_frames - 1].cfo;
 }
 
+void srslte_ue_cellsearch_set_prescan(srslte_ue_cellsearch_t* q, bool enable)
+{
+  q->prescan_enable = enable;
+}
+
+/* Receives a few 5 ms frames and correlates each of them with the three PSS sequences at once, using a single FFT per
+ * frame. Stores the best PSR of each N_id_2 in q->prescan_psr.
+ */
+static int ue_cellsearch_prescan(srslte_ue_cellsearch_t* q)
+{
+  srslte_timestamp_t ts                          = {};
+  cf_t*              buffer[SRSLTE_MAX_CHANNELS] = {};
+  int                peak_pos[3]                 = {};
+  float              psr[3]                      = {};
+
+  for (uint32_t i = 0; i < q->nof_rx_antennas; i++) {
+    buffer[i] = q->sf_buffer[i];
+  }
+
+  bzero(q->prescan_psr, sizeof(q->prescan_psr));
+  for (uint32_t f = 0; f < SRSLTE_CS_PRESCAN_FRAMES; f++) {
+    if (q->ue_sync.recv_callback(q->ue_sync.stream, buffer, q->ue_sync.frame_len, &ts) < 0) {
+      ERROR("Error receiving samples for cell search prescan\n");
+      return SRSLTE_ERROR;
+    }
+    if (srslte_pss_find_pss_all(&q->ue_sync.sfind.pss, q->sf_buffer[0], peak_pos, psr) < 0) {
+      ERROR("Error correlating PSS in cell search prescan\n");
+      return SRSLTE_ERROR;
+    }
+    for (uint32_t N_id_2 = 0; N_id_2 < 3; N_id_2++) {
+      q->prescan_psr[N_id_2] = SRSLTE_MAX(q->prescan_psr[N_id_2], psr[N_id_2]);
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 /** Finds up to 3 cells, one per each N_id_2=0,1,2 and stores ID and CP in the structure pointed by found_cell.
  * Each position in found_cell corresponds to a different N_id_2.
  * Saves in the pointer max_N_id_2 the N_id_2 index of the cell with the highest PSR
@@ -265,7 +302,17 @@ int srslte_ue_cellsearch_scan(srslte_ue_cellsearch_t*       q,
   float    max_peak_value     = -1.0;
   uint32_t nof_detected_cells = 0;
 
+  // Batched PSS search, the N_id_2 which never reach the detection threshold are not scanned
+  if (q->prescan_enable && ue_cellsearch_prescan(q) < SRSLTE_SUCCESS) {
+    return SRSLTE_ERROR;
+  }
+
   for (uint32_t N_id_2 = 0; N_id_2 < 3; N_id_2++) {
+    if (q->prescan_enable && q->prescan_psr[N_id_2] < q->ue_sync.sfind.threshold) {
+      INFO("CELL SEARCH: Skipping N_id_2=%d, prescan PSR=%.2f\n", N_id_2, q->prescan_psr[N_id_2]);
+      bzero(&found_cells[N_id_2], sizeof(srslte_ue_cellsearch_result_t));
+      continue;
+    }
     INFO("CELL SEARCH: Starting scan for N_id_2=%d\n", N_id_2);
     ret = srslte_ue_cellsearch_scan_N_id_2(q, N_id_2, &found_cells[N_id_2]);
     if (ret < 0) {
@@ -63,6 +63,35 @@ const static uint32_t mi_tdd_table[7][10] = {{2, 1, 0, 0, 0, 2, 1, 0, 0, 0},  //
         ? 3                                                                                                            \
         : 0))
 
+static int ue_dl_init_channels(srslte_ue_dl_t* q, uint32_t max_prb, uint32_t nof_rx_antennas)
+{
+  if (srslte_pcfich_init(&q->pcfich, nof_rx_antennas)) {
+    ERROR("Error creating PCFICH object\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_phich_init(&q->phich, nof_rx_antennas)) {
+    ERROR("Error creating PHICH object\n");
+    return SRSLTE_ERROR;
+  }
+
+  if (srslte_pdcch_init_ue(&q->pdcch, max_prb, nof_rx_antennas)) {
+    ERROR("Error creating PDCCH object\n");
+    return SRSLTE_ERROR;
+  }
+
+  if (srslte_pdsch_init_ue(&q->pdsch, max_prb, nof_rx_antennas)) {
+    ERROR("Error creating PDSCH object\n");
+    return SRSLTE_ERROR;
+  }
+
+  if (srslte_pmch_init(&q->pmch, max_prb, nof_rx_antennas)) {
+    ERROR("Error creating PMCH object\n");
+    return SRSLTE_ERROR;
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_ue_dl_init(srslte_ue_dl_t* q, cf_t* in_buffer[SRSLTE_MAX_PORTS], uint32_t max_prb, uint32_t nof_rx_antennas)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
@@ -119,27 +148,46 @@ int srslte_ue_dl_init(srslte_ue_dl_t* q, cf_t* in_buffer[SRSLTE_MAX_PORTS], uint
       ERROR("Error initiating channel estimator\n");
       goto clean_exit;
     }
-    if (srslte_pcfich_init(&q->pcfich, nof_rx_antennas)) {
-      ERROR("Error creating PCFICH object\n");
-      goto clean_exit;
-    }
-    if (srslte_phich_init(&q->phich, nof_rx_antennas)) {
-      ERROR("Error creating PHICH object\n");
+    if (ue_dl_init_channels(q, max_prb, nof_rx_antennas)) {
       goto clean_exit;
     }
 
-    if (srslte_pdcch_init_ue(&q->pdcch, max_prb, nof_rx_antennas)) {
-      ERROR("Error creating PDCCH object\n");
-      goto clean_exit;
-    }
+    ret = SRSLTE_SUCCESS;
+  } else {
+    ERROR("Invalid parameters\n");
+  }
 
-    if (srslte_pdsch_init_ue(&q->pdsch, max_prb, nof_rx_antennas)) {
-      ERROR("Error creating PDSCH object\n");
-      goto clean_exit;
+clean_exit:
+  if (ret == SRSLTE_ERROR) {
+    srslte_ue_dl_free(q);
+  }
+  return ret;
+}
+
+int srslte_ue_dl_init_shared(srslte_ue_dl_t* q, srslte_ue_dl_t* frontend, uint32_t max_prb)
+{
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+
+  if (q != NULL && frontend != NULL && frontend->shared_chest_res == NULL) {
+    ret = SRSLTE_ERROR;
+
+    bzero(q, sizeof(srslte_ue_dl_t));
+
+    q->pending_ul_dci_count = 0;
+    q->nof_rx_antennas      = frontend->nof_rx_antennas;
+    q->mi_auto              = true;
+    q->mi_manual_index      = 0;
+    q->pregen_rnti          = 0;
+
+    // Borrow the front-end demodulated symbols, the channel estimates are borrowed every subframe
+    q->shared_chest_res = &frontend->chest_res;
+    q->shared_cell      = &frontend->cell;
+    q->shared_sf_count  = &frontend->sf_count;
+    for (int j = 0; j < SRSLTE_MAX_PORTS; j++) {
+      q->sf_symbols[j] = frontend->sf_symbols[j];
     }
 
-    if (srslte_pmch_init(&q->pmch, max_prb, nof_rx_antennas)) {
-      ERROR("Error creating PMCH object\n");
+    if (ue_dl_init_channels(q, max_prb, q->nof_rx_antennas)) {
       goto clean_exit;
     }
 
@@ -158,12 +206,20 @@ clean_exit:
 void srslte_ue_dl_free(srslte_ue_dl_t* q)
 {
   if (q) {
-    for (int port = 0; port < SRSLTE_MAX_PORTS; port++) {
-      srslte_ofdm_rx_free(&q->fft[port]);
+    // Shared objects do not own the demodulator, estimator nor symbol buffers
+    if (q->shared_chest_res == NULL) {
+      for (int port = 0; port < SRSLTE_MAX_PORTS; port++) {
+        srslte_ofdm_rx_free(&q->fft[port]);
+      }
+      srslte_ofdm_rx_free(&q->fft_mbsfn);
+      srslte_chest_dl_free(&q->chest);
+      srslte_chest_dl_res_free(&q->chest_res);
+      for (int j = 0; j < SRSLTE_MAX_PORTS; j++) {
+        if (q->sf_symbols[j]) {
+          free(q->sf_symbols[j]);
+        }
+      }
     }
-    srslte_ofdm_rx_free(&q->fft_mbsfn);
-    srslte_chest_dl_free(&q->chest);
-    srslte_chest_dl_res_free(&q->chest_res);
     for (int i = 0; i < SRSLTE_MI_NOF_REGS; i++) {
       srslte_regs_free(&q->regs[i]);
     }
@@ -172,20 +228,39 @@ void srslte_ue_dl_free(srslte_ue_dl_t* q)
     srslte_pdcch_free(&q->pdcch);
     srslte_pdsch_free(&q->pdsch);
     srslte_pmch_free(&q->pmch);
-    for (int j = 0; j < SRSLTE_MAX_PORTS; j++) {
-      if (q->sf_symbols[j]) {
-        free(q->sf_symbols[j]);
-      }
-    }
     bzero(q, sizeof(srslte_ue_dl_t));
   }
 }
 
+/* Shared objects read the front-end symbols with their own REG mapping, so every cell parameter must match */
+static bool ue_dl_shared_cell_mismatch(const srslte_cell_t* frontend, const srslte_cell_t* cell)
+{
+  bool mismatch = false;
+#define UE_DL_CHECK_CELL_FIELD(FIELD)                                                                                  \
+  if (frontend->FIELD != cell->FIELD) {                                                                                \
+    ERROR("Cell " #FIELD "=%d does not match the front-end " #FIELD "=%d\n", (int)cell->FIELD, (int)frontend->FIELD);   \
+    mismatch = true;                                                                                                   \
+  }
+  UE_DL_CHECK_CELL_FIELD(nof_prb);
+  UE_DL_CHECK_CELL_FIELD(nof_ports);
+  UE_DL_CHECK_CELL_FIELD(id);
+  UE_DL_CHECK_CELL_FIELD(cp);
+  UE_DL_CHECK_CELL_FIELD(phich_length);
+  UE_DL_CHECK_CELL_FIELD(phich_resources);
+  UE_DL_CHECK_CELL_FIELD(frame_type);
+#undef UE_DL_CHECK_CELL_FIELD
+  return mismatch;
+}
+
 int srslte_ue_dl_set_cell(srslte_ue_dl_t* q, srslte_cell_t cell)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
 
   if (q != NULL && srslte_cell_isvalid(&cell)) {
+    if (q->shared_cell != NULL && ue_dl_shared_cell_mismatch(q->shared_cell, &cell)) {
+      return SRSLTE_ERROR;
+    }
+
     q->pending_ul_dci_count = 0;
 
     if (q->cell.id != cell.id || q->cell.nof_prb == 0) {
@@ -201,12 +276,6 @@ int srslte_ue_dl_set_cell(srslte_ue_dl_t* q, srslte_cell_t cell)
           return SRSLTE_ERROR;
         }
       }
-      for (int port = 0; port < q->nof_rx_antennas; port++) {
-        if (srslte_ofdm_rx_set_prb(&q->fft[port], q->cell.cp, q->cell.nof_prb)) {
-          ERROR("Error resizing FFT\n");
-          return SRSLTE_ERROR;
-        }
-      }
 
       // In TDD, initialize PDCCH and PHICH for the worst case: max ncces and phich groupds respectively
       uint32_t pdcch_init_reg = 0;
@@ -216,14 +285,24 @@ int srslte_ue_dl_set_cell(srslte_ue_dl_t* q, srslte_cell_t cell)
         phich_init_reg = 2; // mi=2
       }
 
-      if (srslte_ofdm_rx_set_prb(&q->fft_mbsfn, SRSLTE_CP_EXT, q->cell.nof_prb)) {
-        ERROR("Error resizing MBSFN FFT\n");
-        return SRSLTE_ERROR;
-      }
+      // The front-end of shared objects is configured separately
+      if (q->shared_chest_res == NULL) {
+        for (int port = 0; port < q->nof_rx_antennas; port++) {
+          if (srslte_ofdm_rx_set_prb(&q->fft[port], q->cell.cp, q->cell.nof_prb)) {
+            ERROR("Error resizing FFT\n");
+            return SRSLTE_ERROR;
+          }
+        }
 
-      if (srslte_chest_dl_set_cell(&q->chest, q->cell)) {
-        ERROR("Error resizing channel estimator\n");
-        return SRSLTE_ERROR;
+        if (srslte_ofdm_rx_set_prb(&q->fft_mbsfn, SRSLTE_CP_EXT, q->cell.nof_prb)) {
+          ERROR("Error resizing MBSFN FFT\n");
+          return SRSLTE_ERROR;
+        }
+
+        if (srslte_chest_dl_set_cell(&q->chest, q->cell)) {
+          ERROR("Error resizing channel estimator\n");
+          return SRSLTE_ERROR;
+        }
       }
       if (srslte_pcfich_set_cell(&q->pcfich, &q->regs[0], q->cell)) {
         ERROR("Error resizing PCFICH object\n");
@@ -261,7 +340,9 @@ int srslte_ue_dl_set_cell(srslte_ue_dl_t* q, srslte_cell_t cell)
 
 void srslte_ue_dl_set_non_mbsfn_region(srslte_ue_dl_t* q, uint8_t non_mbsfn_region_length)
 {
-  srslte_ofdm_set_non_mbsfn_region(&q->fft_mbsfn, non_mbsfn_region_length);
+  if (q->shared_chest_res == NULL) {
+    srslte_ofdm_set_non_mbsfn_region(&q->fft_mbsfn, non_mbsfn_region_length);
+  }
 }
 
 void srslte_ue_dl_set_mi_auto(srslte_ue_dl_t* q)
@@ -312,7 +393,7 @@ int srslte_ue_dl_set_mbsfn_area_id(srslte_ue_dl_t* q, uint16_t mbsfn_area_id)
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
   if (q != NULL) {
     ret = SRSLTE_ERROR;
-    if (srslte_chest_dl_set_mbsfn_area_id(&q->chest, mbsfn_area_id)) {
+    if (q->shared_chest_res == NULL && srslte_chest_dl_set_mbsfn_area_id(&q->chest, mbsfn_area_id)) {
       ERROR("Error setting MBSFN area ID \n");
       return ret;
     }
@@ -345,6 +426,17 @@ static void set_mi_value(srslte_ue_dl_t* q, srslte_dl_sf_cfg_t* sf, srslte_ue_dl
   }
 }
 
+/* Shared objects read the front-end buffers in place, so the front-end must not have demodulated another subframe
+ * while they were decoding */
+static int check_shared_frontend(srslte_ue_dl_t* q)
+{
+  if (q->shared_sf_count != NULL && *q->shared_sf_count != q->sf_count) {
+    ERROR("The front-end demodulated a new subframe while a shared object was decoding the previous one\n");
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
 static int estimate_pdcch_pcfich(srslte_ue_dl_t* q, srslte_dl_sf_cfg_t* sf, srslte_ue_dl_cfg_t* cfg)
 {
   if (q) {
@@ -353,8 +445,13 @@ static int estimate_pdcch_pcfich(srslte_ue_dl_t* q, srslte_dl_sf_cfg_t* sf, srsl
 
     set_mi_value(q, sf, cfg);
 
-    /* Get channel estimates for each port */
-    srslte_chest_dl_estimate_cfg(&q->chest, sf, &cfg->chest_cfg, q->sf_symbols, &q->chest_res);
+    /* Get channel estimates for each port, or take the ones of the front-end */
+    if (q->shared_chest_res) {
+      q->chest_res = *q->shared_chest_res;
+      q->sf_count  = *q->shared_sf_count;
+    } else {
+      srslte_chest_dl_estimate_cfg(&q->chest, sf, &cfg->chest_cfg, q->sf_symbols, &q->chest_res);
+    }
 
     /* First decode PCFICH and obtain CFI */
     if (srslte_pcfich_decode(&q->pcfich, sf, &q->chest_res, q->sf_symbols, &cfi_corr) < 0) {
@@ -383,13 +480,16 @@ static int estimate_pdcch_pcfich(srslte_ue_dl_t* q, srslte_dl_sf_cfg_t* sf, srsl
 int srslte_ue_dl_decode_fft_estimate(srslte_ue_dl_t* q, srslte_dl_sf_cfg_t* sf, srslte_ue_dl_cfg_t* cfg)
 {
   if (q) {
-    /* Run FFT for all subframe data */
-    for (int j = 0; j < q->nof_rx_antennas; j++) {
-      if (sf->sf_type == SRSLTE_SF_MBSFN) {
-        srslte_ofdm_rx_sf(&q->fft_mbsfn);
-      } else {
-        srslte_ofdm_rx_sf(&q->fft[j]);
+    /* Run FFT for all subframe data, shared objects reuse the front-end symbols */
+    if (q->shared_chest_res == NULL) {
+      for (int j = 0; j < q->nof_rx_antennas; j++) {
+        if (sf->sf_type == SRSLTE_SF_MBSFN) {
+          srslte_ofdm_rx_sf(&q->fft_mbsfn);
+        } else {
+          srslte_ofdm_rx_sf(&q->fft[j]);
+        }
       }
+      q->sf_count++;
     }
     return estimate_pdcch_pcfich(q, sf, cfg);
   } else {
@@ -402,7 +502,10 @@ int srslte_ue_dl_decode_fft_estimate_noguru(srslte_ue_dl_t*     q,
                                             srslte_ue_dl_cfg_t* cfg,
                                             cf_t*               input[SRSLTE_MAX_PORTS])
 {
-  if (q && input) {
+  if (q && q->shared_chest_res) {
+    ERROR("Shared objects do not run the FFT, call srslte_ue_dl_decode_fft_estimate() instead\n");
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  } else if (q && input) {
     /* Run FFT for all subframe data */
     for (int j = 0; j < q->nof_rx_antennas; j++) {
       if (sf->sf_type == SRSLTE_SF_MBSFN) {
@@ -411,6 +514,7 @@ int srslte_ue_dl_decode_fft_estimate_noguru(srslte_ue_dl_t*     q,
         srslte_ofdm_rx_sf_ng(&q->fft[j], input[j], q->sf_symbols[j]);
       }
     }
+    q->sf_count++;
     return estimate_pdcch_pcfich(q, sf, cfg);
   } else {
     return SRSLTE_ERROR_INVALID_INPUTS;
@@ -633,6 +737,10 @@ int srslte_ue_dl_find_ul_dci(srslte_ue_dl_t*     q,
       }
     }
 
+    if (check_shared_frontend(q)) {
+      return SRSLTE_ERROR;
+    }
+
     return nof_msg;
 
   } else {
@@ -726,6 +834,10 @@ int srslte_ue_dl_find_dl_dci(srslte_ue_dl_t*     q,
       return SRSLTE_ERROR;
     }
   }
+
+  if (check_shared_frontend(q)) {
+    return SRSLTE_ERROR;
+  }
   return nof_msg;
 }
 
@@ -743,7 +855,11 @@ int srslte_ue_dl_decode_pdsch(srslte_ue_dl_t*     q,
                               srslte_pdsch_cfg_t* pdsch_cfg,
                               srslte_pdsch_res_t  data[SRSLTE_MAX_CODEWORDS])
 {
-  return srslte_pdsch_decode(&q->pdsch, sf, pdsch_cfg, &q->chest_res, q->sf_symbols, data);
+  int ret = srslte_pdsch_decode(&q->pdsch, sf, pdsch_cfg, &q->chest_res, q->sf_symbols, data);
+  if (ret == SRSLTE_SUCCESS && check_shared_frontend(q)) {
+    ret = SRSLTE_ERROR;
+  }
+  return ret;
 }
 
 int srslte_ue_dl_decode_pmch(srslte_ue_dl_t*     q,
@@ -751,7 +867,11 @@ int srslte_ue_dl_decode_pmch(srslte_ue_dl_t*     q,
                              srslte_pmch_cfg_t*  pmch_cfg,
                              srslte_pdsch_res_t  data[SRSLTE_MAX_CODEWORDS])
 {
-  return srslte_pmch_decode(&q->pmch, sf, pmch_cfg, &q->chest_res, q->sf_symbols, &data[0]);
+  int ret = srslte_pmch_decode(&q->pmch, sf, pmch_cfg, &q->chest_res, q->sf_symbols, &data[0]);
+  if (ret == SRSLTE_SUCCESS && check_shared_frontend(q)) {
+    ret = SRSLTE_ERROR;
+  }
+  return ret;
 }
 
 int srslte_ue_dl_decode_phich(srslte_ue_dl_t*       q,
@@ -777,7 +897,8 @@ int srslte_ue_dl_decode_phich(srslte_ue_dl_t*       q,
        srslte_phich_ngroups(&q->phich),
        srslte_phich_nsf(&q->phich));
 
-  if (!srslte_phich_decode(&q->phich, sf, &q->chest_res, n_phich, q->sf_symbols, result)) {
+  if (!srslte_phich_decode(&q->phich, sf, &q->chest_res, n_phich, q->sf_symbols, result) &&
+      !check_shared_frontend(q)) {
     INFO("Decoded PHICH %d with distance %f\n", result->ack_value, result->distance);
     return 0;
   } else {
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srslte/phy/utils/isa.h"
+#include "srslte/phy/utils/vector.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+
+#define X86_CPUID_BASIC_LEAF 1
+#define X86_CPUID_ADVANCED_LEAF 7
+
+/* XCR0 state components the OS must save for the AVX and AVX-512 registers */
+#define XCR0_AVX_STATE 0x06
+#define XCR0_AVX512_STATE 0xe6
+
+static unsigned long long isa_xgetbv(void)
+{
+  unsigned int eax = 0, edx = 0;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return ((unsigned long long)edx << 32) | eax;
+}
+
+static srslte_isa_t isa_detect_cpu(void)
+{
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+  if (!__get_cpuid(X86_CPUID_BASIC_LEAF, &eax, &ebx, &ecx, &edx)) {
+    return SRSLTE_ISA_GENERIC;
+  }
+  if (!(ecx & bit_SSE4_1)) {
+    return SRSLTE_ISA_GENERIC;
+  }
+
+  // The wider registers are only usable if the OS saves them on context switches
+  bool has_fma = (ecx & bit_FMA) != 0;
+  if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX) || (isa_xgetbv() & XCR0_AVX_STATE) != XCR0_AVX_STATE) {
+    return SRSLTE_ISA_SSE;
+  }
+
+  if (__get_cpuid_max(0, NULL) < X86_CPUID_ADVANCED_LEAF) {
+    return SRSLTE_ISA_SSE;
+  }
+  __cpuid_count(X86_CPUID_ADVANCED_LEAF, 0, eax, ebx, ecx, edx);
+  if (!(ebx & bit_AVX2) || !has_fma) {
+    return SRSLTE_ISA_SSE;
+  }
+
+  const unsigned int avx512_bits = bit_AVX512F | bit_AVX512CD | bit_AVX512BW | bit_AVX512DQ;
+  if ((ebx & avx512_bits) != avx512_bits || (isa_xgetbv() & XCR0_AVX512_STATE) != XCR0_AVX512_STATE) {
+    return SRSLTE_ISA_AVX2;
+  }
+
+  return SRSLTE_ISA_AVX512;
+}
+#else  /* defined(__x86_64__) || defined(__i386__) */
+static srslte_isa_t isa_detect_cpu(void)
+{
+  return SRSLTE_ISA_GENERIC;
+}
+#endif /* defined(__x86_64__) || defined(__i386__) */
+
+static const char* isa_names[SRSLTE_ISA_NOF] = {"generic", "sse", "avx2", "avx512"};
+
+static pthread_once_t isa_once = PTHREAD_ONCE_INIT;
+static srslte_isa_t   isa_cpu  = SRSLTE_ISA_GENERIC;
+static srslte_isa_t   isa_best = SRSLTE_ISA_GENERIC;
+
+static void isa_init(void)
+{
+  isa_cpu  = isa_detect_cpu();
+  isa_best = SRSLTE_MIN(isa_cpu, srslte_isa_build());
+
+  const char* env = getenv("SRSLTE_ISA");
+  if (env) {
+    for (int i = 0; i < SRSLTE_ISA_NOF; i++) {
+      if (strcmp(env, isa_names[i]) == 0) {
+        isa_best = SRSLTE_MIN(isa_best, (srslte_isa_t)i);
+      }
+    }
+  }
+}
+
+srslte_isa_t srslte_isa_get(void)
+{
+  pthread_once(&isa_once, isa_init);
+  return isa_best;
+}
+
+srslte_isa_t srslte_isa_cpu(void)
+{
+  pthread_once(&isa_once, isa_init);
+  return isa_cpu;
+}
+
+srslte_isa_t srslte_isa_build(void)
+{
+#ifdef SRSLTE_ISA_DISPATCH
+#if defined(SRSLTE_ISA_DISPATCH_AVX512)
+  return SRSLTE_ISA_AVX512;
+#elif defined(SRSLTE_ISA_DISPATCH_AVX2)
+  return SRSLTE_ISA_AVX2;
+#else
+  return SRSLTE_ISA_SSE;
+#endif
+#else /* SRSLTE_ISA_DISPATCH */
+#if defined(LV_HAVE_AVX512)
+  return SRSLTE_ISA_AVX512;
+#elif defined(LV_HAVE_AVX2)
+  return SRSLTE_ISA_AVX2;
+#elif defined(LV_HAVE_SSE)
+  return SRSLTE_ISA_SSE;
+#else
+  return SRSLTE_ISA_GENERIC;
+#endif
+#endif /* SRSLTE_ISA_DISPATCH */
+}
+
+bool srslte_isa_is_supported(srslte_isa_t isa)
+{
+#ifdef SRSLTE_ISA_DISPATCH
+  // Every level up to the best one is built
+  return isa <= srslte_isa_build() && isa <= srslte_isa_cpu();
+#else  /* SRSLTE_ISA_DISPATCH */
+  // Only the level selected at compile time is built
+  return isa == srslte_isa_build() && isa <= srslte_isa_cpu();
+#endif /* SRSLTE_ISA_DISPATCH */
+}
+
+const char* srslte_isa_to_string(srslte_isa_t isa)
+{
+  return isa < SRSLTE_ISA_NOF ? isa_names[isa] : "unknown";
+}
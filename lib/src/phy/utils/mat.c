@@ -124,6 +124,66 @@ void srslte_mat_2x2_mmse_gen(cf_t  y0,
   srslte_mat_2x2_mmse_csi_gen(y0, y1, h00, h01, h10, h11, x0, x1, &csi0, &csi1, noise_estimate, norm);
 }
 
+/* Generic implementation for NxL Minimum Mean Squared Error (MMSE) solver */
+void srslte_mat_NxL_mmse_csi_gen(uint32_t nof_rx,
+                                 uint32_t nof_layers,
+                                 cf_t     y[SRSLTE_MAT_NxL_MAX],
+                                 cf_t     h[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX],
+                                 cf_t     x[SRSLTE_MAT_NxL_MAX],
+                                 float    csi[SRSLTE_MAT_NxL_MAX],
+                                 float    noise_estimate,
+                                 float    norm)
+{
+  cf_t a[SRSLTE_MAT_NxL_MAX][SRSLTE_MAT_NxL_MAX];
+  cf_t z[SRSLTE_MAT_NxL_MAX];
+
+  /* 1. A = H' x H + No and Z = H' x Y */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    for (uint32_t j = i; j < nof_layers; j++) {
+      cf_t acc = 0;
+      for (uint32_t r = 0; r < nof_rx; r++) {
+        acc += conjf(h[r][i]) * h[r][j];
+      }
+      a[i][j] = acc;
+      a[j][i] = conjf(acc);
+    }
+    a[i][i] = crealf(a[i][i]) + noise_estimate;
+
+    z[i] = 0;
+    for (uint32_t r = 0; r < nof_rx; r++) {
+      z[i] += conjf(h[r][i]) * y[r];
+    }
+  }
+
+  /* 2. B = inv(A), Gauss-Jordan elimination with the real pivots of A */
+  for (uint32_t k = 0; k < nof_layers; k++) {
+    float rcp = 1.0f / crealf(a[k][k]);
+    a[k][k]   = 1.0f;
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      a[k][j] *= rcp;
+    }
+    for (uint32_t i = 0; i < nof_layers; i++) {
+      if (i != k) {
+        cf_t f  = a[i][k];
+        a[i][k] = 0;
+        for (uint32_t j = 0; j < nof_layers; j++) {
+          a[i][j] -= f * a[k][j];
+        }
+      }
+    }
+  }
+
+  /* 3. X = B x Z and CSI = 1 / B(l, l) */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    cf_t acc = 0;
+    for (uint32_t j = 0; j < nof_layers; j++) {
+      acc += a[i][j] * z[j];
+    }
+    x[i]   = acc * norm;
+    csi[i] = 1.0f / (crealf(a[i][i]) * norm);
+  }
+}
+
 int srslte_mat_2x2_cn(cf_t h00, cf_t h01, cf_t h10, cf_t h11, float* cn)
 {
   // 1. A = H * H' (A = A')
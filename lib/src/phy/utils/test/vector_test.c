@@ -20,6 +20,7 @@
  */
 
 #include "srslte/srslte.h"
+#include "srslte/phy/utils/vector_simd.h"
 #include <srslte/phy/utils/random.h>
 
 bool zf_solver   = false;
@@ -290,6 +291,29 @@ TEST(
     free(x);
     free(y);)
 
+TEST(
+    srslte_vec_dot_prod_ccc_split, MALLOC(float, x_re); MALLOC(float, x_im); MALLOC(float, y_re); MALLOC(float, y_im);
+    cf_t z = 0.0f;
+
+    cf_t gold = 0.0f;
+    for (int i = 0; i < block_size; i++) {
+      x_re[i] = RANDOM_F();
+      x_im[i] = RANDOM_F();
+      y_re[i] = RANDOM_F();
+      y_im[i] = RANDOM_F();
+    }
+
+    TEST_CALL(z = srslte_vec_dot_prod_ccc_split(x_re, x_im, y_re, y_im, block_size))
+
+        for (int i = 0; i < block_size; i++) { gold += (x_re[i] + I * x_im[i]) * (y_re[i] + I * y_im[i]); }
+
+    mse = cabsf(gold - z) / cabsf(gold);
+
+    free(x_re);
+    free(x_im);
+    free(y_re);
+    free(y_im);)
+
 TEST(
     srslte_vec_dot_prod_conj_ccc, MALLOC(cf_t, x); MALLOC(cf_t, y); cf_t z = 0.0f;
 
@@ -375,6 +399,33 @@ TEST(
     free(y);
     free(z);)
 
+TEST(
+    srslte_vec_prod_conj_ccc_split, MALLOC(float, x_re); MALLOC(float, x_im); MALLOC(float, y_re); MALLOC(float, y_im);
+    MALLOC(float, z_re);
+    MALLOC(float, z_im);
+
+    cf_t gold;
+    for (int i = 0; i < block_size; i++) {
+      x_re[i] = RANDOM_F();
+      x_im[i] = RANDOM_F();
+      y_re[i] = RANDOM_F();
+      y_im[i] = RANDOM_F();
+    }
+
+    TEST_CALL(srslte_vec_prod_conj_ccc_split(x_re, x_im, y_re, y_im, z_re, z_im, block_size))
+
+        for (int i = 0; i < block_size; i++) {
+          gold = (x_re[i] + I * x_im[i]) * conjf(y_re[i] + I * y_im[i]);
+          mse += cabsf(gold - (z_re[i] + I * z_im[i]));
+        }
+
+    free(x_re);
+    free(x_im);
+    free(y_re);
+    free(y_im);
+    free(z_re);
+    free(z_im);)
+
 TEST(srslte_vec_sc_prod_ccc, MALLOC(cf_t, x); MALLOC(cf_t, z); cf_t y = RANDOM_CF();
 
      cf_t gold;
@@ -390,6 +441,27 @@ TEST(srslte_vec_sc_prod_ccc, MALLOC(cf_t, x); MALLOC(cf_t, z); cf_t y = RANDOM_C
      free(x);
      free(z);)
 
+TEST(srslte_vec_sc_prod_ccc_split, MALLOC(float, x_re); MALLOC(float, x_im); MALLOC(float, z_re); MALLOC(float, z_im);
+     cf_t h = RANDOM_CF();
+
+     cf_t gold;
+     for (int i = 0; i < block_size; i++) {
+       x_re[i] = RANDOM_F();
+       x_im[i] = RANDOM_F();
+     }
+
+     TEST_CALL(srslte_vec_sc_prod_ccc_split(x_re, x_im, h, z_re, z_im, block_size))
+
+         for (int i = 0; i < block_size; i++) {
+           gold = (x_re[i] + I * x_im[i]) * h;
+           mse += cabsf(gold - (z_re[i] + I * z_im[i]));
+         }
+
+     free(x_re);
+     free(x_im);
+     free(z_re);
+     free(z_im);)
+
 TEST(srslte_vec_convert_fi, MALLOC(float, x); MALLOC(short, z); float scale = 1000.0f;
 
      short gold;
@@ -541,6 +613,39 @@ TEST(srslte_vec_abs_square_cf, MALLOC(cf_t, x); MALLOC(float, z); float gold;
      free(x);
      free(z);)
 
+TEST(srslte_vec_abs_square_cf_split, MALLOC(float, x_re); MALLOC(float, x_im); MALLOC(float, z); float gold;
+
+     for (int i = 0; i < block_size; i++) {
+       x_re[i] = RANDOM_F();
+       x_im[i] = RANDOM_F();
+     }
+
+     TEST_CALL(srslte_vec_abs_square_cf_split(x_re, x_im, z, block_size))
+
+         for (int i = 0; i < block_size; i++) {
+           gold = x_re[i] * x_re[i] + x_im[i] * x_im[i];
+           mse += fabsf(gold - z[i]);
+         }
+
+     free(x_re);
+     free(x_im);
+     free(z);)
+
+TEST(srslte_vec_cf_to_split, MALLOC(cf_t, x); MALLOC(cf_t, z); srslte_cf_split_t y;
+     srslte_vec_cf_split_malloc(&y, block_size);
+
+     for (int i = 0; i < block_size; i++) { x[i] = RANDOM_CF(); }
+
+     TEST_CALL(srslte_vec_cf_to_split(x, y.re, y.im, block_size); srslte_vec_split_to_cf(y.re, y.im, z, block_size))
+
+         for (int i = 0; i < block_size; i++) {
+           mse += cabsf(x[i] - (y.re[i] + I * y.im[i])) + cabsf(x[i] - z[i]);
+         }
+
+     free(x);
+     free(z);
+     srslte_vec_cf_split_free(&y);)
+
 TEST(srslte_vec_sc_prod_cfc, MALLOC(cf_t, x); MALLOC(cf_t, z); cf_t gold; float h = RANDOM_F();
 
      for (int i = 0; i < block_size; i++) { x[i] = RANDOM_CF(); }
@@ -787,6 +892,21 @@ int main(int argc, char** argv)
     nof_repetitions = (uint32_t)strtol(argv[1], NULL, 10);
   }
 
+  // Optionally, run the kernels of a given instruction set
+  if (argc > 2) {
+    srslte_isa_t isa = SRSLTE_ISA_NOF;
+    for (int i = 0; i < SRSLTE_ISA_NOF; i++) {
+      if (strcmp(argv[2], srslte_isa_to_string((srslte_isa_t)i)) == 0) {
+        isa = (srslte_isa_t)i;
+      }
+    }
+    if (srslte_vec_simd_set_isa(isa) != SRSLTE_SUCCESS) {
+      printf("Instruction set '%s' not available in this CPU or build, skipping\n", argv[2]);
+      return SRSLTE_SUCCESS;
+    }
+  }
+  printf("Running the %s kernels\n", srslte_isa_to_string(srslte_vec_simd_get_isa()));
+
   for (uint32_t block_size = 1; block_size <= 1024 * 32; block_size *= 2) {
     func_count = 0;
 
@@ -834,6 +954,10 @@ int main(int argc, char** argv)
         test_srslte_vec_dot_prod_ccc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srslte_vec_dot_prod_ccc_split(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srslte_vec_dot_prod_conj_ccc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
@@ -870,10 +994,18 @@ int main(int argc, char** argv)
         test_srslte_vec_prod_conj_ccc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srslte_vec_prod_conj_ccc_split(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srslte_vec_sc_prod_ccc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srslte_vec_sc_prod_ccc_split(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srslte_vec_sc_prod_fff(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
@@ -886,6 +1018,14 @@ int main(int argc, char** argv)
         test_srslte_vec_abs_square_cf(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srslte_vec_abs_square_cf_split(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
+    passed[func_count][size_count] =
+        test_srslte_vec_cf_to_split(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srslte_vec_sc_prod_cfc(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
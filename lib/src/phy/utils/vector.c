@@ -436,6 +436,74 @@ void srslte_vec_prod_ccc_split(const float*   x_re,
   srslte_vec_prod_ccc_split_simd(x_re, x_im, y_re, y_im, z_re, z_im, len);
 }
 
+int srslte_vec_cf_split_malloc(srslte_cf_split_t* q, uint32_t size)
+{
+  q->re   = srslte_vec_f_malloc(size);
+  q->im   = srslte_vec_f_malloc(size);
+  q->size = size;
+  if (!q->re || !q->im) {
+    srslte_vec_cf_split_free(q);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_vec_cf_split_free(srslte_cf_split_t* q)
+{
+  if (q->re) {
+    free(q->re);
+  }
+  if (q->im) {
+    free(q->im);
+  }
+  memset(q, 0, sizeof(srslte_cf_split_t));
+}
+
+void srslte_vec_cf_to_split(const cf_t* x, float* z_re, float* z_im, const uint32_t len)
+{
+  srslte_vec_cf_to_split_simd(x, z_re, z_im, len);
+}
+
+void srslte_vec_split_to_cf(const float* x_re, const float* x_im, cf_t* z, const uint32_t len)
+{
+  srslte_vec_split_to_cf_simd(x_re, x_im, z, len);
+}
+
+void srslte_vec_prod_conj_ccc_split(const float*   x_re,
+                                    const float*   x_im,
+                                    const float*   y_re,
+                                    const float*   y_im,
+                                    float*         z_re,
+                                    float*         z_im,
+                                    const uint32_t len)
+{
+  srslte_vec_prod_conj_ccc_split_simd(x_re, x_im, y_re, y_im, z_re, z_im, len);
+}
+
+void srslte_vec_sc_prod_ccc_split(const float*   x_re,
+                                  const float*   x_im,
+                                  const cf_t     h,
+                                  float*         z_re,
+                                  float*         z_im,
+                                  const uint32_t len)
+{
+  srslte_vec_sc_prod_ccc_split_simd(x_re, x_im, h, z_re, z_im, len);
+}
+
+void srslte_vec_abs_square_cf_split(const float* x_re, const float* x_im, float* z, const uint32_t len)
+{
+  srslte_vec_abs_square_cf_split_simd(x_re, x_im, z, len);
+}
+
+cf_t srslte_vec_dot_prod_ccc_split(const float*   x_re,
+                                   const float*   x_im,
+                                   const float*   y_re,
+                                   const float*   y_im,
+                                   const uint32_t len)
+{
+  return srslte_vec_dot_prod_ccc_split_simd(x_re, x_im, y_re, y_im, len);
+}
+
 // PRACH, CHEST UL, etc.
 void srslte_vec_prod_conj_ccc(const cf_t* x, const cf_t* y, cf_t* z, const uint32_t len)
 {
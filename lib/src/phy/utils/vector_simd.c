@@ -19,6 +19,11 @@
  *
  */
 
+#ifdef SRSLTE_VEC_SIMD_SUFFIX
+/* Built once per instruction set by the runtime ISA dispatch, see vector_simd_dispatch.c */
+#include "vector_simd_isa.h"
+#endif /* SRSLTE_VEC_SIMD_SUFFIX */
+
 #include <complex.h>
 #include <inttypes.h>
 #include <math.h>
@@ -972,6 +977,200 @@ void srslte_vec_prod_ccc_split_simd(const float* a_re,
   }
 }
 
+void srslte_vec_prod_conj_ccc_split_simd(const float* a_re,
+                                         const float* a_im,
+                                         const float* b_re,
+                                         const float* b_im,
+                                         float*       r_re,
+                                         float*       r_im,
+                                         const int    len)
+{
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE
+  if (SRSLTE_IS_ALIGNED(a_re) && SRSLTE_IS_ALIGNED(a_im) && SRSLTE_IS_ALIGNED(b_re) && SRSLTE_IS_ALIGNED(b_im) &&
+      SRSLTE_IS_ALIGNED(r_re) && SRSLTE_IS_ALIGNED(r_im)) {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      simd_cf_t a = srslte_simd_cf_load(&a_re[i], &a_im[i]);
+      simd_cf_t b = srslte_simd_cf_load(&b_re[i], &b_im[i]);
+
+      simd_cf_t r = srslte_simd_cf_conjprod(a, b);
+
+      srslte_simd_cf_store(&r_re[i], &r_im[i], r);
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      simd_cf_t a = srslte_simd_cf_loadu(&a_re[i], &a_im[i]);
+      simd_cf_t b = srslte_simd_cf_loadu(&b_re[i], &b_im[i]);
+
+      simd_cf_t r = srslte_simd_cf_conjprod(a, b);
+
+      srslte_simd_cf_storeu(&r_re[i], &r_im[i], r);
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    r_re[i] = a_re[i] * b_re[i] + a_im[i] * b_im[i];
+    r_im[i] = a_im[i] * b_re[i] - a_re[i] * b_im[i];
+  }
+}
+
+void srslte_vec_sc_prod_ccc_split_simd(const float* x_re,
+                                       const float* x_im,
+                                       const cf_t   h,
+                                       float*       z_re,
+                                       float*       z_im,
+                                       const int    len)
+{
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE
+  const simd_cf_t _h = srslte_simd_cf_set1(h);
+
+  if (SRSLTE_IS_ALIGNED(x_re) && SRSLTE_IS_ALIGNED(x_im) && SRSLTE_IS_ALIGNED(z_re) && SRSLTE_IS_ALIGNED(z_im)) {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      simd_cf_t x = srslte_simd_cf_load(&x_re[i], &x_im[i]);
+
+      srslte_simd_cf_store(&z_re[i], &z_im[i], srslte_simd_cf_prod(x, _h));
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      simd_cf_t x = srslte_simd_cf_loadu(&x_re[i], &x_im[i]);
+
+      srslte_simd_cf_storeu(&z_re[i], &z_im[i], srslte_simd_cf_prod(x, _h));
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    float re = x_re[i] * __real__ h - x_im[i] * __imag__ h;
+    z_im[i]  = x_re[i] * __imag__ h + x_im[i] * __real__ h;
+    z_re[i]  = re;
+  }
+}
+
+void srslte_vec_abs_square_cf_split_simd(const float* x_re, const float* x_im, float* z, const int len)
+{
+  int i = 0;
+
+#if SRSLTE_SIMD_F_SIZE
+  if (SRSLTE_IS_ALIGNED(x_re) && SRSLTE_IS_ALIGNED(x_im) && SRSLTE_IS_ALIGNED(z)) {
+    for (; i < len - SRSLTE_SIMD_F_SIZE + 1; i += SRSLTE_SIMD_F_SIZE) {
+      simd_f_t re = srslte_simd_f_load(&x_re[i]);
+      simd_f_t im = srslte_simd_f_load(&x_im[i]);
+
+      srslte_simd_f_store(&z[i], srslte_simd_f_add(srslte_simd_f_mul(re, re), srslte_simd_f_mul(im, im)));
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_F_SIZE + 1; i += SRSLTE_SIMD_F_SIZE) {
+      simd_f_t re = srslte_simd_f_loadu(&x_re[i]);
+      simd_f_t im = srslte_simd_f_loadu(&x_im[i]);
+
+      srslte_simd_f_storeu(&z[i], srslte_simd_f_add(srslte_simd_f_mul(re, re), srslte_simd_f_mul(im, im)));
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z[i] = x_re[i] * x_re[i] + x_im[i] * x_im[i];
+  }
+}
+
+cf_t srslte_vec_dot_prod_ccc_split_simd(const float* x_re,
+                                        const float* x_im,
+                                        const float* y_re,
+                                        const float* y_im,
+                                        const int    len)
+{
+  int  i      = 0;
+  cf_t result = 0;
+
+#if SRSLTE_SIMD_CF_SIZE
+  if (len >= SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t simd_result = srslte_simd_cf_zero();
+    if (SRSLTE_IS_ALIGNED(x_re) && SRSLTE_IS_ALIGNED(x_im) && SRSLTE_IS_ALIGNED(y_re) && SRSLTE_IS_ALIGNED(y_im)) {
+      for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+        simd_cf_t xVal = srslte_simd_cf_load(&x_re[i], &x_im[i]);
+        simd_cf_t yVal = srslte_simd_cf_load(&y_re[i], &y_im[i]);
+
+        simd_result = srslte_simd_cf_add(srslte_simd_cf_prod(xVal, yVal), simd_result);
+      }
+    } else {
+      for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+        simd_cf_t xVal = srslte_simd_cf_loadu(&x_re[i], &x_im[i]);
+        simd_cf_t yVal = srslte_simd_cf_loadu(&y_re[i], &y_im[i]);
+
+        simd_result = srslte_simd_cf_add(srslte_simd_cf_prod(xVal, yVal), simd_result);
+      }
+    }
+
+    __attribute__((aligned(64))) float simd_dotProdVector[SRSLTE_SIMD_CF_SIZE];
+    simd_f_t                           acc_re = srslte_simd_cf_re(simd_result);
+    simd_f_t                           acc_im = srslte_simd_cf_im(simd_result);
+
+    simd_f_t acc = srslte_simd_f_hadd(acc_re, acc_im);
+    for (int j = 2; j < SRSLTE_SIMD_F_SIZE; j *= 2) {
+      acc = srslte_simd_f_hadd(acc, acc);
+    }
+    srslte_simd_f_store(simd_dotProdVector, acc);
+    __real__ result = simd_dotProdVector[0];
+    __imag__ result = simd_dotProdVector[1];
+  }
+#endif
+
+  for (; i < len; i++) {
+    __real__ result += x_re[i] * y_re[i] - x_im[i] * y_im[i];
+    __imag__ result += x_re[i] * y_im[i] + x_im[i] * y_re[i];
+  }
+
+  return result;
+}
+
+void srslte_vec_cf_to_split_simd(const cf_t* x, float* z_re, float* z_im, const int len)
+{
+  int i = 0;
+
+#if SRSLTE_SIMD_CF_SIZE
+  if (SRSLTE_IS_ALIGNED(x) && SRSLTE_IS_ALIGNED(z_re) && SRSLTE_IS_ALIGNED(z_im)) {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      srslte_simd_cf_store(&z_re[i], &z_im[i], srslte_simd_cf_cfi_to_split(srslte_simd_cfi_load(&x[i])));
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      srslte_simd_cf_storeu(&z_re[i], &z_im[i], srslte_simd_cf_cfi_to_split(srslte_simd_cfi_loadu(&x[i])));
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    z_re[i] = __real__ x[i];
+    z_im[i] = __imag__ x[i];
+  }
+}
+
+void srslte_vec_split_to_cf_simd(const float* x_re, const float* x_im, cf_t* z, const int len)
+{
+  int i = 0;
+
+#if SRSLTE_SIMD_CF_SIZE
+  if (SRSLTE_IS_ALIGNED(x_re) && SRSLTE_IS_ALIGNED(x_im) && SRSLTE_IS_ALIGNED(z)) {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      srslte_simd_cfi_store(&z[i], srslte_simd_cf_split_to_cfi(srslte_simd_cf_load(&x_re[i], &x_im[i])));
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+      srslte_simd_cfi_storeu(&z[i], srslte_simd_cf_split_to_cfi(srslte_simd_cf_loadu(&x_re[i], &x_im[i])));
+    }
+  }
+#endif
+
+  for (; i < len; i++) {
+    __real__ z[i] = x_re[i];
+    __imag__ z[i] = x_im[i];
+  }
+}
+
 #ifdef ENABLE_C16
 void srslte_vec_prod_ccc_c16_simd(const int16_t* a_re,
                                   const int16_t* a_im,
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Runtime selection of the SIMD vector kernels. With ENABLE_ISA_DISPATCH,
+ * vector_simd.c is built once per instruction set, each build suffixing its
+ * kernels (_gen, _sse, _avx2 and _avx512). The srslte_vec_*_simd functions
+ * below forward the calls to the variant selected from CPUID at start-up.
+ */
+
+#include "srslte/phy/utils/vector_simd.h"
+#include "srslte/phy/utils/isa.h"
+
+#ifdef SRSLTE_ISA_DISPATCH
+
+#include "vector_simd_isa.h"
+
+typedef struct {
+#define VEC_SIMD_FIELD_V(NAME, PARAMS, ARGS) void(*NAME) PARAMS;
+#define VEC_SIMD_FIELD_R(TYPE, NAME, PARAMS, ARGS) TYPE(*NAME) PARAMS;
+  SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_FIELD_V, VEC_SIMD_FIELD_R)
+} vec_simd_table_t;
+
+#define VEC_SIMD_DECLARE_V(NAME, PARAMS, ARGS) void SRSLTE_VEC_SIMD_NAME(NAME) PARAMS;
+#define VEC_SIMD_DECLARE_R(TYPE, NAME, PARAMS, ARGS) TYPE SRSLTE_VEC_SIMD_NAME(NAME) PARAMS;
+#define VEC_SIMD_ENTRY_V(NAME, PARAMS, ARGS) SRSLTE_VEC_SIMD_NAME(NAME),
+#define VEC_SIMD_ENTRY_R(TYPE, NAME, PARAMS, ARGS) SRSLTE_VEC_SIMD_NAME(NAME),
+
+#define SRSLTE_VEC_SIMD_SUFFIX _gen
+SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_DECLARE_V, VEC_SIMD_DECLARE_R)
+static const vec_simd_table_t vec_simd_gen = {SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_ENTRY_V, VEC_SIMD_ENTRY_R)};
+#undef SRSLTE_VEC_SIMD_SUFFIX
+
+#define SRSLTE_VEC_SIMD_SUFFIX _sse
+SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_DECLARE_V, VEC_SIMD_DECLARE_R)
+static const vec_simd_table_t vec_simd_sse = {SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_ENTRY_V, VEC_SIMD_ENTRY_R)};
+#undef SRSLTE_VEC_SIMD_SUFFIX
+
+#ifdef SRSLTE_ISA_DISPATCH_AVX2
+#define SRSLTE_VEC_SIMD_SUFFIX _avx2
+SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_DECLARE_V, VEC_SIMD_DECLARE_R)
+static const vec_simd_table_t vec_simd_avx2 = {SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_ENTRY_V, VEC_SIMD_ENTRY_R)};
+#undef SRSLTE_VEC_SIMD_SUFFIX
+#endif /* SRSLTE_ISA_DISPATCH_AVX2 */
+
+#ifdef SRSLTE_ISA_DISPATCH_AVX512
+#define SRSLTE_VEC_SIMD_SUFFIX _avx512
+SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_DECLARE_V, VEC_SIMD_DECLARE_R)
+static const vec_simd_table_t vec_simd_avx512 = {SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_ENTRY_V, VEC_SIMD_ENTRY_R)};
+#undef SRSLTE_VEC_SIMD_SUFFIX
+#endif /* SRSLTE_ISA_DISPATCH_AVX512 */
+
+static const vec_simd_table_t* vec_simd_tables[SRSLTE_ISA_NOF] = {&vec_simd_gen,
+                                                                  &vec_simd_sse,
+#ifdef SRSLTE_ISA_DISPATCH_AVX2
+                                                                  &vec_simd_avx2,
+#else  /* SRSLTE_ISA_DISPATCH_AVX2 */
+                                                                  NULL,
+#endif /* SRSLTE_ISA_DISPATCH_AVX2 */
+#ifdef SRSLTE_ISA_DISPATCH_AVX512
+                                                                  &vec_simd_avx512
+#else  /* SRSLTE_ISA_DISPATCH_AVX512 */
+                                                                  NULL
+#endif /* SRSLTE_ISA_DISPATCH_AVX512 */
+};
+
+// The baseline variant serves any call made before the constructor below has run
+static srslte_isa_t            vec_simd_isa = SRSLTE_ISA_SSE;
+static const vec_simd_table_t* vec_simd     = &vec_simd_sse;
+
+__attribute__((constructor)) static void vec_simd_init(void)
+{
+  srslte_vec_simd_set_isa(srslte_isa_get());
+}
+
+int srslte_vec_simd_set_isa(srslte_isa_t isa)
+{
+  if (!srslte_isa_is_supported(isa) || vec_simd_tables[isa] == NULL) {
+    return SRSLTE_ERROR;
+  }
+  vec_simd_isa = isa;
+  vec_simd     = vec_simd_tables[isa];
+  return SRSLTE_SUCCESS;
+}
+
+srslte_isa_t srslte_vec_simd_get_isa(void)
+{
+  return vec_simd_isa;
+}
+
+#define VEC_SIMD_FORWARD_V(NAME, PARAMS, ARGS)                                                                         \
+  void NAME PARAMS { vec_simd->NAME ARGS; }
+#define VEC_SIMD_FORWARD_R(TYPE, NAME, PARAMS, ARGS)                                                                   \
+  TYPE NAME PARAMS { return vec_simd->NAME ARGS; }
+SRSLTE_VEC_SIMD_FUNCTIONS(VEC_SIMD_FORWARD_V, VEC_SIMD_FORWARD_R)
+
+#else /* SRSLTE_ISA_DISPATCH */
+
+// Without the runtime dispatch, only the instruction set selected at compile time is built
+int srslte_vec_simd_set_isa(srslte_isa_t isa)
+{
+  return isa == srslte_isa_build() && srslte_isa_is_supported(isa) ? SRSLTE_SUCCESS : SRSLTE_ERROR;
+}
+
+srslte_isa_t srslte_vec_simd_get_isa(void)
+{
+  return srslte_isa_build();
+}
+
+#endif /* SRSLTE_ISA_DISPATCH */
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         vector_simd_isa.h
+ *
+ *  Description:  List of the SIMD vector kernels built once per instruction set
+ *                when the runtime ISA dispatch is enabled. vector_simd.c
+ *                includes it first, so every kernel gets the suffix of the
+ *                variant being built (e.g. srslte_vec_prod_ccc_simd_avx2).
+ *
+ *  Reference:
+ *****************************************************************************/
+
+#ifndef SRSLTE_VECTOR_SIMD_ISA_H
+#define SRSLTE_VECTOR_SIMD_ISA_H
+
+#define SRSLTE_VEC_SIMD_NAME__(NAME, SUFFIX) NAME##SUFFIX
+#define SRSLTE_VEC_SIMD_NAME_(NAME, SUFFIX) SRSLTE_VEC_SIMD_NAME__(NAME, SUFFIX)
+#define SRSLTE_VEC_SIMD_NAME(NAME) SRSLTE_VEC_SIMD_NAME_(NAME, SRSLTE_VEC_SIMD_SUFFIX)
+
+/* Kernels returning void are listed with V(name, params, args) and the rest with R(type, name, params, args) */
+#define SRSLTE_VEC_SIMD_FUNCTIONS(V, R)                                                                                \
+  V(srslte_vec_xor_bbb_simd, (const int8_t* x, const int8_t* y, int8_t* z, int len), (x, y, z, len))                  \
+  V(srslte_vec_sum_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, int len), (x, y, z, len))               \
+  V(srslte_vec_sub_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, int len), (x, y, z, len))               \
+  V(srslte_vec_sub_bbb_simd, (const int8_t* x, const int8_t* y, int8_t* z, int len), (x, y, z, len))                  \
+  R(float, srslte_vec_acc_ff_simd, (const float* x, int len), (x, len))                                               \
+  R(cf_t, srslte_vec_acc_cc_simd, (const cf_t* x, int len), (x, len))                                                 \
+  V(srslte_vec_add_fff_simd, (const float* x, const float* y, float* z, int len), (x, y, z, len))                     \
+  V(srslte_vec_sub_fff_simd, (const float* x, const float* y, float* z, int len), (x, y, z, len))                     \
+  V(srslte_vec_sc_prod_cfc_simd, (const cf_t* x, const float h, cf_t* y, const int len), (x, h, y, len))              \
+  V(srslte_vec_sc_prod_fff_simd, (const float* x, const float h, float* z, const int len), (x, h, z, len))            \
+  V(srslte_vec_sc_prod_ccc_simd, (const cf_t* x, const cf_t h, cf_t* z, const int len), (x, h, z, len))               \
+  R(int, srslte_vec_sc_prod_ccc_simd2, (const cf_t* x, const cf_t h, cf_t* z, const int len), (x, h, z, len))         \
+  V(srslte_vec_prod_ccc_split_simd,                                                                                    \
+    (const float* a_re, const float* a_im, const float* b_re, const float* b_im, float* r_re, float* r_im, int len),   \
+    (a_re, a_im, b_re, b_im, r_re, r_im, len))                                                                         \
+  V(srslte_vec_prod_conj_ccc_split_simd,                                                                               \
+    (const float* a_re, const float* a_im, const float* b_re, const float* b_im, float* r_re, float* r_im, int len),   \
+    (a_re, a_im, b_re, b_im, r_re, r_im, len))                                                                         \
+  V(srslte_vec_sc_prod_ccc_split_simd,                                                                                 \
+    (const float* x_re, const float* x_im, const cf_t h, float* z_re, float* z_im, int len),                           \
+    (x_re, x_im, h, z_re, z_im, len))                                                                                  \
+  V(srslte_vec_abs_square_cf_split_simd,                                                                               \
+    (const float* x_re, const float* x_im, float* z, int len),                                                         \
+    (x_re, x_im, z, len))                                                                                              \
+  R(cf_t,                                                                                                              \
+    srslte_vec_dot_prod_ccc_split_simd,                                                                                \
+    (const float* x_re, const float* x_im, const float* y_re, const float* y_im, int len),                             \
+    (x_re, x_im, y_re, y_im, len))                                                                                     \
+  V(srslte_vec_cf_to_split_simd, (const cf_t* x, float* z_re, float* z_im, int len), (x, z_re, z_im, len))            \
+  V(srslte_vec_split_to_cf_simd, (const float* x_re, const float* x_im, cf_t* z, int len), (x_re, x_im, z, len))      \
+  V(srslte_vec_prod_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, const int len), (x, y, z, len))        \
+  V(srslte_vec_neg_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, const int len), (x, y, z, len))         \
+  V(srslte_vec_neg_bbb_simd, (const int8_t* x, const int8_t* y, int8_t* z, const int len), (x, y, z, len))            \
+  V(srslte_vec_prod_cfc_simd, (const cf_t* x, const float* y, cf_t* z, const int len), (x, y, z, len))                \
+  V(srslte_vec_prod_fff_simd, (const float* x, const float* y, float* z, const int len), (x, y, z, len))              \
+  V(srslte_vec_prod_ccc_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))                 \
+  V(srslte_vec_prod_conj_ccc_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))            \
+  V(srslte_vec_div_ccc_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))                  \
+  V(srslte_vec_div_cfc_simd, (const cf_t* x, const float* y, cf_t* z, const int len), (x, y, z, len))                 \
+  V(srslte_vec_div_fff_simd, (const float* x, const float* y, float* z, const int len), (x, y, z, len))               \
+  R(cf_t, srslte_vec_dot_prod_conj_ccc_simd, (const cf_t* x, const cf_t* y, const int len), (x, y, len))              \
+  R(cf_t, srslte_vec_dot_prod_ccc_simd, (const cf_t* x, const cf_t* y, const int len), (x, y, len))                   \
+  R(int, srslte_vec_dot_prod_sss_simd, (const int16_t* x, const int16_t* y, const int len), (x, y, len))              \
+  V(srslte_vec_abs_cf_simd, (const cf_t* x, float* z, const int len), (x, z, len))                                    \
+  V(srslte_vec_abs_square_cf_simd, (const cf_t* x, float* z, const int len), (x, z, len))                             \
+  V(srslte_vec_lut_sss_simd, (const short* x, const unsigned short* lut, short* y, const int len), (x, lut, y, len))   \
+  V(srslte_vec_lut_bbb_simd, (const int8_t* x, const unsigned short* lut, int8_t* y, const int len), (x, lut, y, len)) \
+  V(srslte_vec_convert_if_simd, (const int16_t* x, float* z, const float scale, const int len), (x, z, scale, len))   \
+  V(srslte_vec_convert_fi_simd, (const float* x, int16_t* z, const float scale, const int len), (x, z, scale, len))   \
+  V(srslte_vec_convert_conj_cs_simd, (const cf_t* x, int16_t* z, const float scale, const int len), (x, z, scale, len)) \
+  V(srslte_vec_convert_fb_simd, (const float* x, int8_t* z, const float scale, const int len), (x, z, scale, len))    \
+  V(srslte_vec_interleave_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))               \
+  V(srslte_vec_interleave_add_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))           \
+  V(srslte_vec_gen_sine_simd, (cf_t amplitude, float freq, cf_t* z, int len), (amplitude, freq, z, len))              \
+  V(srslte_vec_apply_cfo_simd, (const cf_t* x, float cfo, cf_t* z, int len), (x, cfo, z, len))                        \
+  R(float, srslte_vec_estimate_frequency_simd, (const cf_t* x, int len), (x, len))                                    \
+  R(uint32_t, srslte_vec_max_fi_simd, (const float* x, const int len), (x, len))                                      \
+  R(uint32_t, srslte_vec_max_abs_fi_simd, (const float* x, const int len), (x, len))                                  \
+  R(uint32_t, srslte_vec_max_ci_simd, (const cf_t* x, const int len), (x, len))
+
+#ifdef SRSLTE_VEC_SIMD_SUFFIX
+
+#ifdef ENABLE_C16
+#error "The C16 kernels are not supported by the runtime ISA dispatch"
+#endif /* ENABLE_C16 */
+
+#ifdef SRSLTE_VEC_SIMD_GENERIC
+/* The generic variant must not use any SIMD extension */
+#undef LV_HAVE_SSE
+#undef LV_HAVE_AVX
+#undef LV_HAVE_AVX2
+#undef LV_HAVE_FMA
+#undef LV_HAVE_AVX512
+#endif /* SRSLTE_VEC_SIMD_GENERIC */
+
+#define srslte_vec_xor_bbb_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_xor_bbb_simd)
+#define srslte_vec_sum_sss_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sum_sss_simd)
+#define srslte_vec_sub_sss_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sub_sss_simd)
+#define srslte_vec_sub_bbb_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sub_bbb_simd)
+#define srslte_vec_acc_ff_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_acc_ff_simd)
+#define srslte_vec_acc_cc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_acc_cc_simd)
+#define srslte_vec_add_fff_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_add_fff_simd)
+#define srslte_vec_sub_fff_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sub_fff_simd)
+#define srslte_vec_sc_prod_cfc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sc_prod_cfc_simd)
+#define srslte_vec_sc_prod_fff_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sc_prod_fff_simd)
+#define srslte_vec_sc_prod_ccc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sc_prod_ccc_simd)
+#define srslte_vec_sc_prod_ccc_simd2 SRSLTE_VEC_SIMD_NAME(srslte_vec_sc_prod_ccc_simd2)
+#define srslte_vec_prod_ccc_split_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_ccc_split_simd)
+#define srslte_vec_prod_conj_ccc_split_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_conj_ccc_split_simd)
+#define srslte_vec_sc_prod_ccc_split_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_sc_prod_ccc_split_simd)
+#define srslte_vec_abs_square_cf_split_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_abs_square_cf_split_simd)
+#define srslte_vec_dot_prod_ccc_split_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_dot_prod_ccc_split_simd)
+#define srslte_vec_cf_to_split_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_cf_to_split_simd)
+#define srslte_vec_split_to_cf_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_split_to_cf_simd)
+#define srslte_vec_prod_sss_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_sss_simd)
+#define srslte_vec_neg_sss_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_neg_sss_simd)
+#define srslte_vec_neg_bbb_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_neg_bbb_simd)
+#define srslte_vec_prod_cfc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_cfc_simd)
+#define srslte_vec_prod_fff_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_fff_simd)
+#define srslte_vec_prod_ccc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_ccc_simd)
+#define srslte_vec_prod_conj_ccc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_prod_conj_ccc_simd)
+#define srslte_vec_div_ccc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_div_ccc_simd)
+#define srslte_vec_div_cfc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_div_cfc_simd)
+#define srslte_vec_div_fff_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_div_fff_simd)
+#define srslte_vec_dot_prod_conj_ccc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_dot_prod_conj_ccc_simd)
+#define srslte_vec_dot_prod_ccc_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_dot_prod_ccc_simd)
+#define srslte_vec_dot_prod_sss_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_dot_prod_sss_simd)
+#define srslte_vec_abs_cf_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_abs_cf_simd)
+#define srslte_vec_abs_square_cf_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_abs_square_cf_simd)
+#define srslte_vec_lut_sss_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_lut_sss_simd)
+#define srslte_vec_lut_bbb_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_lut_bbb_simd)
+#define srslte_vec_convert_if_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_convert_if_simd)
+#define srslte_vec_convert_fi_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_convert_fi_simd)
+#define srslte_vec_convert_conj_cs_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_convert_conj_cs_simd)
+#define srslte_vec_convert_fb_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_convert_fb_simd)
+#define srslte_vec_interleave_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_interleave_simd)
+#define srslte_vec_interleave_add_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_interleave_add_simd)
+#define srslte_vec_gen_sine_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_gen_sine_simd)
+#define srslte_vec_apply_cfo_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_apply_cfo_simd)
+#define srslte_vec_estimate_frequency_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_estimate_frequency_simd)
+#define srslte_vec_max_fi_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_max_fi_simd)
+#define srslte_vec_max_abs_fi_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_max_abs_fi_simd)
+#define srslte_vec_max_ci_simd SRSLTE_VEC_SIMD_NAME(srslte_vec_max_ci_simd)
+
+#endif /* SRSLTE_VEC_SIMD_SUFFIX */
+
+#endif // SRSLTE_VECTOR_SIMD_ISA_H
@@ -306,15 +306,20 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   bool                         ret = true;
   rf_buffer_t                  buffer_rx;
   uint32_t                     ratio = SRSLTE_MAX(1, decimators[0].ratio);
+  bool                         decim = ratio > 1 or rx_arb_enable;
 
   // If the interpolator have been set, interpolate
   for (uint32_t ch = 0; ch < nof_channels; ch++) {
     // Use rx buffer if decimator is required
-    buffer_rx.set(ch, ratio > 1 ? rx_buffer[ch].data() : buffer.get(ch));
+    buffer_rx.set(ch, decim ? rx_buffer[ch].data() : buffer.get(ch));
   }
 
-  // Set new buffer size
-  buffer_rx.set_nof_samples(buffer.get_nof_samples() * ratio);
+  // Set new buffer size, the arbitrary decimator tells the exact number of samples for the requested output
+  if (rx_arb_enable) {
+    buffer_rx.set_nof_samples(srslte_resample_arb_nof_input(&arb_decimators[0], buffer.get_nof_samples()));
+  } else {
+    buffer_rx.set_nof_samples(buffer.get_nof_samples() * ratio);
+  }
 
   if (not radio_is_streaming) {
     for (srslte_rf_t& rf_device : rf_devices) {
@@ -335,7 +340,14 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   }
 
   // Perform decimation
-  if (ratio > 1) {
+  if (rx_arb_enable) {
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      if (buffer.get(ch) and buffer_rx.get(ch)) {
+        srslte_resample_arb_compute(
+            &arb_decimators[ch], buffer_rx.get(ch), buffer.get(ch), (int)buffer_rx.get_nof_samples());
+      }
+    }
+  } else if (ratio > 1) {
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
       if (buffer.get(ch) and buffer_rx.get(ch)) {
         srslte_resampler_fft_run(&decimators[ch], buffer_rx.get(ch), buffer.get(ch), buffer_rx.get_nof_samples());
@@ -409,7 +421,20 @@ bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_tim
   std::unique_lock<std::mutex> lock(tx_mutex);
 
   // If the interpolator have been set, interpolate
-  if (interpolators[0].ratio > 1) {
+  if (tx_arb_enable) {
+    int nof_samples = 0;
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      // Perform actual interpolation, every channel produces the same number of samples
+      nof_samples = srslte_resample_arb_compute(
+          &arb_interpolators[ch], buffer.get(ch), tx_buffer[ch].data(), (int)buffer.get_nof_samples());
+
+      // Set the buffer pointer
+      buffer.set(ch, tx_buffer[ch].data());
+    }
+
+    // Set new buffer size
+    buffer.set_nof_samples((uint32_t)nof_samples);
+  } else if (interpolators[0].ratio > 1) {
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
       // Perform actual interpolation
       srslte_resampler_fft_run(&interpolators[ch], buffer.get(ch), tx_buffer[ch].data(), buffer.get_nof_samples());
@@ -665,10 +690,16 @@ void radio::set_rx_srate(const double& srate)
       }
     }
 
-    // Update decimators
-    uint32_t ratio = (uint32_t)ceil(cur_rx_srate / srate);
+    // Update decimators, non integer ratios use the polyphase arbitrary resampler
+    uint32_t ratio = (uint32_t)round(cur_rx_srate / srate);
+    rx_arb_enable  = std::abs(cur_rx_srate - ratio * srate) > 1.0;
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
-      srslte_resampler_fft_init(&decimators[ch], SRSLTE_RESAMPLER_MODE_DECIMATE, ratio);
+      if (rx_arb_enable) {
+        srslte_resampler_fft_init(&decimators[ch], SRSLTE_RESAMPLER_MODE_DECIMATE, 1);
+        srslte_resample_arb_init(&arb_decimators[ch], (float)(srate / cur_rx_srate), true);
+      } else {
+        srslte_resampler_fft_init(&decimators[ch], SRSLTE_RESAMPLER_MODE_DECIMATE, ratio);
+      }
     }
 
   } else {
@@ -904,10 +935,16 @@ void radio::set_tx_srate(const double& srate)
       }
     }
 
-    // Update interpolators
-    uint32_t ratio = (uint32_t)ceil(cur_tx_srate / srate);
+    // Update interpolators, non integer ratios use the polyphase arbitrary resampler
+    uint32_t ratio = (uint32_t)round(cur_tx_srate / srate);
+    tx_arb_enable  = std::abs(cur_tx_srate - ratio * srate) > 1.0;
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
-      srslte_resampler_fft_init(&interpolators[ch], SRSLTE_RESAMPLER_MODE_INTERPOLATE, ratio);
+      if (tx_arb_enable) {
+        srslte_resampler_fft_init(&interpolators[ch], SRSLTE_RESAMPLER_MODE_INTERPOLATE, 1);
+        srslte_resample_arb_init(&arb_interpolators[ch], (float)(cur_tx_srate / srate), true);
+      } else {
+        srslte_resampler_fft_init(&interpolators[ch], SRSLTE_RESAMPLER_MODE_INTERPOLATE, ratio);
+      }
     }
   } else {
     for (srslte_rf_t& rf_device : rf_devices) {
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/adt/mpsc_queue.h"
+#include "srslte/common/test_common.h"
+#include <thread>
+#include <vector>
+
+int test_mpsc_queue_single_thread()
+{
+  srslte::bounded_mpsc_queue<int, 4> q;
+  int                                v = -1;
+
+  TESTASSERT(not q.try_pop(v));
+  for (int i = 0; i < 4; ++i) {
+    TESTASSERT(q.try_push(i));
+  }
+  // the queue is full
+  TESTASSERT(not q.try_push(4));
+
+  TESTASSERT(q.try_pop(v) and v == 0);
+  TESTASSERT(q.try_push(4));
+
+  // elements come out in FIFO order, also across the wrap-around
+  std::vector<int> popped;
+  TESTASSERT(q.consume_all([&popped](int e) { popped.push_back(e); }) == 4);
+  TESTASSERT(popped == std::vector<int>({1, 2, 3, 4}));
+  TESTASSERT(not q.try_pop(v));
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_mpsc_queue_multi_thread()
+{
+  const int                             nof_producers = 4;
+  const int                             nof_pushes    = 100000;
+  srslte::bounded_mpsc_queue<int, 1024> q;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < nof_producers; ++p) {
+    producers.emplace_back([&q, p]() {
+      for (int i = 0; i < nof_pushes; ++i) {
+        while (not q.try_push(p * nof_pushes + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // the elements of every producer must be popped in the order they were pushed
+  std::vector<int> next(nof_producers, 0);
+  int              count = 0, v;
+  while (count < nof_producers * nof_pushes) {
+    if (q.try_pop(v)) {
+      int p = v / nof_pushes;
+      TESTASSERT(v % nof_pushes == next[p]);
+      next[p]++;
+      count++;
+    }
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  TESTASSERT(not q.try_pop(v));
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_mpsc_queue_single_thread() == SRSLTE_SUCCESS);
+  TESTASSERT(test_mpsc_queue_multi_thread() == SRSLTE_SUCCESS);
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Measures the pack/unpack rate of a RRCConnectionReconfiguration and of a S1AP
+ * InitialContextSetupRequest, with the default heap allocation and with the
+ * decoded messages allocated from an arena.
+ */
+
+#include "srslte/asn1/rrc_asn1.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <getopt.h>
+
+using namespace asn1;
+
+static uint32_t nof_iterations = 100000;
+
+static uint8_t rrc_msg[] = {
+    0x20, 0x16, 0x15, 0xC8, 0x40, 0x00, 0x03, 0xC2, 0x84, 0x18, 0x10, 0xA8, 0x04, 0xD7, 0x95, 0x14, 0xA2, 0x01, 0x02,
+    0x18, 0x9A, 0x01, 0x80, 0x14, 0x81, 0x0A, 0xCB, 0x84, 0x08, 0x00, 0xAD, 0x6D, 0xC4, 0x06, 0x08, 0xAF, 0x6D, 0xC7,
+    0xA0, 0xC0, 0x82, 0x00, 0x00, 0x0C, 0x38, 0x60, 0x20, 0x30, 0xC3, 0x00, 0x00, 0x10, 0x04, 0x40, 0x10, 0xC2, 0x3C,
+    0x2A, 0x06, 0x20, 0x30, 0x11, 0x10, 0x28, 0x13, 0xDA, 0x4E, 0x96, 0xDA, 0x80, 0x83, 0xA1, 0x00, 0xA4, 0x83, 0x00,
+    0x32, 0x7B, 0x08, 0x95, 0xAE, 0x00, 0x16, 0xA9, 0x00, 0xE0, 0x80, 0x84, 0x8C, 0x82, 0xBB, 0xB1, 0xB4, 0xBA, 0x18,
+    0x83, 0x36, 0xB7, 0x31, 0x98, 0x18, 0x98, 0x83, 0x36, 0xB1, 0xB1, 0x9A, 0x1B, 0x1B, 0x02, 0x33, 0xB8, 0x39, 0x39,
+    0x82, 0x80, 0x85, 0x7F, 0x80, 0x80, 0xAF, 0x03, 0x7F, 0x7F, 0x7D, 0x7D, 0x7F, 0x7F, 0x28, 0x05, 0xFB, 0x32, 0x7B,
+    0x08, 0xC0, 0x00, 0x01, 0xF8, 0x3E, 0x3C, 0xB1, 0xB2, 0x00, 0xC0, 0x30, 0x38, 0x1F, 0xFA, 0x9C, 0x08, 0x3E, 0xA2,
+    0x5F, 0x1C, 0xE1, 0xD0, 0x84};
+
+static uint8_t s1ap_msg[] = {
+    0x00, 0x09, 0x00, 0x80, 0xc6, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x02, 0x00, 0x64, 0x00, 0x08, 0x00, 0x02, 0x00,
+    0x01, 0x00, 0x42, 0x00, 0x0a, 0x18, 0x3b, 0x9a, 0xca, 0x00, 0x60, 0x3b, 0x9a, 0xca, 0x00, 0x00, 0x18, 0x00, 0x78,
+    0x00, 0x00, 0x34, 0x00, 0x73, 0x45, 0x00, 0x09, 0x3c, 0x0f, 0x80, 0x0a, 0x00, 0x21, 0xf0, 0xb7, 0x36, 0x1c, 0x56,
+    0x64, 0x27, 0x3e, 0x5b, 0x04, 0xb7, 0x02, 0x07, 0x42, 0x02, 0x3e, 0x06, 0x00, 0x09, 0xf1, 0x07, 0x00, 0x07, 0x00,
+    0x37, 0x52, 0x66, 0xc1, 0x01, 0x09, 0x1b, 0x07, 0x74, 0x65, 0x73, 0x74, 0x31, 0x32, 0x33, 0x06, 0x6d, 0x6e, 0x63,
+    0x30, 0x37, 0x30, 0x06, 0x6d, 0x63, 0x63, 0x39, 0x30, 0x31, 0x04, 0x67, 0x70, 0x72, 0x73, 0x05, 0x01, 0xc0, 0xa8,
+    0x03, 0x02, 0x27, 0x0e, 0x80, 0x80, 0x21, 0x0a, 0x03, 0x00, 0x00, 0x0a, 0x81, 0x06, 0x08, 0x08, 0x08, 0x08, 0x50,
+    0x0b, 0xf6, 0x09, 0xf1, 0x07, 0x80, 0x01, 0x01, 0xf6, 0x7e, 0x72, 0x69, 0x13, 0x09, 0xf1, 0x07, 0x00, 0x01, 0x23,
+    0x05, 0xf4, 0xf6, 0x7e, 0x72, 0x69, 0x00, 0x6b, 0x00, 0x05, 0x18, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x49, 0x00, 0x20,
+    0x45, 0x25, 0xe4, 0x9a, 0x77, 0xc8, 0xd5, 0xcf, 0x26, 0x33, 0x63, 0xeb, 0x5b, 0xb9, 0xc3, 0x43, 0x9b, 0x9e, 0xb3,
+    0x86, 0x1f, 0xa8, 0xa7, 0xcf, 0x43, 0x54, 0x07, 0xae, 0x42, 0x2b, 0x63, 0xb9};
+
+void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n number of iterations [Default %d]\n", nof_iterations);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_iterations = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static double msgs_per_sec(std::chrono::high_resolution_clock::time_point t0)
+{
+  std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+  return nof_iterations / std::chrono::duration_cast<std::chrono::duration<double> >(t1 - t0).count();
+}
+
+template <typename Msg>
+int bench_msg(const char* name, const uint8_t* msg, uint32_t msg_len)
+{
+  std::chrono::high_resolution_clock::time_point t0;
+
+  // Unpack, heap allocation
+  t0 = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_iterations; i++) {
+    Msg      pdu;
+    cbit_ref bref(msg, msg_len);
+    TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+  }
+  double unpack_rate = msgs_per_sec(t0);
+
+  // Unpack, arena allocation. The message is destroyed before the arena is reset
+  arena_allocator arena;
+  t0 = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_iterations; i++) {
+    {
+      arena_scope scope(arena);
+      Msg         pdu;
+      cbit_ref    bref(msg, msg_len);
+      TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+    }
+    arena.reset();
+  }
+  double unpack_arena_rate = msgs_per_sec(t0);
+
+  // Pack
+  Msg      pdu;
+  cbit_ref bref(msg, msg_len);
+  TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+  uint8_t buf[1024];
+  t0 = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_iterations; i++) {
+    bit_ref bref_out(buf, sizeof(buf));
+    TESTASSERT(pdu.pack(bref_out) == SRSASN_SUCCESS);
+    TESTASSERT((uint32_t)bref_out.distance_bytes() == msg_len);
+  }
+  double pack_rate = msgs_per_sec(t0);
+  TESTASSERT(memcmp(buf, msg, msg_len) == 0);
+
+  printf("%s (%d bytes): unpack %.0f msgs/s, unpack with arena %.0f msgs/s, pack %.0f msgs/s\n",
+         name,
+         msg_len,
+         unpack_rate,
+         unpack_arena_rate,
+         pack_rate);
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(bench_msg<rrc::dl_dcch_msg_s>("RRCConnectionReconfiguration", rrc_msg, sizeof(rrc_msg)) ==
+             SRSLTE_SUCCESS);
+  TESTASSERT(bench_msg<s1ap::s1ap_pdu_c>("InitialContextSetupRequest", s1ap_msg, sizeof(s1ap_msg)) == SRSLTE_SUCCESS);
+  return SRSLTE_SUCCESS;
+}
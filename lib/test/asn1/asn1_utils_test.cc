@@ -189,6 +189,110 @@ int test_bit_ref()
     TESTASSERT(bref.distance() == 216);
   }
 
+  // random fields, checked against a bit by bit reference. The buffer is small enough that both the word and the
+  // byte paths are exercised
+  for (uint32_t trial = 0; trial < 100; ++trial) {
+    uint8_t                                   buf2[64] = {}, ref[64] = {};
+    std::vector<std::pair<uint32_t, uint32_t> > fields;
+    bit_ref                                   bref(&buf2[0], sizeof(buf2));
+    uint32_t                                  bit_idx = 0;
+    while (true) {
+      uint32_t n   = std::uniform_int_distribution<uint32_t>{1, 31}(g);
+      uint32_t val = std::uniform_int_distribution<uint32_t>{0, (1u << n) - 1}(g);
+      if (bit_idx + n > sizeof(buf2) * 8) {
+        break;
+      }
+      TESTASSERT(bref.pack(val, n) == SRSASN_SUCCESS);
+      for (uint32_t i = 0; i < n; ++i) {
+        if ((val >> (n - 1 - i)) & 1u) {
+          ref[(bit_idx + i) / 8] |= 1u << (7 - (bit_idx + i) % 8);
+        }
+      }
+      bit_idx += n;
+      fields.push_back(std::make_pair(val, n));
+    }
+    TESTASSERT(bref.distance() == (int)bit_idx);
+    TESTASSERT(memcmp(buf2, ref, sizeof(buf2)) == 0);
+
+    cbit_ref bref2(&buf2[0], sizeof(buf2));
+    for (const auto& f : fields) {
+      uint32_t val;
+      TESTASSERT(bref2.unpack(val, f.second) == SRSASN_SUCCESS);
+      TESTASSERT(val == f.first);
+    }
+    TESTASSERT(bref2.distance() == (int)bit_idx);
+
+    // 64-bit reads at every offset
+    for (uint32_t off = 0; off < 8; ++off) {
+      cbit_ref bref3(&buf2[0], sizeof(buf2));
+      uint64_t val64, expected = 0;
+      TESTASSERT(bref3.advance_bits(off) == SRSASN_SUCCESS);
+      TESTASSERT(bref3.unpack(val64, 64) == SRSASN_SUCCESS);
+      for (uint32_t i = 0; i < 64; ++i) {
+        expected = (expected << 1u) | ((ref[(off + i) / 8] >> (7 - (off + i) % 8)) & 1u);
+      }
+      TESTASSERT(val64 == expected);
+    }
+
+    // unaligned byte copies of any length
+    uint32_t off     = std::uniform_int_distribution<uint32_t>{1, 7}(g);
+    uint32_t n_bytes = std::uniform_int_distribution<uint32_t>{1, sizeof(buf2) - 2}(g);
+    uint8_t  out[64];
+    cbit_ref bref4(&buf2[0], sizeof(buf2));
+    TESTASSERT(bref4.advance_bits(off) == SRSASN_SUCCESS);
+    TESTASSERT(bref4.unpack_bytes(out, n_bytes) == SRSASN_SUCCESS);
+    for (uint32_t i = 0; i < n_bytes; ++i) {
+      TESTASSERT(out[i] == (uint8_t)((ref[i] << off) | (ref[i + 1] >> (8 - off))));
+    }
+  }
+
+  return 0;
+}
+
+int test_arena()
+{
+  arena_allocator arena(256);
+  {
+    arena_scope       scope(arena);
+    dyn_array<int>    ar(10);
+    dyn_array<double> ar2(3);
+    TESTASSERT(arena.nof_chunks() == 1);
+    TESTASSERT(((uintptr_t)ar2.data() % alignof(double)) == 0);
+    for (uint32_t i = 0; i < ar.size(); ++i) {
+      ar[i] = i;
+    }
+    // growing takes new storage from the arena and keeps the content
+    for (uint32_t i = 0; i < 100; ++i) {
+      ar.push_back(10 + i);
+    }
+    TESTASSERT(ar.size() == 110);
+    for (uint32_t i = 0; i < ar.size(); ++i) {
+      TESTASSERT(ar[i] == (int)i);
+    }
+    TESTASSERT(arena.nof_chunks() > 1);
+
+    // nested arrays are destroyed properly
+    dyn_array<dyn_array<uint8_t> > nested(4);
+    for (uint32_t i = 0; i < nested.size(); ++i) {
+      nested[i].resize(i + 1);
+    }
+    TESTASSERT(nested[3].size() == 4);
+  }
+  TESTASSERT(get_thread_arena() == nullptr);
+
+  // Arrays allocated outside of a scope use the heap
+  dyn_array<int> heap_ar(10);
+  heap_ar[9] = 9;
+
+  // The chunks are reused after a reset
+  size_t nof_chunks = arena.nof_chunks();
+  arena.reset();
+  {
+    arena_scope    scope(arena);
+    dyn_array<int> ar(1000);
+    TESTASSERT(ar.size() == 1000);
+    TESTASSERT(arena.nof_chunks() == nof_chunks);
+  }
   return 0;
 }
 
@@ -635,6 +739,7 @@ int main()
   srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_DEBUG);
   TESTASSERT(test_arrays() == 0);
   TESTASSERT(test_bit_ref() == 0);
+  TESTASSERT(test_arena() == 0);
   TESTASSERT(test_oct_string() == 0);
   TESTASSERT(test_bitstring() == 0);
   TESTASSERT(test_seq_of() == 0);
@@ -44,6 +44,7 @@ static bool     print_dci_table;
 static uint32_t mcs                     = 20;
 static int      cross_carrier_indicator = -1;
 static bool     enable_256qam           = false;
+static bool     shared_frontend         = false;
 
 void usage(char* prog)
 {
@@ -63,6 +64,8 @@ void usage(char* prog)
   }
   printf("\t-v [set srslte_verbose to debug, default none]\n");
   printf("\t-q Enable/Disable 256QAM modulation (default %s)\n", enable_256qam ? "enabled" : "disabled");
+  printf("\t-x Enable/Disable decoding a second RNTI from a shared FFT/channel estimation front-end (default %s)\n",
+         shared_frontend ? "enabled" : "disabled");
 }
 
 void parse_extensive_param(char* param, char* arg)
@@ -93,7 +96,7 @@ void parse_args(int argc, char** argv)
     nof_rx_ant     = 2;
   }
 
-  while ((opt = getopt(argc, argv, "cfapndvqstm")) != -1) {
+  while ((opt = getopt(argc, argv, "cfapndvqstmx")) != -1) {
     switch (opt) {
       case 't':
         transmission_mode = (uint32_t)strtol(argv[optind], NULL, 10) - 1;
@@ -133,6 +136,9 @@ void parse_args(int argc, char** argv)
       case 'q':
         enable_256qam = (enable_256qam) ? false : true;
         break;
+      case 'x':
+        shared_frontend = (shared_frontend) ? false : true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -195,6 +201,7 @@ int work_ue(srslte_ue_dl_t*     ue_dl,
             srslte_dl_sf_cfg_t* sf_cfg_dl,
             srslte_ue_dl_cfg_t* ue_dl_cfg,
             srslte_dci_dl_t*    dci_dl,
+            uint16_t            rnti,
             uint32_t            sf_idx,
             srslte_pdsch_res_t  pdsch_res[SRSLTE_MAX_CODEWORDS])
 {
@@ -254,13 +261,13 @@ int work_ue(srslte_ue_dl_t*     ue_dl,
 }
 
 static int
-check_softbits(srslte_enb_dl_t* enb_dl, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_t* ue_dl_cfg, uint32_t sf_idx, int tb)
+check_softbits(srslte_pdsch_t* pdsch_tx, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_t* ue_dl_cfg, uint32_t sf_idx, int tb)
 {
   int ret = SRSLTE_SUCCESS;
 
   // Generate sequence
   srslte_sequence_pdsch(&ue_dl->pdsch.tmp_seq,
-                        rnti,
+                        ue_dl_cfg->cfg.pdsch.rnti,
                         ue_dl_cfg->cfg.pdsch.grant.tb[tb].cw_idx,
                         2 * (sf_idx % 10),
                         cell.id,
@@ -283,19 +290,19 @@ check_softbits(srslte_enb_dl_t* enb_dl, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_
     }
     rx_bytes[i] = w;
   }
-  if (memcmp(ue_dl->pdsch.e[tb], enb_dl->pdsch.e[tb], ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits / 8) != 0) {
+  if (memcmp(ue_dl->pdsch.e[tb], pdsch_tx->e[tb], ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits / 8) != 0) {
     ret = SRSLTE_ERROR;
   }
 
   return ret;
 }
 
-static int check_evm(srslte_enb_dl_t* enb_dl, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_t* ue_dl_cfg, int tb)
+static int check_evm(srslte_pdsch_t* pdsch_tx, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_t* ue_dl_cfg, int tb)
 {
   int ret = SRSLTE_SUCCESS;
-  srslte_vec_sub_ccc(enb_dl->pdsch.d[tb], ue_dl->pdsch.d[tb], enb_dl->pdsch.d[tb], ue_dl_cfg->cfg.pdsch.grant.nof_re);
-  uint32_t evm_max_i = srslte_vec_max_abs_ci(enb_dl->pdsch.d[tb], ue_dl_cfg->cfg.pdsch.grant.nof_re);
-  float    evm       = cabsf(enb_dl->pdsch.d[tb][evm_max_i]);
+  srslte_vec_sub_ccc(pdsch_tx->d[tb], ue_dl->pdsch.d[tb], pdsch_tx->d[tb], ue_dl_cfg->cfg.pdsch.grant.nof_re);
+  uint32_t evm_max_i = srslte_vec_max_abs_ci(pdsch_tx->d[tb], ue_dl_cfg->cfg.pdsch.grant.nof_re);
+  float    evm       = cabsf(pdsch_tx->d[tb][evm_max_i]);
 
   if (evm > 0.1f) {
     printf("TB%d Constellation EVM (%.3f) is too high\n", tb, evm);
@@ -305,10 +312,172 @@ static int check_evm(srslte_enb_dl_t* enb_dl, srslte_ue_dl_t* ue_dl, srslte_ue_d
   return ret;
 }
 
+/* Second RNTI scheduled in the same subframe with -x, encoded with its own PDSCH object so the symbols and bits of both
+ * transmissions can be checked */
+typedef struct {
+  uint16_t               rnti;
+  srslte_dci_dl_t        dci;
+  srslte_pdsch_t         pdsch_tx;
+  srslte_ue_dl_t         ue_dl;
+  srslte_ue_dl_cfg_t     ue_dl_cfg;
+  srslte_softbuffer_tx_t softbuffer_tx[SRSLTE_MAX_TB];
+  srslte_softbuffer_rx_t softbuffer_rx[SRSLTE_MAX_TB];
+  uint8_t*               data_tx[SRSLTE_MAX_TB];
+  uint8_t*               data_rx[SRSLTE_MAX_TB];
+  srslte_pdsch_res_t     pdsch_res[SRSLTE_MAX_CODEWORDS];
+  uint32_t               nof_locations[SRSLTE_NOF_SF_X_FRAME];
+  srslte_dci_location_t  dci_locations[SRSLTE_NOF_SF_X_FRAME][SRSLTE_MAX_CANDIDATES_UE];
+} shared_ue_t;
+
+static int shared_ue_init(shared_ue_t* q, srslte_ue_dl_t* frontend, srslte_pdcch_t* pdcch, uint16_t shared_rnti)
+{
+  q->rnti = shared_rnti;
+
+  for (int i = 0; i < SRSLTE_MAX_TB; i++) {
+    if (srslte_softbuffer_tx_init(&q->softbuffer_tx[i], cell.nof_prb) ||
+        srslte_softbuffer_rx_init(&q->softbuffer_rx[i], cell.nof_prb)) {
+      ERROR("Error initiating shared softbuffers\n");
+      return SRSLTE_ERROR;
+    }
+    q->data_tx[i] = srslte_vec_u8_malloc(MAX_DATABUFFER_SIZE);
+    q->data_rx[i] = srslte_vec_u8_malloc(MAX_DATABUFFER_SIZE);
+    if (!q->data_tx[i] || !q->data_rx[i]) {
+      ERROR("Error allocating shared data\n");
+      return SRSLTE_ERROR;
+    }
+  }
+
+  if (srslte_pdsch_init_enb(&q->pdsch_tx, cell.nof_prb) || srslte_pdsch_set_cell(&q->pdsch_tx, cell) ||
+      srslte_pdsch_set_rnti(&q->pdsch_tx, q->rnti)) {
+    ERROR("Error initiating shared PDSCH encoder\n");
+    return SRSLTE_ERROR;
+  }
+
+  if (srslte_ue_dl_init_shared(&q->ue_dl, frontend, cell.nof_prb) || srslte_ue_dl_set_cell(&q->ue_dl, cell)) {
+    ERROR("Error initiating shared UE downlink\n");
+    return SRSLTE_ERROR;
+  }
+  srslte_ue_dl_set_rnti(&q->ue_dl, q->rnti);
+
+  for (uint32_t i = 0; i < SRSLTE_NOF_SF_X_FRAME; i++) {
+    srslte_dl_sf_cfg_t sf_cfg_dl = {};
+    sf_cfg_dl.tti                = i;
+    sf_cfg_dl.cfi                = cfi;
+    sf_cfg_dl.sf_type            = SRSLTE_SF_NORM;
+
+    q->nof_locations[i] =
+        srslte_pdcch_ue_locations(pdcch, &sf_cfg_dl, q->dci_locations[i], SRSLTE_MAX_CANDIDATES_UE, q->rnti);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+static void shared_ue_free(shared_ue_t* q)
+{
+  srslte_ue_dl_free(&q->ue_dl);
+  srslte_pdsch_free(&q->pdsch_tx);
+  for (int i = 0; i < SRSLTE_MAX_TB; i++) {
+    srslte_softbuffer_tx_free(&q->softbuffer_tx[i]);
+    srslte_softbuffer_rx_free(&q->softbuffer_rx[i]);
+    if (q->data_tx[i]) {
+      free(q->data_tx[i]);
+    }
+    if (q->data_rx[i]) {
+      free(q->data_rx[i]);
+    }
+  }
+}
+
+/* Adds the PDCCH and PDSCH of the second RNTI to the subframe generated by work_enb() */
+static int shared_ue_work_enb(shared_ue_t* q, srslte_enb_dl_t* enb_dl, srslte_dl_sf_cfg_t* dl_sf, srslte_dci_cfg_t* dci_cfg)
+{
+  if (srslte_enb_dl_put_pdcch_dl(enb_dl, dci_cfg, &q->dci)) {
+    ERROR("Error putting shared PDCCH sf_idx=%d\n", dl_sf->tti);
+    return SRSLTE_ERROR;
+  }
+
+  srslte_pdsch_cfg_t pdsch_cfg = {};
+  if (srslte_ra_dl_dci_to_grant(&cell, dl_sf, transmission_mode, enable_256qam, &q->dci, &pdsch_cfg.grant)) {
+    ERROR("Computing shared DL grant sf_idx=%d\n", dl_sf->tti);
+    return SRSLTE_ERROR;
+  }
+
+  for (uint32_t i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+    pdsch_cfg.softbuffers.tx[i] = &q->softbuffer_tx[i];
+  }
+  pdsch_cfg.power_scale = true;
+  pdsch_cfg.p_a         = 0.0f;
+  pdsch_cfg.p_b         = (transmission_mode > SRSLTE_TM1) ? 1 : 0;
+  pdsch_cfg.rnti        = q->rnti;
+
+  if (srslte_pdsch_encode(&q->pdsch_tx, &enb_dl->dl_sf, &pdsch_cfg, q->data_tx, enb_dl->sf_symbols) < 0) {
+    ERROR("Error putting shared PDSCH sf_idx=%d\n", dl_sf->tti);
+    return SRSLTE_ERROR;
+  }
+
+  srslte_enb_dl_gen_signal(enb_dl);
+
+  return SRSLTE_SUCCESS;
+}
+
+/* Checks the EVM, the softbits and the CRC of every transport block of the second RNTI, returns the number of failed
+ * transport blocks */
+static uint32_t shared_ue_check(shared_ue_t* q, uint32_t sf_idx, uint32_t* count_tbs)
+{
+  uint32_t count_failures = 0;
+  for (int i = 0; i < SRSLTE_MAX_TB; i++) {
+    srslte_pdsch_grant_t* grant = &q->ue_dl_cfg.cfg.pdsch.grant;
+    if (!grant->tb[i].enabled) {
+      continue;
+    }
+    if (check_evm(&q->pdsch_tx, &q->ue_dl, &q->ue_dl_cfg, i)) {
+      printf("rnti=0x%x failed the EVM check in subframe %d\n", q->rnti, sf_idx);
+      count_failures++;
+    } else if (check_softbits(&q->pdsch_tx, &q->ue_dl, &q->ue_dl_cfg, sf_idx, i) != SRSLTE_SUCCESS) {
+      printf("rnti=0x%x TB%d: The received softbits in subframe %d DO NOT match the encoded bits\n", q->rnti, i, sf_idx);
+      count_failures++;
+    } else if (!q->pdsch_res[i].crc || memcmp(q->data_tx[i], q->data_rx[i], (uint32_t)grant->tb[i].tbs / 8) != 0) {
+      printf("rnti=0x%x Failed decoding tb %d in subframe %d. crc=%d\n", q->rnti, i, sf_idx, q->pdsch_res[i].crc);
+      count_failures++;
+    }
+    (*count_tbs)++;
+  }
+  return count_failures;
+}
+
+static bool locations_overlap(const srslte_dci_location_t* a, const srslte_dci_location_t* b)
+{
+  return a->ncce < b->ncce + (1U << b->L) && b->ncce < a->ncce + (1U << a->L);
+}
+
+/* Picks non-overlapping PDCCH candidates for both RNTIs, trying every aggregation level of both search spaces starting
+ * from the candidates the single RNTI test would use */
+static int select_shared_locations(srslte_dci_location_t* locations,
+                                   uint32_t               nof_locations,
+                                   srslte_dci_location_t* shared_locations,
+                                   uint32_t               nof_shared_locations,
+                                   uint32_t               start,
+                                   srslte_dci_location_t* location,
+                                   srslte_dci_location_t* shared_location)
+{
+  for (uint32_t i = 0; i < nof_locations; i++) {
+    for (uint32_t j = 0; j < nof_shared_locations; j++) {
+      *location        = locations[(start + i) % nof_locations];
+      *shared_location = shared_locations[(start + j) % nof_shared_locations];
+      if (!locations_overlap(location, shared_location)) {
+        return SRSLTE_SUCCESS;
+      }
+    }
+  }
+  return SRSLTE_ERROR;
+}
+
 int main(int argc, char** argv)
 {
   srslte_enb_dl_t*        enb_dl      = srslte_vec_malloc(sizeof(srslte_enb_dl_t));
   srslte_ue_dl_t*         ue_dl       = srslte_vec_malloc(sizeof(srslte_ue_dl_t));
+  srslte_ue_dl_t*         ue_dl_rx    = ue_dl; // Object decoding the UE channels, the front-end if not shared
+  shared_ue_t*            shared_ue   = NULL;
   srslte_random_t         random      = srslte_random_init(0);
   struct timeval          t[3]        = {};
   size_t                  tx_nof_bits = 0, rx_nof_bits = 0;
@@ -406,6 +575,27 @@ int main(int argc, char** argv)
 
   srslte_ue_dl_set_rnti(ue_dl, rnti);
 
+  // With a shared front-end, both RNTIs are decoded by objects reading the symbols and estimates of ue_dl
+  if (shared_frontend) {
+    ue_dl_rx  = srslte_vec_malloc(sizeof(srslte_ue_dl_t));
+    shared_ue = srslte_vec_malloc(sizeof(shared_ue_t));
+    if (!ue_dl_rx || !shared_ue) {
+      ERROR("Error allocating shared UE downlink\n");
+      goto quit;
+    }
+    bzero(shared_ue, sizeof(shared_ue_t));
+
+    if (srslte_ue_dl_init_shared(ue_dl_rx, ue_dl, cell.nof_prb) || srslte_ue_dl_set_cell(ue_dl_rx, cell)) {
+      ERROR("Error initiating shared UE downlink\n");
+      goto quit;
+    }
+    srslte_ue_dl_set_rnti(ue_dl_rx, rnti);
+
+    if (shared_ue_init(shared_ue, ue_dl, &enb_dl->pdcch, rnti + 1)) {
+      goto quit;
+    }
+  }
+
   /*
    * Create PDCCH Allocations
    */
@@ -504,6 +694,14 @@ int main(int argc, char** argv)
     ERROR("Wrong transmission mode (%d)\n", transmission_mode);
   }
 
+  // Both RNTIs take alternate RBGs
+  if (shared_ue) {
+    dci.type0_alloc.rbg_bitmask            = 0xaaaaaaaa;
+    shared_ue->dci                         = dci;
+    shared_ue->dci.rnti                    = shared_ue->rnti;
+    shared_ue->dci.type0_alloc.rbg_bitmask = 0x55555555;
+  }
+
   /*
    * Loop
    */
@@ -513,6 +711,9 @@ int main(int argc, char** argv)
     for (int j = 0; j < SRSLTE_MAX_TB; j++) {
       for (int i = 0; i < MAX_DATABUFFER_SIZE; i++) {
         data_tx[j][i] = (uint8_t)srslte_random_uniform_int_dist(random, 0, 255);
+        if (shared_ue) {
+          shared_ue->data_tx[j][i] = (uint8_t)srslte_random_uniform_int_dist(random, 0, 255);
+        }
       }
     }
 
@@ -535,12 +736,31 @@ int main(int argc, char** argv)
         dci.tb[i].mcs_idx = (sf_idx % 5 == 0) ? SRSLTE_MIN(mcs, 27) : mcs;
       }
     }
+    if (shared_ue) {
+      for (int i = 0; i < SRSLTE_MAX_TB; i++) {
+        shared_ue->dci.tb[i].mcs_idx = dci.tb[i].mcs_idx;
+      }
+      uint32_t n = sf_idx % 10;
+      if (select_shared_locations(dci_locations[n],
+                                  nof_locations[n],
+                                  shared_ue->dci_locations[n],
+                                  shared_ue->nof_locations[n],
+                                  sf_idx / 10,
+                                  &dci.location,
+                                  &shared_ue->dci.location)) {
+        ERROR("No free PDCCH location for rnti=0x%x in sf_idx=%d\n", shared_ue->rnti, sf_idx);
+        goto quit;
+      }
+    }
     INFO("--- Process eNb ---\n");
 
     gettimeofday(&t[1], NULL);
     if (work_enb(enb_dl, &sf_cfg_dl, &dci_cfg, &dci, softbuffer_tx, data_tx)) {
       goto quit;
     }
+    if (shared_ue && shared_ue_work_enb(shared_ue, enb_dl, &sf_cfg_dl, &dci_cfg)) {
+      goto quit;
+    }
     gettimeofday(&t[2], NULL);
     get_time_interval(t);
     pdsch_encode_us += (size_t)(t[0].tv_sec * 1e6 + t[0].tv_usec);
@@ -594,7 +814,34 @@ int main(int argc, char** argv)
       pdsch_res[i].crc                      = false;
       ue_dl_cfg.cfg.pdsch.softbuffers.rx[i] = softbuffer_rx[i];
     }
-    if (work_ue(ue_dl, &sf_cfg_dl, &ue_dl_cfg, dci_dl, sf_idx, pdsch_res)) {
+    if (shared_ue) {
+      shared_ue->ue_dl_cfg = ue_dl_cfg;
+      for (int i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
+        shared_ue->pdsch_res[i].payload                  = shared_ue->data_rx[i];
+        shared_ue->pdsch_res[i].avg_iterations_block     = 0.0f;
+        shared_ue->pdsch_res[i].crc                      = false;
+        shared_ue->ue_dl_cfg.cfg.pdsch.softbuffers.rx[i] = &shared_ue->softbuffer_rx[i];
+      }
+
+      // Demodulate and estimate once in the front-end, the shared objects only decode
+      if (srslte_ue_dl_decode_fft_estimate(ue_dl, &sf_cfg_dl, &ue_dl_cfg) < 0) {
+        ERROR("Getting front-end FFT estimate sf_idx=%d\n", sf_idx);
+        goto quit;
+      }
+    }
+
+    if (work_ue(ue_dl_rx, &sf_cfg_dl, &ue_dl_cfg, dci_dl, rnti, sf_idx, pdsch_res)) {
+      goto quit;
+    }
+
+    srslte_dci_dl_t shared_dci_dl[SRSLTE_MAX_DCI_MSG] = {};
+    if (shared_ue && work_ue(&shared_ue->ue_dl,
+                             &sf_cfg_dl,
+                             &shared_ue->ue_dl_cfg,
+                             shared_dci_dl,
+                             shared_ue->rnti,
+                             sf_idx,
+                             shared_ue->pdsch_res)) {
       goto quit;
     }
 
@@ -604,15 +851,15 @@ int main(int argc, char** argv)
 
     for (int i = 0; i < SRSLTE_MAX_TB; i++) {
       if (ue_dl_cfg.cfg.pdsch.grant.tb[i].enabled) {
-        if (check_evm(enb_dl, ue_dl, &ue_dl_cfg, i)) {
+        if (check_evm(&enb_dl->pdsch, ue_dl_rx, &ue_dl_cfg, i)) {
           count_failures++;
-        } else if (check_softbits(enb_dl, ue_dl, &ue_dl_cfg, sf_idx, i) != SRSLTE_SUCCESS) {
+        } else if (check_softbits(&enb_dl->pdsch, ue_dl_rx, &ue_dl_cfg, sf_idx, i) != SRSLTE_SUCCESS) {
           printf("TB%d: The received softbits in subframe %d DO NOT match the encoded bits (crc=%d)\n",
                  i,
                  sf_idx,
                  pdsch_res[i].crc);
           srslte_vec_fprint_byte(stdout, (uint8_t*)enb_dl->pdsch.e[i], ue_dl_cfg.cfg.pdsch.grant.tb[i].nof_bits / 8);
-          srslte_vec_fprint_byte(stdout, (uint8_t*)ue_dl->pdsch.e[i], ue_dl_cfg.cfg.pdsch.grant.tb[i].nof_bits / 8);
+          srslte_vec_fprint_byte(stdout, (uint8_t*)ue_dl_rx->pdsch.e[i], ue_dl_cfg.cfg.pdsch.grant.tb[i].nof_bits / 8);
           count_failures++;
         } else if (!pdsch_res[i].crc ||
                    memcmp(data_tx[i], data_rx[i], (uint32_t)ue_dl_cfg.cfg.pdsch.grant.tb[i].tbs / 8) != 0) {
@@ -628,6 +875,10 @@ int main(int argc, char** argv)
         tx_nof_bits += ue_dl_cfg.cfg.pdsch.grant.tb[i].tbs;
       }
     }
+
+    if (shared_ue) {
+      count_failures += shared_ue_check(shared_ue, sf_idx, &count_tbs);
+    }
   }
 
   printf("Finished! The UE failed decoding %d of %d transport blocks.\n", count_failures, count_tbs);
@@ -648,6 +899,14 @@ int main(int argc, char** argv)
 
 quit:
   srslte_enb_dl_free(enb_dl);
+  if (shared_ue) {
+    shared_ue_free(shared_ue);
+    free(shared_ue);
+  }
+  if (ue_dl_rx && ue_dl_rx != ue_dl) {
+    srslte_ue_dl_free(ue_dl_rx);
+    free(ue_dl_rx);
+  }
   srslte_ue_dl_free(ue_dl);
   srslte_random_free(random);
 
@@ -43,6 +43,17 @@ struct mac_metrics_t {
   float    phr;
 };
 
+// MAC scheduler metrics, common to all users
+
+struct sched_metrics_t {
+  uint64_t nof_lock_acquisitions;
+  uint64_t nof_lock_contentions; ///< acquisitions that had to wait for another thread
+  uint64_t lock_wait_us;         ///< total time spent waiting for the scheduler lock
+  uint64_t max_lock_wait_us;
+  uint64_t nof_deferred_events;   ///< feedback calls queued to the next scheduling pass
+  uint64_t nof_queue_full_events; ///< feedback calls applied under the lock because the user queue was full
+};
+
 } // namespace srsenb
 
 #endif // SRSENB_MAC_METRICS_H
@@ -25,9 +25,12 @@
 #include "scheduler_grid.h"
 #include "scheduler_harq.h"
 #include "scheduler_ue.h"
+#include "srsenb/hdr/stack/mac/mac_metrics.h"
+#include "srslte/adt/mpsc_queue.h"
 #include "srslte/common/log.h"
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/interfaces/sched_interface.h"
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <pthread.h>
@@ -53,8 +56,9 @@ inline bool is_in_tti_interval(uint32_t tti, uint32_t tti1, uint32_t tti2)
 /* Caution: User addition (ue_cfg) and removal (ue_rem) are not thread-safe
  * Rest of operations are thread-safe
  *
- * The subclass sched_ue is thread-safe so that access to shared variables like buffer states
- * from scheduler thread and other threads is protected for each individual user.
+ * Feedback that does not return anything to the caller (buffer states, CQI/PMI/RI, CRC, SR, BSR, PHR, TPC) is pushed
+ * to a lock-free queue of the user and applied at the start of the next scheduling pass, so the PHY workers never
+ * wait for the scheduler lock. Calls that return user state drain the queue of that user first, under the lock.
  */
 
 class sched : public sched_interface
@@ -134,15 +138,44 @@ public:
   void                                 tpc_dec(uint16_t rnti);
   std::array<int, SRSLTE_MAX_CARRIERS> get_enb_ue_cc_map(uint16_t rnti) final;
   int                                  ul_buffer_add(uint16_t rnti, uint32_t lcid, uint32_t bytes) final;
+  void                                 get_metrics(sched_metrics_t& metrics);
 
   class carrier_sched;
 
 protected:
+  /// Feedback event deferred to the next scheduling pass
+  struct ue_event_t {
+    enum type_t {
+      dl_rlc_buffer_state,
+      dl_mac_buffer_state,
+      dl_ri_info,
+      dl_pmi_info,
+      dl_cqi_info,
+      ul_crc_info,
+      ul_cqi_info,
+      ul_sr_info,
+      ul_bsr,
+      ul_buffer_add,
+      ul_phr,
+      tpc_inc,
+      tpc_dec
+    } type;
+    uint32_t tti;
+    uint32_t enb_cc_idx;
+    uint32_t args[3];
+  };
+  using ue_event_queue_t = srslte::bounded_mpsc_queue<ue_event_t, 64>;
+
   void new_tti(srslte::tti_point tti_rx);
   bool is_generated(srslte::tti_point, uint32_t enb_cc_idx) const;
   // Helper methods
   template <typename Func>
-  int ue_db_access(uint16_t rnti, Func, const char* func_name = nullptr);
+  int                          ue_db_access(uint16_t rnti, Func, const char* func_name = nullptr);
+  int                          push_ue_event(uint16_t rnti, const ue_event_t& ev, const char* func_name = nullptr);
+  void                         apply_ue_event(sched_ue& ue, const ue_event_t& ev);
+  void                         drain_ue_events();
+  void                         drain_ue_events(uint16_t rnti, sched_ue& ue);
+  std::unique_lock<std::mutex> lock_sched();
 
   // args
   srslte::log_ref                  log_h;
@@ -161,6 +194,17 @@ protected:
   srslte::tti_point last_tti;
   std::mutex        sched_mutex;
   bool              configured = false;
+
+  // Feedback queues of each user. The rwlock only protects the map, producers share it and only ue_cfg/ue_rem/reset
+  // take it exclusively, always after the sched_mutex
+  std::map<uint16_t, std::unique_ptr<ue_event_queue_t> > ue_events;
+  pthread_rwlock_t                                       ue_events_rwlock = {};
+
+  // Protected by the sched_mutex
+  sched_metrics_t lock_metrics = {};
+  uint64_t        lock_wait_ns = 0, max_lock_wait_ns = 0;
+
+  std::atomic<uint64_t> nof_deferred_events{0}, nof_queue_full_events{0};
 };
 
 } // namespace srsenb
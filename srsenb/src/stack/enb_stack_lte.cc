@@ -181,6 +181,7 @@ bool enb_stack_lte::get_metrics(stack_metrics_t* metrics)
   auto ret = enb_task_queue.try_push([this]() {
     stack_metrics_t metrics{};
     mac.get_metrics(metrics.mac);
+    mac.get_sched_metrics(metrics.sched);
     rrc.get_metrics(metrics.rrc);
     s1ap.get_metrics(metrics.s1ap);
     pending_stack_metrics.push(metrics);
@@ -286,6 +286,11 @@ void mac::get_metrics(mac_metrics_t metrics[ENB_METRICS_MAX_USERS])
   }
 }
 
+void mac::get_sched_metrics(sched_metrics_t& metrics)
+{
+  scheduler.get_metrics(metrics);
+}
+
 /********************************************************
  *
  * PHY interface
@@ -25,7 +25,9 @@
 #include "srsenb/hdr/stack/mac/scheduler.h"
 #include "srsenb/hdr/stack/mac/scheduler_carrier.h"
 #include "srslte/common/logmap.h"
+#include "srslte/common/rwlock_guard.h"
 #include "srslte/srslte.h"
+#include <chrono>
 
 #define Console(fmt, ...) srslte::console(fmt, ##__VA_ARGS__)
 #define Error(fmt, ...) srslte::logmap::get("MAC ")->error(fmt, ##__VA_ARGS__)
@@ -137,9 +139,15 @@ bool sched_cell_params_t::set_cfg(uint32_t                             enb_cc_id
  *
  *******************************************************/
 
-sched::sched() : log_h(srslte::logmap::get("MAC")) {}
+sched::sched() : log_h(srslte::logmap::get("MAC"))
+{
+  pthread_rwlock_init(&ue_events_rwlock, nullptr);
+}
 
-sched::~sched() {}
+sched::~sched()
+{
+  pthread_rwlock_destroy(&ue_events_rwlock);
+}
 
 void sched::init(rrc_interface_mac* rrc_)
 {
@@ -153,18 +161,20 @@ void sched::init(rrc_interface_mac* rrc_)
 
 int sched::reset()
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock  = lock_sched();
   configured = false;
   for (std::unique_ptr<carrier_sched>& c : carrier_schedulers) {
     c->reset();
   }
   ue_db.clear();
+  srslte::rwlock_write_guard events_lock(ue_events_rwlock);
+  ue_events.clear();
   return 0;
 }
 
 void sched::set_sched_cfg(sched_interface::sched_args_t* sched_cfg_)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   if (sched_cfg_ != nullptr) {
     sched_cfg = *sched_cfg_;
   }
@@ -172,7 +182,7 @@ void sched::set_sched_cfg(sched_interface::sched_args_t* sched_cfg_)
 
 int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   // Setup derived config params
   sched_cell_params.resize(cell_cfg.size());
   for (uint32_t cc_idx = 0; cc_idx < cell_cfg.size(); ++cc_idx) {
@@ -206,13 +216,17 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
 
 int sched::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   // Add or config user
   auto it = ue_db.find(rnti);
   if (it == ue_db.end()) {
     // create new user
     ue_db[rnti].init(rnti, sched_cell_params);
     it = ue_db.find(rnti);
+    srslte::rwlock_write_guard events_lock(ue_events_rwlock);
+    ue_events[rnti].reset(new ue_event_queue_t{});
+  } else {
+    drain_ue_events(rnti, it->second);
   }
   it->second.set_cfg(ue_cfg);
 
@@ -221,9 +235,11 @@ int sched::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg)
 
 int sched::ue_rem(uint16_t rnti)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   if (ue_db.count(rnti) > 0) {
     ue_db.erase(rnti);
+    srslte::rwlock_write_guard events_lock(ue_events_rwlock);
+    ue_events.erase(rnti);
   } else {
     Error("User rnti=0x%x not found\n", rnti);
     return SRSLTE_ERROR;
@@ -273,12 +289,12 @@ uint32_t sched::get_ul_buffer(uint16_t rnti)
 
 int sched::dl_rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t retx_queue)
 {
-  return ue_db_access(rnti, [&](sched_ue& ue) { ue.dl_buffer_state(lc_id, tx_queue, retx_queue); });
+  return push_ue_event(rnti, {ue_event_t::dl_rlc_buffer_state, 0, 0, {lc_id, tx_queue, retx_queue}});
 }
 
 int sched::dl_mac_buffer_state(uint16_t rnti, uint32_t ce_code, uint32_t nof_cmds)
 {
-  return ue_db_access(rnti, [ce_code, nof_cmds](sched_ue& ue) { ue.mac_buffer_state(ce_code, nof_cmds); });
+  return push_ue_event(rnti, {ue_event_t::dl_mac_buffer_state, 0, 0, {ce_code, nof_cmds}});
 }
 
 int sched::dl_ack_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
@@ -290,70 +306,69 @@ int sched::dl_ack_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_
 
 int sched::ul_crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool crc)
 {
-  return ue_db_access(
-      rnti, [tti_rx, enb_cc_idx, crc](sched_ue& ue) { ue.set_ul_crc(srslte::tti_point{tti_rx}, enb_cc_idx, crc); });
+  return push_ue_event(rnti, {ue_event_t::ul_crc_info, tti_rx, enb_cc_idx, {crc}});
 }
 
 int sched::dl_ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value)
 {
-  return ue_db_access(rnti, [tti, enb_cc_idx, ri_value](sched_ue& ue) { ue.set_dl_ri(tti, enb_cc_idx, ri_value); });
+  return push_ue_event(rnti, {ue_event_t::dl_ri_info, tti, enb_cc_idx, {ri_value}});
 }
 
 int sched::dl_pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi_value)
 {
-  return ue_db_access(rnti, [tti, enb_cc_idx, pmi_value](sched_ue& ue) { ue.set_dl_pmi(tti, enb_cc_idx, pmi_value); });
+  return push_ue_event(rnti, {ue_event_t::dl_pmi_info, tti, enb_cc_idx, {pmi_value}});
 }
 
 int sched::dl_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi_value)
 {
-  return ue_db_access(rnti, [tti, enb_cc_idx, cqi_value](sched_ue& ue) { ue.set_dl_cqi(tti, enb_cc_idx, cqi_value); });
+  return push_ue_event(rnti, {ue_event_t::dl_cqi_info, tti, enb_cc_idx, {cqi_value}});
 }
 
 int sched::dl_rach_info(uint32_t enb_cc_idx, dl_sched_rar_info_t rar_info)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   return carrier_schedulers[enb_cc_idx]->dl_rach_info(rar_info);
 }
 
 int sched::ul_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi, uint32_t ul_ch_code)
 {
-  return ue_db_access(rnti, [&](sched_ue& ue) { ue.set_ul_cqi(tti, enb_cc_idx, cqi, ul_ch_code); });
+  return push_ue_event(rnti, {ue_event_t::ul_cqi_info, tti, enb_cc_idx, {cqi, ul_ch_code}});
 }
 
 int sched::ul_bsr(uint16_t rnti, uint32_t lcg_id, uint32_t bsr)
 {
-  return ue_db_access(rnti, [lcg_id, bsr](sched_ue& ue) { ue.ul_buffer_state(lcg_id, bsr); });
+  return push_ue_event(rnti, {ue_event_t::ul_bsr, 0, 0, {lcg_id, bsr}});
 }
 
 int sched::ul_buffer_add(uint16_t rnti, uint32_t lcid, uint32_t bytes)
 {
-  return ue_db_access(rnti, [lcid, bytes](sched_ue& ue) { ue.ul_buffer_add(lcid, bytes); });
+  return push_ue_event(rnti, {ue_event_t::ul_buffer_add, 0, 0, {lcid, bytes}});
 }
 
 int sched::ul_phr(uint16_t rnti, int phr)
 {
-  return ue_db_access(rnti, [phr](sched_ue& ue) { ue.ul_phr(phr); }, __PRETTY_FUNCTION__);
+  return push_ue_event(rnti, {ue_event_t::ul_phr, 0, 0, {(uint32_t)phr}}, __PRETTY_FUNCTION__);
 }
 
 int sched::ul_sr_info(uint32_t tti, uint16_t rnti)
 {
-  return ue_db_access(rnti, [](sched_ue& ue) { ue.set_sr(); }, __PRETTY_FUNCTION__);
+  return push_ue_event(rnti, {ue_event_t::ul_sr_info, tti}, __PRETTY_FUNCTION__);
 }
 
 void sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   carrier_schedulers[0]->set_dl_tti_mask(tti_mask, nof_sfs);
 }
 
 void sched::tpc_inc(uint16_t rnti)
 {
-  ue_db_access(rnti, [](sched_ue& ue) { ue.tpc_inc(); }, __PRETTY_FUNCTION__);
+  push_ue_event(rnti, {ue_event_t::tpc_inc}, __PRETTY_FUNCTION__);
 }
 
 void sched::tpc_dec(uint16_t rnti)
 {
-  ue_db_access(rnti, [](sched_ue& ue) { ue.tpc_dec(); }, __PRETTY_FUNCTION__);
+  push_ue_event(rnti, {ue_event_t::tpc_dec}, __PRETTY_FUNCTION__);
 }
 
 std::array<int, SRSLTE_MAX_CARRIERS> sched::get_enb_ue_cc_map(uint16_t rnti)
@@ -386,7 +401,7 @@ int sched::dl_sched(uint32_t tti_tx_dl, uint32_t enb_cc_idx, sched_interface::dl
     return 0;
   }
 
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   if (enb_cc_idx >= carrier_schedulers.size()) {
     return 0;
   }
@@ -407,7 +422,7 @@ int sched::ul_sched(uint32_t tti, uint32_t enb_cc_idx, srsenb::sched_interface::
     return 0;
   }
 
-  std::lock_guard<std::mutex> lock(sched_mutex);
+  auto lock = lock_sched();
   if (enb_cc_idx >= carrier_schedulers.size()) {
     return 0;
   }
@@ -429,6 +444,9 @@ void sched::new_tti(tti_point tti_rx)
 {
   last_tti = std::max(last_tti, tti_rx);
 
+  // Apply the feedback received since the last scheduling pass
+  drain_ue_events();
+
   // Generate sched results for all CCs, if not yet generated
   for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
     if (not is_generated(tti_rx, cc_idx)) {
@@ -455,9 +473,11 @@ bool sched::is_generated(srslte::tti_point tti_rx, uint32_t enb_cc_idx) const
 template <typename Func>
 int sched::ue_db_access(uint16_t rnti, Func f, const char* func_name)
 {
-  std::lock_guard<std::mutex> lock(sched_mutex);
-  auto                        it = ue_db.find(rnti);
+  auto lock = lock_sched();
+  auto it   = ue_db.find(rnti);
   if (it != ue_db.end()) {
+    // the state seen by f must include the feedback queued before this call
+    drain_ue_events(rnti, it->second);
     f(it->second);
   } else {
     if (func_name != nullptr) {
@@ -470,6 +490,124 @@ int sched::ue_db_access(uint16_t rnti, Func f, const char* func_name)
   return SRSLTE_SUCCESS;
 }
 
+/// Queues an event in the feedback queue of the user. If the queue is full, the event is applied under the lock
+int sched::push_ue_event(uint16_t rnti, const ue_event_t& ev, const char* func_name)
+{
+  {
+    srslte::rwlock_read_guard events_lock(ue_events_rwlock);
+    auto                      it = ue_events.find(rnti);
+    if (it == ue_events.end()) {
+      if (func_name != nullptr) {
+        Error("User rnti=0x%x not found. Failed to call %s.\n", rnti, func_name);
+      } else {
+        Error("User rnti=0x%x not found.\n", rnti);
+      }
+      return SRSLTE_ERROR;
+    }
+    if (it->second->try_push(ev)) {
+      nof_deferred_events.fetch_add(1, std::memory_order_relaxed);
+      return SRSLTE_SUCCESS;
+    }
+  }
+
+  // The rwlock must be released before taking the sched_mutex, as ue_cfg/ue_rem take them in the opposite order
+  nof_queue_full_events.fetch_add(1, std::memory_order_relaxed);
+  return ue_db_access(rnti, [this, &ev](sched_ue& ue) { apply_ue_event(ue, ev); }, func_name);
+}
+
+void sched::apply_ue_event(sched_ue& ue, const ue_event_t& ev)
+{
+  switch (ev.type) {
+    case ue_event_t::dl_rlc_buffer_state:
+      ue.dl_buffer_state(ev.args[0], ev.args[1], ev.args[2]);
+      break;
+    case ue_event_t::dl_mac_buffer_state:
+      ue.mac_buffer_state(ev.args[0], ev.args[1]);
+      break;
+    case ue_event_t::dl_ri_info:
+      ue.set_dl_ri(ev.tti, ev.enb_cc_idx, ev.args[0]);
+      break;
+    case ue_event_t::dl_pmi_info:
+      ue.set_dl_pmi(ev.tti, ev.enb_cc_idx, ev.args[0]);
+      break;
+    case ue_event_t::dl_cqi_info:
+      ue.set_dl_cqi(ev.tti, ev.enb_cc_idx, ev.args[0]);
+      break;
+    case ue_event_t::ul_crc_info:
+      ue.set_ul_crc(tti_point{ev.tti}, ev.enb_cc_idx, ev.args[0] != 0);
+      break;
+    case ue_event_t::ul_cqi_info:
+      ue.set_ul_cqi(ev.tti, ev.enb_cc_idx, ev.args[0], ev.args[1]);
+      break;
+    case ue_event_t::ul_sr_info:
+      ue.set_sr();
+      break;
+    case ue_event_t::ul_bsr:
+      ue.ul_buffer_state(ev.args[0], ev.args[1]);
+      break;
+    case ue_event_t::ul_buffer_add:
+      ue.ul_buffer_add(ev.args[0], ev.args[1]);
+      break;
+    case ue_event_t::ul_phr:
+      ue.ul_phr((int)ev.args[0]);
+      break;
+    case ue_event_t::tpc_inc:
+      ue.tpc_inc();
+      break;
+    case ue_event_t::tpc_dec:
+      ue.tpc_dec();
+      break;
+  }
+}
+
+/// Applies the queued feedback of all users. Called with the sched_mutex taken
+void sched::drain_ue_events()
+{
+  srslte::rwlock_read_guard events_lock(ue_events_rwlock);
+  for (auto& q : ue_events) {
+    auto it = ue_db.find(q.first);
+    if (it != ue_db.end()) {
+      q.second->consume_all([this, it](const ue_event_t& ev) { apply_ue_event(it->second, ev); });
+    }
+  }
+}
+
+void sched::drain_ue_events(uint16_t rnti, sched_ue& ue)
+{
+  srslte::rwlock_read_guard events_lock(ue_events_rwlock);
+  auto                      it = ue_events.find(rnti);
+  if (it != ue_events.end()) {
+    it->second->consume_all([this, &ue](const ue_event_t& ev) { apply_ue_event(ue, ev); });
+  }
+}
+
+/// Takes the sched_mutex and accounts the time spent waiting for it
+std::unique_lock<std::mutex> sched::lock_sched()
+{
+  std::unique_lock<std::mutex> lock(sched_mutex, std::try_to_lock);
+  if (not lock.owns_lock()) {
+    auto t0 = std::chrono::steady_clock::now();
+    lock.lock();
+    uint64_t wait_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    lock_metrics.nof_lock_contentions++;
+    lock_wait_ns += wait_ns;
+    max_lock_wait_ns = std::max(max_lock_wait_ns, wait_ns);
+  }
+  lock_metrics.nof_lock_acquisitions++;
+  return lock;
+}
+
+void sched::get_metrics(sched_metrics_t& metrics)
+{
+  auto lock                     = lock_sched();
+  metrics                       = lock_metrics;
+  metrics.lock_wait_us          = lock_wait_ns / 1000;
+  metrics.max_lock_wait_us      = max_lock_wait_ns / 1000;
+  metrics.nof_deferred_events   = nof_deferred_events.load(std::memory_order_relaxed);
+  metrics.nof_queue_full_events = nof_queue_full_events.load(std::memory_order_relaxed);
+}
+
 /*******************************************************
  *
  * Helper functions and common data types
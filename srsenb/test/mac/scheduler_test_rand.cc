@@ -412,7 +412,7 @@ int sched_tester::test_sch_collisions()
   return SRSLTE_SUCCESS;
 }
 
-void test_scheduler_rand(sched_sim_events sim)
+int test_scheduler_rand(sched_sim_events sim)
 {
   // Create classes
   sched_tester  tester;
@@ -422,6 +422,14 @@ void test_scheduler_rand(sched_sim_events sim)
   tester.sim_cfg(std::move(sim.sim_args));
 
   tester.test_next_ttis(sim.tti_events);
+
+  // the feedback of the simulated users is queued, and a single thread never waits for the scheduler lock
+  srsenb::sched_metrics_t metrics = {};
+  tester.get_metrics(metrics);
+  TESTASSERT(metrics.nof_deferred_events > 0);
+  TESTASSERT(metrics.nof_lock_acquisitions > 0 and metrics.nof_lock_contentions == 0);
+
+  return SRSLTE_SUCCESS;
 }
 
 sched_sim_events rand_sim_params(uint32_t nof_ttis)
@@ -494,7 +502,7 @@ int main()
   for (uint32_t n = 0; n < N_runs; ++n) {
     printf("Sim run number: %u\n", n + 1);
     sched_sim_events sim = rand_sim_params(nof_ttis);
-    test_scheduler_rand(std::move(sim));
+    TESTASSERT(test_scheduler_rand(std::move(sim)) == SRSLTE_SUCCESS);
   }
 
   return 0;
@@ -31,10 +31,13 @@
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/log.h"
 #include "srslte/common/log_filter.h"
+#include "srslte/common/threads.h"
 #include "srslte/interfaces/epc_interfaces.h"
 #include <cstddef>
 #include <fstream>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -45,6 +48,7 @@ namespace srsepc {
 
 typedef struct {
   std::string db_file;
+  uint32_t    db_reload_period; // Seconds between checks for changes of db_file, 0 disables hot reload
   uint16_t    mcc;
   uint16_t    mnc;
 } hss_args_t;
@@ -65,6 +69,7 @@ typedef struct {
   uint16_t           qci;
   uint8_t            last_rand[16];
   std::string        static_ip_addr;
+  size_t             db_line_hash; // Hash of the DB file line the context was loaded from
 
   // Helper getters/setters
   void set_sqn(const uint8_t* sqn_);
@@ -72,13 +77,14 @@ typedef struct {
   void get_last_rand(uint8_t* rand_);
 } hss_ue_ctx_t;
 
-class hss : public hss_interface_nas
+class hss : public hss_interface_nas, public srslte::thread
 {
 public:
   static hss* get_instance(void);
   static void cleanup(void);
   int         init(hss_args_t* hss_args, srslte::log_filter* hss_log);
   void        stop(void);
+  void        run_thread();
 
   virtual bool gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
   virtual bool gen_update_loc_answer(uint64_t imsi, uint8_t* qci);
@@ -92,7 +98,10 @@ private:
   virtual ~hss();
   static hss* m_instance;
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
+  // Subscribers indexed by IMSI. The mutex protects the index and the SQN/RAND of the contexts, the
+  // authentication vectors are computed outside of it so the MME workers can generate them concurrently.
+  std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
+  std::mutex                                                    m_db_mutex;
 
   void gen_rand(uint8_t rand_[16]);
 
@@ -111,13 +120,28 @@ private:
   void increment_sqn(uint8_t* sqn, uint8_t* next_sqn);
 
   bool          set_auth_algo(std::string auth_algo);
+  bool          parse_db_line(const std::string& line, hss_ue_ctx_t* ue_ctx);
   bool          read_db_file(std::string db_file);
+  bool          reload_db_file(std::string db_file);
   bool          write_db_file(std::string db_file);
+  bool          db_file_changed();
   hss_ue_ctx_t* get_ue_ctx(uint64_t imsi);
 
+  // SQN journal, SQN updates are appended to it and folded into the DB file on stop
+  void read_sqn_journal(std::string journal_file);
+  void write_sqn_journal(hss_ue_ctx_t* ue_ctx);
+
   std::string hex_string(uint8_t* hex, int size);
 
   std::string db_file;
+  std::string sqn_journal_file;
+  FILE*       m_sqn_journal = nullptr;
+
+  // Hot reload
+  bool            m_running          = false;
+  uint32_t        m_db_reload_period = 0;
+  struct timespec m_db_mtime         = {};
+  off_t           m_db_size          = 0;
 
   /*Logs*/
   srslte::log_filter* m_hss_log;
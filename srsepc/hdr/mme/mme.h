@@ -34,6 +34,7 @@
 #include "srslte/common/log_filter.h"
 #include "srslte/common/threads.h"
 #include <cstddef>
+#include <mutex>
 
 namespace srsepc {
 
@@ -45,6 +46,8 @@ typedef struct {
 
 typedef struct {
   int                 fd;
+  uint64_t            id;
+  uint32_t            shard;
   uint64_t            imsi;
   enum nas_timer_type type;
 } mme_timer_t;
@@ -61,13 +64,13 @@ class message_bomber : public srslte::thread
 
     private:
       message_bomber();
+      void send_identity_request(nas* nas_ctx);
       virtual ~message_bomber();
       static message_bomber* m_instance;
       s1ap* m_s1ap;
 
       bool m_running;
       srslte::byte_buffer_pool* m_pool;
-      fd_set m_set;
       srslte::log_filter* m_s1ap_log;
     };
 
@@ -99,13 +102,16 @@ private:
   message_bomber* m_mb;
   bool                      m_running;
   srslte::byte_buffer_pool* m_pool;
-  fd_set                    m_set;
+  int                       m_epoll_fd;
 
-  // Timer map
+  // Timer map, timers are added by the worker shards and expired by the I/O thread
   std::vector<mme_timer_t> timers;
+  uint64_t                 m_next_timer_id;
+  std::mutex               m_timers_mutex;
 
-  // Timer Methods
-  void handle_timer_expire(int timer_fd);
+  // S11 and Timer Methods, run in the I/O thread and dispatched to the owning shard
+  void handle_s11_pdu(srslte::byte_buffer_t* pdu);
+  void handle_timer_expire(uint64_t timer_id);
 
   // Logs
   srslte::log_filter* m_nas_log;
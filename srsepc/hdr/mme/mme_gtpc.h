@@ -26,6 +26,7 @@
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/log.h"
 #include "srslte/common/log_filter.h"
+#include <mutex>
 #include <sys/socket.h>
 #include <sys/un.h>
 
@@ -60,7 +61,8 @@ public:
   void         send_downlink_data_notification_acknowledge(uint64_t imsi, enum srslte::gtpc_cause_value cause);
   virtual bool send_downlink_data_notification_failure_indication(uint64_t imsi, enum srslte::gtpc_cause_value cause);
 
-  int get_s11();
+  int      get_s11();
+  uint64_t find_imsi_from_ctrl_teid(uint32_t mme_ctrl_teid);
 
 private:
   mme_gtpc() = default;
@@ -71,6 +73,7 @@ private:
   uint32_t                            m_next_ctrl_teid;
   std::map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
   std::map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
+  std::mutex                          m_ctx_mutex; // Protects the maps and TEID counter, shared by the worker shards
 
   int                m_s11;
   struct sockaddr_un m_mme_addr, m_spgw_addr;
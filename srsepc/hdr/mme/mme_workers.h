@@ -0,0 +1,75 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        mme_workers.h
+ * Description: Sharded worker threads running the S1AP/NAS procedures.
+ *              Every UE context is owned by one shard, selected from its
+ *              MME-UE-S1AP-Id, M-TMSI or IMSI, so all the messages of a UE
+ *              are processed in order by the same thread while different
+ *              UEs are processed in parallel.
+ *****************************************************************************/
+
+#ifndef SRSEPC_MME_WORKERS_H
+#define SRSEPC_MME_WORKERS_H
+
+#include "srslte/common/thread_pool.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace srsepc {
+
+class mme_workers
+{
+public:
+  using task_t = std::function<void()>;
+
+  explicit mme_workers(uint32_t nof_shards);
+  ~mme_workers();
+
+  void start();
+  void stop();
+
+  uint32_t nof_shards() const { return shards.size(); }
+
+  // Shard owning an identifier allocated with next_id()
+  uint32_t get_shard(uint64_t id) const { return id % shards.size(); }
+
+  // Queues a task in the given shard, tasks pushed to the same shard run in order
+  void push(uint32_t shard, task_t task);
+
+  // Blocks until every task pushed before the call has been processed
+  void wait_idle();
+
+  // Shard of the calling thread, 0 when called outside of a worker
+  static uint32_t current_shard();
+
+  // Returns the first identifier not lower than id owned by the current shard
+  uint64_t next_id(uint64_t id) const;
+
+private:
+  std::vector<std::unique_ptr<srslte::task_thread_pool> > shards;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_MME_WORKERS_H
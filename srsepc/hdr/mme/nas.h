@@ -267,6 +267,9 @@ public:
   esm_ctx_t m_esm_ctx[MAX_ERABS_PER_UE] = {};
   sec_ctx_t m_sec_ctx                   = {};
 
+  // Worker shard processing all the procedures of this UE
+  uint32_t m_shard = 0;
+
 private:
   srslte::byte_buffer_pool* m_pool    = nullptr;
   srslte::log*              m_nas_log = nullptr;
@@ -22,6 +22,7 @@
 #define SRSEPC_S1AP_H
 
 #include "mme_gtpc.h"
+#include "mme_workers.h"
 #include "nas.h"
 #include "s1ap_ctx_mngmt_proc.h"
 #include "s1ap_mngmt_proc.h"
@@ -37,6 +38,8 @@
 #include "srslte/interfaces/epc_interfaces.h"
 #include <arpa/inet.h>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <netinet/sctp.h>
 #include <set>
 #include <strings.h>
@@ -64,6 +67,9 @@ public:
 
   void delete_enb_ctx(int32_t assoc_id);
 
+  mme_workers* get_workers() { return m_workers.get(); }
+  uint32_t     get_ue_shard(uint64_t imsi);
+
   bool s1ap_tx_pdu(const s1ap_pdu_t& pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri);
@@ -109,6 +115,10 @@ public:
 
   std::map<uint64_t, nas*> m_imsi_to_nas_ctx;
   std::map<uint32_t, nas*> m_tmsi_to_nas_ctx;
+
+  // Protects the UE and eNB maps, which are shared by all the worker shards
+  std::recursive_mutex m_ctx_mutex;
+
   // Interfaces
   virtual bool send_initial_context_setup_request(uint64_t imsi, uint16_t erab_to_setup);
   virtual bool send_ue_context_release_command(uint32_t mme_ue_s1ap_id);
@@ -126,6 +136,10 @@ private:
 
   static s1ap* m_instance;
 
+  uint32_t get_pdu_shard(const s1ap_pdu_t& pdu);
+  uint32_t get_init_ue_msg_shard(const asn1::s1ap::init_ue_msg_s& init_ue);
+  void     release_ue_ecm_ctx_in_enb(uint32_t mme_ue_s1ap_id);
+
   uint32_t                  m_plmn;
   srslte::byte_buffer_pool* m_pool;
 
@@ -143,9 +157,13 @@ private:
   // GTP-C Interface
   mme_gtpc* m_mme_gtpc;
 
+  // Worker shards
+  std::unique_ptr<mme_workers> m_workers;
+
   // PCAP
   bool              m_pcap_enable;
   srslte::s1ap_pcap m_pcap;
+  std::mutex        m_pcap_mutex;
 };
 
 inline uint32_t s1ap::get_plmn()
@@ -41,6 +41,7 @@ typedef struct {
   uint16_t                            mcc;          // BCD-coded with 0xF filler
   uint16_t                            mnc;          // BCD-coded with 0xF filler
   uint16_t                            paging_timer; // Paging timer in sec (T3413)
+  uint32_t                            nof_workers;  // Number of S1AP/NAS worker shards
   std::string                         mme_bind_addr;
   std::string                         mme_name;
   std::string                         dns_addr;
@@ -21,24 +21,35 @@
 #include "srsepc/hdr/hss/hss.h"
 #include "srslte/common/security.h"
 #include <inttypes.h> // for printing uint64_t
+#include <algorithm>
 #include <iomanip>
+#include <set>
 #include <sstream>
 #include <stdlib.h> /* srand, rand */
 #include <string>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 namespace srsepc {
 
 hss*            hss::m_instance    = NULL;
 pthread_mutex_t hss_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-hss::hss()
+hss::hss() : thread("HSS")
 {
   return;
 }
 
 hss::~hss()
 {
+  if (m_running) {
+    m_running = false;
+    wait_thread_finish();
+  }
+  if (m_sqn_journal != nullptr) {
+    fclose(m_sqn_journal);
+  }
   return;
 }
 
@@ -78,6 +89,22 @@ int hss::init(hss_args_t* hss_args, srslte::log_filter* hss_log)
   mnc = hss_args->mnc;
 
   db_file = hss_args->db_file;
+  db_file_changed();
+
+  /*Replay the SQN updates not yet folded into the DB file*/
+  sqn_journal_file = db_file + ".sqn";
+  read_sqn_journal(sqn_journal_file);
+  m_sqn_journal = fopen(sqn_journal_file.c_str(), "a");
+  if (m_sqn_journal == nullptr) {
+    m_hss_log->warning("Could not open SQN journal %s, SQNs are only saved on exit\n", sqn_journal_file.c_str());
+  }
+
+  /*Watch the DB file for changes*/
+  m_db_reload_period = hss_args->db_reload_period;
+  if (m_db_reload_period > 0) {
+    m_running = true;
+    start();
+  }
 
   m_hss_log->info("HSS Initialized. DB file %s, MCC: %d, MNC: %d\n", hss_args->db_file.c_str(), mcc, mnc);
   srslte::console("HSS Initialized.\n");
@@ -86,10 +113,124 @@ int hss::init(hss_args_t* hss_args, srslte::log_filter* hss_log)
 
 void hss::stop()
 {
-  write_db_file(db_file);
+  if (m_running) {
+    m_running = false;
+    wait_thread_finish();
+  }
+
+  std::lock_guard<std::mutex> lock(m_db_mutex);
+  if (write_db_file(db_file) && m_sqn_journal != nullptr) {
+    // All the SQNs are in the DB file now, start an empty journal
+    fclose(m_sqn_journal);
+    m_sqn_journal = fopen(sqn_journal_file.c_str(), "w");
+  }
+  if (m_sqn_journal != nullptr) {
+    fclose(m_sqn_journal);
+    m_sqn_journal = nullptr;
+  }
   return;
 }
 
+void hss::run_thread()
+{
+  uint32_t elapsed = 0;
+  while (m_running) {
+    sleep(1);
+    if (++elapsed < m_db_reload_period) {
+      continue;
+    }
+    elapsed = 0;
+    if (db_file_changed()) {
+      m_hss_log->info("DB file %s changed, reloading\n", db_file.c_str());
+      srslte::console("Reloading user database %s\n", db_file.c_str());
+      reload_db_file(db_file);
+    }
+  }
+}
+
+bool hss::db_file_changed()
+{
+  struct stat st;
+  if (stat(db_file.c_str(), &st) != 0) {
+    return false;
+  }
+  bool changed = st.st_mtim.tv_sec != m_db_mtime.tv_sec || st.st_mtim.tv_nsec != m_db_mtime.tv_nsec ||
+                 st.st_size != m_db_size;
+  m_db_mtime = st.st_mtim;
+  m_db_size  = st.st_size;
+  return changed;
+}
+
+bool hss::parse_db_line(const std::string& line, hss_ue_ctx_t* ue_ctx)
+{
+  uint                     column_size = 10;
+  std::vector<std::string> split       = split_string(line, ',');
+  if (split.size() != column_size) {
+    m_hss_log->error("Error parsing UE database. Wrong number of columns in .csv\n");
+    m_hss_log->error("Columns: %zd, Expected %d.\n", split.size(), column_size);
+
+    srslte::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
+    srslte::console("Perhaps you are using an old user_db.csv?\n");
+    srslte::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
+    return false;
+  }
+  ue_ctx->name = split[0];
+  if (split[1] == std::string("xor")) {
+    ue_ctx->algo = HSS_ALGO_XOR;
+  } else if (split[1] == std::string("mil")) {
+    ue_ctx->algo = HSS_ALGO_MILENAGE;
+  } else {
+    m_hss_log->error("Neither XOR nor MILENAGE configured.\n");
+    return false;
+  }
+  ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
+  get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
+  if (split[4] == std::string("op")) {
+    ue_ctx->op_configured = true;
+    get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
+    srslte::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
+  } else if (split[4] == std::string("opc")) {
+    ue_ctx->op_configured = false;
+    get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
+  } else {
+    m_hss_log->error("Neither OP nor OPc configured.\n");
+    return false;
+  }
+  get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
+  get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
+
+  m_hss_log->debug("Added user from DB, IMSI: %015" PRIu64 "\n", ue_ctx->imsi);
+  m_hss_log->debug_hex(ue_ctx->key, 16, "User Key : ");
+  if (ue_ctx->op_configured) {
+    m_hss_log->debug_hex(ue_ctx->op, 16, "User OP : ");
+  }
+  m_hss_log->debug_hex(ue_ctx->opc, 16, "User OPc : ");
+  m_hss_log->debug_hex(ue_ctx->amf, 2, "AMF : ");
+  m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN : ");
+  ue_ctx->qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
+  m_hss_log->debug("Default Bearer QCI: %d\n", ue_ctx->qci);
+
+  if (split[9] == std::string("dynamic")) {
+    ue_ctx->static_ip_addr = "0.0.0.0";
+  } else {
+    char buf[128] = {0};
+    if (inet_pton(AF_INET, split[9].c_str(), buf)) {
+      if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
+        ue_ctx->static_ip_addr = split[9];
+        m_hss_log->info("static ip addr %s\n", ue_ctx->static_ip_addr.c_str());
+      } else {
+        m_hss_log->info("duplicate static ip addr %s\n", split[9].c_str());
+        return false;
+      }
+    } else {
+      m_hss_log->info("invalid static ip addr %s, %s\n", split[9].c_str(), strerror(errno));
+      return false;
+    }
+  }
+  ue_ctx->db_line_hash = std::hash<std::string>()(line);
+  return true;
+}
+
 bool hss::read_db_file(std::string db_filename)
 {
   std::ifstream m_db_file;
@@ -103,82 +244,128 @@ bool hss::read_db_file(std::string db_filename)
   std::string line;
   while (std::getline(m_db_file, line)) {
     if (line[0] != '#' && line.length() > 0) {
-      uint                     column_size = 10;
-      std::vector<std::string> split       = split_string(line, ',');
-      if (split.size() != column_size) {
-        m_hss_log->error("Error parsing UE database. Wrong number of columns in .csv\n");
-        m_hss_log->error("Columns: %zd, Expected %d.\n", split.size(), column_size);
-
-        srslte::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
-        srslte::console("Perhaps you are using an old user_db.csv?\n");
-        srslte::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
-        return false;
-      }
       std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
-      ue_ctx->name                         = split[0];
-      if (split[1] == std::string("xor")) {
-        ue_ctx->algo = HSS_ALGO_XOR;
-      } else if (split[1] == std::string("mil")) {
-        ue_ctx->algo = HSS_ALGO_MILENAGE;
-      } else {
-        m_hss_log->error("Neither XOR nor MILENAGE configured.\n");
+      if (!parse_db_line(line, ue_ctx.get())) {
         return false;
       }
-      ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
-      get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
-      if (split[4] == std::string("op")) {
-        ue_ctx->op_configured = true;
-        get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
-        srslte::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
-      } else if (split[4] == std::string("opc")) {
-        ue_ctx->op_configured = false;
-        get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
-      } else {
-        m_hss_log->error("Neither OP nor OPc configured.\n");
-        return false;
+      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
+    }
+  }
+
+  if (m_db_file.is_open()) {
+    m_db_file.close();
+  }
+
+  return true;
+}
+
+bool hss::reload_db_file(std::string db_filename)
+{
+  std::ifstream m_db_file;
+
+  m_db_file.open(db_filename.c_str(), std::ifstream::in);
+  if (!m_db_file.is_open()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_db_mutex);
+  std::set<uint64_t>          imsis_in_file;
+  uint32_t                    nof_added = 0, nof_updated = 0, nof_removed = 0;
+
+  // Static IPs are taken again from the file, as they may have moved between users
+  m_ip_to_imsi.clear();
+
+  std::string line;
+  while (std::getline(m_db_file, line)) {
+    if (line[0] != '#' && line.length() > 0) {
+      // Lines that did not change since they were loaded are not parsed again
+      std::vector<std::string> split = split_string(line, ',');
+      if (split.size() > 2) {
+        std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it =
+            m_imsi_to_ue_ctx.find(strtoull(split[2].c_str(), nullptr, 10));
+        if (it != m_imsi_to_ue_ctx.end() && it->second->db_line_hash == std::hash<std::string>()(line)) {
+          imsis_in_file.insert(it->first);
+          if (it->second->static_ip_addr != "0.0.0.0") {
+            m_ip_to_imsi.insert(std::make_pair(it->second->static_ip_addr, it->first));
+          }
+          continue;
+        }
       }
-      get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
-      get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
 
-      m_hss_log->debug("Added user from DB, IMSI: %015" PRIu64 "\n", ue_ctx->imsi);
-      m_hss_log->debug_hex(ue_ctx->key, 16, "User Key : ");
-      if (ue_ctx->op_configured) {
-        m_hss_log->debug_hex(ue_ctx->op, 16, "User OP : ");
+      std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
+      if (!parse_db_line(line, ue_ctx.get())) {
+        m_hss_log->error("Skipping malformed line in DB file\n");
+        continue;
       }
-      m_hss_log->debug_hex(ue_ctx->opc, 16, "User OPc : ");
-      m_hss_log->debug_hex(ue_ctx->amf, 2, "AMF : ");
-      m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN : ");
-      ue_ctx->qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
-      m_hss_log->debug("Default Bearer QCI: %d\n", ue_ctx->qci);
-
-      if (split[9] == std::string("dynamic")) {
-        ue_ctx->static_ip_addr = "0.0.0.0";
+      imsis_in_file.insert(ue_ctx->imsi);
+
+      std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.find(ue_ctx->imsi);
+      if (it == m_imsi_to_ue_ctx.end()) {
+        m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
+        nof_added++;
       } else {
-        char buf[128] = {0};
-        if (inet_pton(AF_INET, split[9].c_str(), buf)) {
-          if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
-            ue_ctx->static_ip_addr = split[9];
-            m_hss_log->info("static ip addr %s\n", ue_ctx->static_ip_addr.c_str());
-          } else {
-            m_hss_log->info("duplicate static ip addr %s\n", split[9].c_str());
-            return false;
-          }
-        } else {
-          m_hss_log->info("invalid static ip addr %s, %s\n", split[9].c_str(), strerror(errno));
-          return false;
-        }
+        // The SQN and last RAND held in memory are newer than the ones in the file
+        ue_ctx->set_sqn(it->second->sqn);
+        ue_ctx->set_last_rand(it->second->last_rand);
+        it->second = std::move(ue_ctx);
+        nof_updated++;
       }
-      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
     }
   }
 
-  if (m_db_file.is_open()) {
-    m_db_file.close();
+  for (std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
+       it != m_imsi_to_ue_ctx.end();) {
+    if (imsis_in_file.count(it->first) == 0) {
+      it = m_imsi_to_ue_ctx.erase(it);
+      nof_removed++;
+    } else {
+      ++it;
+    }
   }
 
+  m_hss_log->info("Reloaded DB file %s. Users added: %d, updated: %d, removed: %d\n",
+                  db_filename.c_str(),
+                  nof_added,
+                  nof_updated,
+                  nof_removed);
   return true;
 }
 
+void hss::read_sqn_journal(std::string journal_file)
+{
+  std::ifstream journal;
+  journal.open(journal_file.c_str(), std::ifstream::in);
+  if (!journal.is_open()) {
+    return;
+  }
+
+  // Every line holds "IMSI,SQN", the last entry of an IMSI is its current SQN
+  uint32_t    nof_entries = 0;
+  std::string line;
+  while (std::getline(journal, line)) {
+    std::vector<std::string> split = split_string(line, ',');
+    if (split.size() != 2 || split[1].size() != 12) {
+      // Incomplete entry, written when the EPC was stopped abruptly
+      continue;
+    }
+    hss_ue_ctx_t* ue_ctx = get_ue_ctx(strtoull(split[0].c_str(), nullptr, 10));
+    if (ue_ctx != nullptr) {
+      get_uint_vec_from_hex_str(split[1], ue_ctx->sqn, 6);
+      nof_entries++;
+    }
+  }
+  m_hss_log->info("Replayed %d SQN updates from %s\n", nof_entries, journal_file.c_str());
+}
+
+void hss::write_sqn_journal(hss_ue_ctx_t* ue_ctx)
+{
+  if (m_sqn_journal == nullptr) {
+    return;
+  }
+  fprintf(m_sqn_journal, "%015" PRIu64 ",%s\n", ue_ctx->imsi, hex_string(ue_ctx->sqn, 6).c_str());
+  fflush(m_sqn_journal);
+}
+
 bool hss::write_db_file(std::string db_filename)
 {
   std::string line;
@@ -216,32 +403,44 @@ bool hss::write_db_file(std::string db_filename)
             << "#                                                                                           \n"
             << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
-  while (it != m_imsi_to_ue_ctx.end()) {
-    m_db_file << it->second->name;
+  // Users are written sorted by IMSI
+  std::vector<hss_ue_ctx_t*> ue_ctxs;
+  ue_ctxs.reserve(m_imsi_to_ue_ctx.size());
+  for (std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
+       it != m_imsi_to_ue_ctx.end();
+       ++it) {
+    ue_ctxs.push_back(it->second.get());
+  }
+  std::sort(ue_ctxs.begin(), ue_ctxs.end(), [](const hss_ue_ctx_t* a, const hss_ue_ctx_t* b) {
+    return a->imsi < b->imsi;
+  });
+
+  std::vector<hss_ue_ctx_t*>::iterator it = ue_ctxs.begin();
+  while (it != ue_ctxs.end()) {
+    m_db_file << (*it)->name;
     m_db_file << ",";
-    m_db_file << (it->second->algo == HSS_ALGO_XOR ? "xor" : "mil");
+    m_db_file << ((*it)->algo == HSS_ALGO_XOR ? "xor" : "mil");
     m_db_file << ",";
-    m_db_file << std::setfill('0') << std::setw(15) << it->second->imsi;
+    m_db_file << std::setfill('0') << std::setw(15) << (*it)->imsi;
     m_db_file << ",";
-    m_db_file << hex_string(it->second->key, 16);
+    m_db_file << hex_string((*it)->key, 16);
     m_db_file << ",";
-    if (it->second->op_configured) {
+    if ((*it)->op_configured) {
       m_db_file << "op,";
-      m_db_file << hex_string(it->second->op, 16);
+      m_db_file << hex_string((*it)->op, 16);
     } else {
       m_db_file << "opc,";
-      m_db_file << hex_string(it->second->opc, 16);
+      m_db_file << hex_string((*it)->opc, 16);
     }
     m_db_file << ",";
-    m_db_file << hex_string(it->second->amf, 2);
+    m_db_file << hex_string((*it)->amf, 2);
     m_db_file << ",";
-    m_db_file << hex_string(it->second->sqn, 6);
+    m_db_file << hex_string((*it)->sqn, 6);
     m_db_file << ",";
-    m_db_file << it->second->qci;
-    if (it->second->static_ip_addr != "0.0.0.0") {
+    m_db_file << (*it)->qci;
+    if ((*it)->static_ip_addr != "0.0.0.0") {
       m_db_file << ",";
-      m_db_file << it->second->static_ip_addr;
+      m_db_file << (*it)->static_ip_addr;
     } else {
       m_db_file << ",dynamic";
     }
@@ -258,22 +457,37 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
 {
 
   m_hss_log->debug("Generating AUTH info answer\n");
-  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
-  if (ue_ctx == nullptr) {
-    srslte::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
-    m_hss_log->error("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
-    return false;
+
+  // Take the SQN and move on to the next one, the vector is generated from a copy of the context
+  hss_ue_ctx_t ue_ctx_copy;
+  {
+    std::lock_guard<std::mutex> lock(m_db_mutex);
+    hss_ue_ctx_t*               ue_ctx = get_ue_ctx(imsi);
+    if (ue_ctx == nullptr) {
+      srslte::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
+      m_hss_log->error("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
+      return false;
+    }
+    ue_ctx_copy = *ue_ctx;
+    increment_ue_sqn(ue_ctx);
+    write_sqn_journal(ue_ctx);
   }
 
-  switch (ue_ctx->algo) {
+  switch (ue_ctx_copy.algo) {
     case HSS_ALGO_XOR:
-      gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
+      gen_auth_info_answer_xor(&ue_ctx_copy, k_asme, autn, rand, xres);
       break;
     case HSS_ALGO_MILENAGE:
-      gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
+      gen_auth_info_answer_milenage(&ue_ctx_copy, k_asme, autn, rand, xres);
       break;
   }
-  increment_ue_sqn(ue_ctx);
+
+  // Save the RAND for a later SQN resynchronization
+  std::lock_guard<std::mutex> lock(m_db_mutex);
+  hss_ue_ctx_t*               ue_ctx = get_ue_ctx(imsi);
+  if (ue_ctx != nullptr) {
+    ue_ctx->set_last_rand(ue_ctx_copy.last_rand);
+  }
   return true;
 }
 
@@ -432,7 +646,8 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
 
 bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
+  std::lock_guard<std::mutex>                                             lock(m_db_mutex);
+  std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
   if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
     m_hss_log->info("User not found. IMSI: %015" PRIu64 "\n", imsi);
     srslte::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
@@ -447,7 +662,8 @@ bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
 {
   m_hss_log->debug("Re-syncing SQN\n");
-  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
+  std::lock_guard<std::mutex> lock(m_db_mutex);
+  hss_ue_ctx_t*               ue_ctx = get_ue_ctx(imsi);
   if (ue_ctx == nullptr) {
     srslte::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     m_hss_log->error("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
@@ -464,6 +680,7 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   }
 
   increment_seq_after_resync(ue_ctx);
+  write_sqn_journal(ue_ctx);
   return true;
 }
 
@@ -604,7 +821,7 @@ void hss::gen_rand(uint8_t rand_[16])
 
 hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
+  std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
   if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
     m_hss_log->info("User not found. IMSI: %015" PRIu64 "\n", imsi);
     return nullptr;
@@ -617,21 +834,39 @@ hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 std::vector<std::string> hss::split_string(const std::string& str, char delimiter)
 {
   std::vector<std::string> tokens;
-  std::string              token;
-  std::istringstream       tokenStream(str);
+  size_t                   start = 0;
+  size_t                   end   = str.find(delimiter);
 
-  while (std::getline(tokenStream, token, delimiter)) {
-    tokens.push_back(token);
+  while (end != std::string::npos) {
+    tokens.push_back(str.substr(start, end - start));
+    start = end + 1;
+    end   = str.find(delimiter, start);
+  }
+  if (start < str.size()) {
+    tokens.push_back(str.substr(start));
   }
   return tokens;
 }
 
 void hss::get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len)
 {
-  const char* pos = key_str.c_str();
+  // Invalid digits are read as zero
+  auto hex_digit = [](char c) -> uint8_t {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return 0;
+  };
 
-  for (uint count = 0; count < len; count++) {
-    sscanf(pos, "%2hhx", &key[count]);
+  const char* pos = key_str.c_str();
+  for (uint count = 0; count < len && pos[0] != '\0' && pos[1] != '\0'; count++) {
+    key[count] = (hex_digit(pos[0]) << 4) | hex_digit(pos[1]);
     pos += 2;
   }
   return;
@@ -650,6 +885,7 @@ std::string hss::hex_string(uint8_t* hex, int size)
 
 std::map<std::string, uint64_t> hss::get_ip_to_imsi(void) const
 {
+  // Note: static IPs changed by a hot reload are only seen by the SP-GW after a restart
   return m_ip_to_imsi;
 }
 
@@ -23,17 +23,24 @@
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
 namespace srsepc {
 
+// Epoll keys of the S1-MME and S11 sockets, NAS timers are keyed by their id
+#define MME_EPOLL_S1MME_ID 0
+#define MME_EPOLL_S11_ID 1
+#define MME_EPOLL_FIRST_TIMER_ID 2
+#define MME_EPOLL_MAX_EVENTS 64
+
 mme*            mme::m_instance    = NULL;
 message_bomber* message_bomber::m_instance = NULL;
 pthread_mutex_t mme_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t mb_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-mme::mme() : m_running(false), thread("MME")
+mme::mme() : m_running(false), m_epoll_fd(-1), m_next_timer_id(MME_EPOLL_FIRST_TIMER_ID), thread("MME")
 {
   m_pool = srslte::byte_buffer_pool::get_instance();
   return;
@@ -126,6 +133,13 @@ int mme::init(mme_args_t*         args,
     exit(-1);
   }
 
+  /*Init epoll*/
+  m_epoll_fd = epoll_create1(0);
+  if (m_epoll_fd == -1) {
+    m_s1ap_log->error("Error creating epoll instance: %s\n", strerror(errno));
+    exit(-1);
+  }
+
   /*Log successful initialization*/
   m_s1ap_log->info("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
   srslte::console("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
@@ -145,11 +159,16 @@ int message_bomber::init(s1ap* s1ap, srslte::log_filter* s1ap_log)
 void mme::stop()
 {
   if (m_running) {
-    m_s1ap->stop();
-    m_s1ap->cleanup();
+    // Stop the I/O thread first, so no more procedures are pushed to the S1AP workers
     m_running = false;
     thread_cancel();
     wait_thread_finish();
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+  }
+  if (m_epoll_fd != -1) {
+    close(m_epoll_fd);
+    m_epoll_fd = -1;
   }
   return;
 }
@@ -186,28 +205,27 @@ void mme::run_thread()
 
   m_mb->start();
 
-  while (m_running) {
-    pdu->clear();
-    int max_fd = std::max(s1mme, s11);
-
-    FD_ZERO(&m_set);
-    FD_SET(s1mme, &m_set);
-    FD_SET(s11, &m_set);
-
-    // Add timers to select
-    for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
-      FD_SET(it->fd, &m_set);
-      max_fd = std::max(max_fd, it->fd);
-      m_s1ap_log->debug("Adding Timer fd %d to fd_set\n", it->fd);
-    }
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.u64           = MME_EPOLL_S1MME_ID;
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, s1mme, &ev);
+  ev.data.u64 = MME_EPOLL_S11_ID;
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, s11, &ev);
 
+  struct epoll_event events[MME_EPOLL_MAX_EVENTS];
+  while (m_running) {
     m_s1ap_log->debug("Waiting for S1-MME or S11 Message\n");
-    int n = select(max_fd + 1, &m_set, NULL, NULL, NULL);
+    int n = epoll_wait(m_epoll_fd, events, MME_EPOLL_MAX_EVENTS, -1);
     if (n == -1) {
-      m_s1ap_log->error("Error from select\n");
-    } else if (n) {
-      // Handle S1-MME
-      if (FD_ISSET(s1mme, &m_set)) {
+      if (errno != EINTR) {
+        m_s1ap_log->error("Error from epoll_wait: %s\n", strerror(errno));
+      }
+      continue;
+    }
+    for (int i = 0; i < n; i++) {
+      pdu->clear();
+      if (events[i].data.u64 == MME_EPOLL_S1MME_ID) {
+        // Handle S1-MME
         rd_sz = sctp_recvmsg(s1mme, pdu->msg, sz, (struct sockaddr*)&enb_addr, &fromlen, &sri, &msg_flags);
         if (rd_sz == -1 && errno != EAGAIN) {
           m_s1ap_log->error("Error reading from SCTP socket: %s", strerror(errno));
@@ -224,38 +242,72 @@ void mme::run_thread()
               m_s1ap->delete_enb_ctx(sri.sinfo_assoc_id);
             }
           } else {
-            // Received data
+            // Received data, decoded here and processed by the shard owning the UE
             pdu->N_bytes = rd_sz;
             m_s1ap_log->info("Received S1AP msg. Size: %d\n", pdu->N_bytes);
             m_s1ap->handle_s1ap_rx_pdu(pdu, &sri);
           }
         }
-      }
-      // Handle S11
-      if (FD_ISSET(s11, &m_set)) {
-        pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
-        m_mme_gtpc->handle_s11_pdu(pdu);
-      }
-      // Handle NAS Timers
-      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
-        if (FD_ISSET(it->fd, &m_set)) {
-          m_s1ap_log->info("Timer expired\n");
-          uint64_t exp;
-          rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
-          close(it->fd);
-          timers.erase(it);
-        } else {
-          ++it;
+      } else if (events[i].data.u64 == MME_EPOLL_S11_ID) {
+        // Handle S11
+        rd_sz = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
+        if (rd_sz < (int)sizeof(srslte::gtpc_header)) {
+          m_mme_gtpc_log->error("Error reading from S11 socket\n");
+          continue;
         }
+        pdu->N_bytes = rd_sz;
+        handle_s11_pdu(pdu);
+      } else {
+        // Handle NAS Timers
+        handle_timer_expire(events[i].data.u64);
       }
-    } else {
-      m_s1ap_log->debug("No data from select.\n");
     }
   }
   return;
 }
 
+void mme::handle_s11_pdu(srslte::byte_buffer_t* pdu)
+{
+  // Route the S11 message to the shard owning the UE of the control TEID
+  srslte::gtpc_pdu* gtpc_pdu = (srslte::gtpc_pdu*)pdu->msg;
+  uint64_t          imsi     = m_mme_gtpc->find_imsi_from_ctrl_teid(gtpc_pdu->header.teid);
+  uint32_t          shard    = imsi != 0 ? m_s1ap->get_ue_shard(imsi) : 0;
+
+  std::shared_ptr<srslte::byte_buffer_t> msg(new srslte::byte_buffer_t(*pdu));
+  mme_gtpc*                              gtpc = m_mme_gtpc;
+  m_s1ap->get_workers()->push(shard, [gtpc, msg]() { gtpc->handle_s11_pdu(msg.get()); });
+}
+
+void mme::handle_timer_expire(uint64_t timer_id)
+{
+  mme_timer_t timer;
+  {
+    std::lock_guard<std::mutex>        lock(m_timers_mutex);
+    std::vector<mme_timer_t>::iterator it = timers.begin();
+    while (it != timers.end() && it->id != timer_id) {
+      ++it;
+    }
+    if (it == timers.end()) {
+      // The timer was removed by its shard after it had fired
+      return;
+    }
+    timer = *it;
+    uint64_t exp;
+    if (read(timer.fd, &exp, sizeof(uint64_t)) < 0) {
+      m_s1ap_log->warning("Error reading timer fd %d\n", timer.fd);
+    }
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, timer.fd, NULL);
+    close(timer.fd);
+    timers.erase(it);
+  }
+
+  m_s1ap_log->info("Timer expired\n");
+  s1ap*               s1ap_ptr = m_s1ap;
+  enum nas_timer_type type     = timer.type;
+  uint64_t            imsi     = timer.imsi;
+  m_s1ap->get_workers()->push(timer.shard, [s1ap_ptr, type, imsi]() { s1ap_ptr->expire_nas_timer(type, imsi); });
+}
+
 void message_bomber::run_thread()
 {
   srslte::byte_buffer_t* pdu = m_pool->allocate("message_bomber::run_thread");
@@ -263,29 +315,56 @@ void message_bomber::run_thread()
   m_running = true;
 
   while (m_running) {
-    for (std::map<uint32, nas*>::iterator it = m_s1ap->m_tmsi_to_nas_ctx.begin(); it != m_s1ap->m_tmsi_to_nas_ctx.end(); it++) {
-      srslte::console("bombing with GUTI\n");
-      nas* nas_ctx = it->second;
-      srslte::byte_buffer_t* nas_tx = m_pool->allocate();
-      nas_ctx->pack_identity_request(nas_tx);
-      m_s1ap->send_downlink_nas_transport(
-          nas_ctx->m_ecm_ctx.enb_ue_s1ap_id, nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_tx, nas_ctx->m_ecm_ctx.enb_sri);
-      m_pool->deallocate(nas_tx);
+    // Take a snapshot of the UEs, every identity request is sent from the shard owning the UE
+    std::vector<uint32_t> tmsis;
+    std::vector<uint64_t> imsis;
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_s1ap->m_ctx_mutex);
+      for (std::map<uint32_t, nas*>::iterator it = m_s1ap->m_tmsi_to_nas_ctx.begin();
+           it != m_s1ap->m_tmsi_to_nas_ctx.end();
+           it++) {
+        tmsis.push_back(it->first);
+      }
+      for (std::map<uint64_t, nas*>::iterator it = m_s1ap->m_imsi_to_nas_ctx.begin();
+           it != m_s1ap->m_imsi_to_nas_ctx.end();
+           it++) {
+        imsis.push_back(it->first);
+      }
     }
 
-    for (std::map<uint64_t, nas*>::iterator it = m_s1ap->m_imsi_to_nas_ctx.begin(); it!=m_s1ap->m_imsi_to_nas_ctx.end(); it++) {
-      srslte::console("bombing with IMSI\n");
-      nas* nas_ctx = it->second;
-      srslte::byte_buffer_t* nas_tx = m_pool->allocate();
-      nas_ctx->pack_identity_request(nas_tx);
-      m_s1ap->send_downlink_nas_transport(
-          nas_ctx->m_ecm_ctx.enb_ue_s1ap_id, nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_tx, nas_ctx->m_ecm_ctx.enb_sri);
-      m_pool->deallocate(nas_tx);
+    s1ap* s1ap_ptr = m_s1ap;
+    for (uint32_t tmsi : tmsis) {
+      m_s1ap->get_workers()->push(m_s1ap->get_workers()->get_shard(tmsi), [this, s1ap_ptr, tmsi]() {
+        std::lock_guard<std::recursive_mutex> lock(s1ap_ptr->m_ctx_mutex);
+        std::map<uint32_t, nas*>::iterator    it = s1ap_ptr->m_tmsi_to_nas_ctx.find(tmsi);
+        if (it != s1ap_ptr->m_tmsi_to_nas_ctx.end()) {
+          srslte::console("bombing with GUTI\n");
+          send_identity_request(it->second);
+        }
+      });
+    }
+    for (uint64_t imsi : imsis) {
+      m_s1ap->get_workers()->push(m_s1ap->get_ue_shard(imsi), [this, s1ap_ptr, imsi]() {
+        nas* nas_ctx = s1ap_ptr->find_nas_ctx_from_imsi(imsi);
+        if (nas_ctx != NULL) {
+          srslte::console("bombing with IMSI\n");
+          send_identity_request(nas_ctx);
+        }
+      });
     }
     sleep(3);
   }
 }
 
+void message_bomber::send_identity_request(nas* nas_ctx)
+{
+  srslte::byte_buffer_t* nas_tx = m_pool->allocate();
+  nas_ctx->pack_identity_request(nas_tx);
+  m_s1ap->send_downlink_nas_transport(
+      nas_ctx->m_ecm_ctx.enb_ue_s1ap_id, nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_tx, nas_ctx->m_ecm_ctx.enb_sri);
+  m_pool->deallocate(nas_tx);
+}
+
 /*
  * Timer Handling
  */
@@ -293,10 +372,21 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
 {
   m_s1ap_log->debug("Adding NAS timer to MME. IMSI %" PRIu64 ", Type %d, Fd: %d\n", imsi, type, timer_fd);
 
-  mme_timer_t timer;
-  timer.fd   = timer_fd;
-  timer.type = type;
-  timer.imsi = imsi;
+  std::lock_guard<std::mutex> lock(m_timers_mutex);
+  mme_timer_t                 timer;
+  timer.fd    = timer_fd;
+  timer.id    = m_next_timer_id++;
+  timer.shard = mme_workers::current_shard();
+  timer.type  = type;
+  timer.imsi  = imsi;
+
+  struct epoll_event ev = {};
+  ev.events             = EPOLLIN;
+  ev.data.u64           = timer.id;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) == -1) {
+    m_s1ap_log->error("Error adding timer fd %d to epoll: %s\n", timer_fd, strerror(errno));
+    return false;
+  }
 
   timers.push_back(timer);
   return true;
@@ -304,6 +394,7 @@ bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
 
 bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(m_timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -315,6 +406,7 @@ bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
 
 bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 {
+  std::lock_guard<std::mutex>        lock(m_timers_mutex);
   std::vector<mme_timer_t>::iterator it;
   for (it = timers.begin(); it != timers.end(); ++it) {
     if (it->type == type && it->imsi == imsi) {
@@ -328,7 +420,7 @@ bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
 
   // removing timer
   m_s1ap_log->debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d\n", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, it->fd, NULL);
   close(it->fd);
   timers.erase(it);
   return true;
@@ -133,8 +133,19 @@ void mme_gtpc::handle_s11_pdu(srslte::byte_buffer_t* msg)
   return;
 }
 
+uint64_t mme_gtpc::find_imsi_from_ctrl_teid(uint32_t mme_ctrl_teid)
+{
+  std::lock_guard<std::mutex>            lock(m_ctx_mutex);
+  std::map<uint32_t, uint64_t>::iterator it = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
+  if (it == m_mme_ctr_teid_to_imsi.end()) {
+    return 0;
+  }
+  return it->second;
+}
+
 bool mme_gtpc::send_create_session_request(uint64_t imsi)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   m_mme_gtpc_log->info("Sending Create Session Request.\n");
   srslte::console("Sending Create Session Request.\n");
   struct srslte::gtpc_pdu cs_req_pdu;
@@ -217,12 +228,11 @@ bool mme_gtpc::handle_create_session_response(srslte::gtpc_pdu* cs_resp_pdu)
   }
 
   // Get IMSI from the control TEID
-  std::map<uint32_t, uint64_t>::iterator id_it = m_mme_ctr_teid_to_imsi.find(cs_resp_pdu->header.teid);
-  if (id_it == m_mme_ctr_teid_to_imsi.end()) {
+  uint64_t imsi = find_imsi_from_ctrl_teid(cs_resp_pdu->header.teid);
+  if (imsi == 0) {
     m_mme_gtpc_log->warning("Could not find IMSI from Ctrl TEID.\n");
     return false;
   }
-  uint64_t imsi = id_it->second;
 
   m_mme_gtpc_log->info("MME GTPC Ctrl TEID %" PRIu64 ", IMSI %" PRIu64 "\n", cs_resp_pdu->header.teid, imsi);
 
@@ -267,6 +277,7 @@ bool mme_gtpc::handle_create_session_response(srslte::gtpc_pdu* cs_resp_pdu)
   srslte::console("SPGW Allocated IP %s to IMSI %015" PRIu64 "\n", inet_ntoa(emm_ctx->ue_ip), emm_ctx->imsi);
 
   // Save SGW ctrl F-TEID in GTP-C context
+  std::unique_lock<std::mutex>                  lock(m_ctx_mutex);
   std::map<uint64_t, struct gtpc_ctx>::iterator it_g = m_imsi_to_gtpc_ctx.find(imsi);
   if (it_g == m_imsi_to_gtpc_ctx.end()) {
     // Could not find GTP-C Context
@@ -275,6 +286,7 @@ bool mme_gtpc::handle_create_session_response(srslte::gtpc_pdu* cs_resp_pdu)
   }
   gtpc_ctx_t* gtpc_ctx    = &it_g->second;
   gtpc_ctx->sgw_ctr_fteid = sgw_ctr_fteid;
+  lock.unlock();
 
   // Set EPS bearer context
   // TODO default EPS bearer is hard-coded
@@ -288,6 +300,7 @@ bool mme_gtpc::handle_create_session_response(srslte::gtpc_pdu* cs_resp_pdu)
 
 bool mme_gtpc::send_modify_bearer_request(uint64_t imsi, uint16_t erab_to_modify, srslte::gtp_fteid_t* enb_fteid)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   m_mme_gtpc_log->info("Sending GTP-C Modify bearer request\n");
   srslte::gtpc_pdu mb_req_pdu;
   std::memset(&mb_req_pdu, 0, sizeof(mb_req_pdu));
@@ -321,22 +334,22 @@ bool mme_gtpc::send_modify_bearer_request(uint64_t imsi, uint16_t erab_to_modify
 
 void mme_gtpc::handle_modify_bearer_response(srslte::gtpc_pdu* mb_resp_pdu)
 {
-  uint32_t                               mme_ctrl_teid = mb_resp_pdu->header.teid;
-  std::map<uint32_t, uint64_t>::iterator imsi_it       = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
-  if (imsi_it == m_mme_ctr_teid_to_imsi.end()) {
+  uint64_t imsi = find_imsi_from_ctrl_teid(mb_resp_pdu->header.teid);
+  if (imsi == 0) {
     m_mme_gtpc_log->error("Could not find IMSI from control TEID\n");
     return;
   }
 
   uint8_t ebi = mb_resp_pdu->choice.modify_bearer_response.eps_bearer_context_modified.ebi;
   m_mme_gtpc_log->debug("Activating EPS bearer with id %d\n", ebi);
-  m_s1ap->activate_eps_bearer(imsi_it->second, ebi);
+  m_s1ap->activate_eps_bearer(imsi, ebi);
 
   return;
 }
 
 bool mme_gtpc::send_delete_session_request(uint64_t imsi)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   m_mme_gtpc_log->info("Sending GTP-C Delete Session Request request. IMSI %" PRIu64 "\n", imsi);
   srslte::gtpc_pdu del_req_pdu;
   std::memset(&del_req_pdu, 0, sizeof(del_req_pdu));
@@ -377,6 +390,7 @@ bool mme_gtpc::send_delete_session_request(uint64_t imsi)
 
 void mme_gtpc::send_release_access_bearers_request(uint64_t imsi)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   // The GTP-C connection will not be torn down, just the user plane bearers.
   m_mme_gtpc_log->info("Sending GTP-C Release Access Bearers Request\n");
   srslte::gtpc_pdu rel_req_pdu;
@@ -408,10 +422,9 @@ void mme_gtpc::send_release_access_bearers_request(uint64_t imsi)
 
 bool mme_gtpc::handle_downlink_data_notification(srslte::gtpc_pdu* dl_not_pdu)
 {
-  uint32_t                                 mme_ctrl_teid = dl_not_pdu->header.teid;
-  srslte::gtpc_downlink_data_notification* dl_not        = &dl_not_pdu->choice.downlink_data_notification;
-  std::map<uint32_t, uint64_t>::iterator   imsi_it       = m_mme_ctr_teid_to_imsi.find(mme_ctrl_teid);
-  if (imsi_it == m_mme_ctr_teid_to_imsi.end()) {
+  srslte::gtpc_downlink_data_notification* dl_not = &dl_not_pdu->choice.downlink_data_notification;
+  uint64_t                                 imsi   = find_imsi_from_ctrl_teid(dl_not_pdu->header.teid);
+  if (imsi == 0) {
     m_mme_gtpc_log->error("Could not find IMSI from control TEID\n");
     return false;
   }
@@ -421,14 +434,15 @@ bool mme_gtpc::handle_downlink_data_notification(srslte::gtpc_pdu* dl_not_pdu)
     return false;
   }
   uint8_t ebi = dl_not->eps_bearer_id;
-  m_mme_gtpc_log->debug("Downlink Data Notification -- IMSI: %015" PRIu64 ", EBI %d\n", imsi_it->second, ebi);
+  m_mme_gtpc_log->debug("Downlink Data Notification -- IMSI: %015" PRIu64 ", EBI %d\n", imsi, ebi);
 
-  m_s1ap->send_paging(imsi_it->second, ebi);
+  m_s1ap->send_paging(imsi, ebi);
   return true;
 }
 
 void mme_gtpc::send_downlink_data_notification_acknowledge(uint64_t imsi, enum srslte::gtpc_cause_value cause)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   m_mme_gtpc_log->debug("Sending GTP-C Data Notification Acknowledge. Cause %d\n", cause);
   srslte::gtpc_pdu    not_ack_pdu;
   srslte::gtp_fteid_t sgw_ctr_fteid;
@@ -459,6 +473,7 @@ void mme_gtpc::send_downlink_data_notification_acknowledge(uint64_t imsi, enum s
 
 bool mme_gtpc::send_downlink_data_notification_failure_indication(uint64_t imsi, enum srslte::gtpc_cause_value cause)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   m_mme_gtpc_log->debug("Sending GTP-C Data Notification Failure Indication. Cause %d\n", cause);
   srslte::gtpc_pdu    not_fail_pdu;
   srslte::gtp_fteid_t sgw_ctr_fteid;
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/mme_workers.h"
+#include <condition_variable>
+#include <mutex>
+
+namespace srsepc {
+
+static thread_local uint32_t worker_shard = 0;
+
+mme_workers::mme_workers(uint32_t nof_shards)
+{
+  nof_shards = std::max(nof_shards, 1u);
+  for (uint32_t i = 0; i < nof_shards; i++) {
+    shards.emplace_back(new srslte::task_thread_pool(1));
+  }
+}
+
+mme_workers::~mme_workers()
+{
+  stop();
+}
+
+void mme_workers::start()
+{
+  for (auto& s : shards) {
+    s->start();
+  }
+}
+
+void mme_workers::stop()
+{
+  for (auto& s : shards) {
+    s->stop();
+  }
+}
+
+void mme_workers::push(uint32_t shard, task_t task)
+{
+  shard %= shards.size();
+  shards[shard]->push_task([shard, task](uint32_t worker_id) {
+    worker_shard = shard;
+    task();
+  });
+}
+
+void mme_workers::wait_idle()
+{
+  std::mutex              mutex;
+  std::condition_variable cvar;
+  uint32_t                pending = shards.size();
+
+  for (uint32_t i = 0; i < shards.size(); i++) {
+    push(i, [&mutex, &cvar, &pending]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending--;
+      cvar.notify_one();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (pending > 0) {
+    cvar.wait(lock);
+  }
+}
+
+uint32_t mme_workers::current_shard()
+{
+  return worker_shard;
+}
+
+uint64_t mme_workers::next_id(uint64_t id) const
+{
+  uint64_t n     = shards.size();
+  uint64_t shard = worker_shard % n;
+  return id + (shard + n - id % n) % n;
+}
+
+} // namespace srsepc
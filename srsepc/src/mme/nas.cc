@@ -48,6 +48,7 @@ nas::nas(const nas_init_t& args, const nas_if_t& itf, srslte::log* nas_log) :
 {
   m_sec_ctx.integ_algo  = args.integ_algo;
   m_sec_ctx.cipher_algo = args.cipher_algo;
+  m_shard               = mme_workers::current_shard();
   m_nas_log->debug("NAS Context Initialized. MCC: 0x%x, MNC 0x%x\n", m_mcc, m_mnc);
 }
 
@@ -22,6 +22,7 @@
 #include "srsepc/hdr/mme/s1ap.h"
 #include "srslte/asn1/gtpc.h"
 #include "srslte/common/bcd_helpers.h"
+#include "srslte/common/int_helpers.h"
 #include "srslte/common/liblte_security.h"
 #include <cmath>
 #include <inttypes.h> // for printing uint64_t
@@ -88,6 +89,12 @@ int s1ap::init(s1ap_args_t s1ap_args, srslte::log_filter* nas_log, srslte::log_f
 
   // Get pointer to GTP-C class
   m_mme_gtpc = mme_gtpc::get_instance();
+
+  // Start the worker shards
+  m_workers.reset(new mme_workers(s1ap_args.nof_workers));
+  m_workers->start();
+  m_s1ap_log->info("S1AP/NAS procedures running in %d worker shards\n", m_workers->nof_shards());
+
   // Initialize S1-MME
   m_s1mme = enb_listen();
 
@@ -102,6 +109,9 @@ int s1ap::init(s1ap_args_t s1ap_args, srslte::log_filter* nas_log, srslte::log_f
 
 void s1ap::stop()
 {
+  if (m_workers != nullptr) {
+    m_workers->stop();
+  }
   if (m_s1mme != -1) {
     close(m_s1mme);
   }
@@ -140,7 +150,11 @@ int s1ap::get_s1_mme()
 
 uint32_t s1ap::get_next_mme_ue_s1ap_id()
 {
-  return m_next_mme_ue_s1ap_id++;
+  // Allocate IDs owned by the calling shard, so the following messages of the UE are routed to it
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
+  uint32_t mme_ue_s1ap_id = m_workers->next_id(m_next_mme_ue_s1ap_id);
+  m_next_mme_ue_s1ap_id   = mme_ue_s1ap_id + 1;
+  return mme_ue_s1ap_id;
 }
 
 int s1ap::enb_listen()
@@ -217,6 +231,7 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
   }
 
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(buf->msg, buf->N_bytes);
   }
 
@@ -227,33 +242,120 @@ void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo
 {
   // Save PCAP
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
   // Get PDU type
-  s1ap_pdu_t     rx_pdu;
-  asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+  std::shared_ptr<s1ap_pdu_t> rx_pdu(new s1ap_pdu_t);
+  asn1::cbit_ref              bref(pdu->msg, pdu->N_bytes);
+  if (rx_pdu->unpack(bref) != asn1::SRSASN_SUCCESS) {
     m_s1ap_log->error("Failed to unpack received PDU\n");
     return;
   }
 
-  switch (rx_pdu.type().value) {
-    case s1ap_pdu_t::types_opts::init_msg:
-      m_s1ap_log->info("Received Initiating PDU\n");
-      handle_initiating_message(rx_pdu.init_msg(), enb_sri);
-      break;
-    case s1ap_pdu_t::types_opts::successful_outcome:
-      m_s1ap_log->info("Received Succeseful Outcome PDU\n");
-      handle_successful_outcome(rx_pdu.successful_outcome());
-      break;
-    case s1ap_pdu_t::types_opts::unsuccessful_outcome:
-      m_s1ap_log->info("Received Unsucceseful Outcome PDU\n");
-      // TODO handle_unsuccessfuloutcome(&rx_pdu.choice.unsuccessfulOutcome);
-      break;
-    default:
-      m_s1ap_log->error("Unhandled PDU type %d\n", rx_pdu.type().value);
+  // Hand the PDU to the shard owning the UE, the procedures run outside of the I/O thread
+  struct sctp_sndrcvinfo sri = *enb_sri;
+  m_workers->push(get_pdu_shard(*rx_pdu), [this, rx_pdu, sri]() {
+    struct sctp_sndrcvinfo enb_sri = sri;
+    switch (rx_pdu->type().value) {
+      case s1ap_pdu_t::types_opts::init_msg:
+        m_s1ap_log->info("Received Initiating PDU\n");
+        handle_initiating_message(rx_pdu->init_msg(), &enb_sri);
+        break;
+      case s1ap_pdu_t::types_opts::successful_outcome:
+        m_s1ap_log->info("Received Succeseful Outcome PDU\n");
+        handle_successful_outcome(rx_pdu->successful_outcome());
+        break;
+      case s1ap_pdu_t::types_opts::unsuccessful_outcome:
+        m_s1ap_log->info("Received Unsucceseful Outcome PDU\n");
+        // TODO handle_unsuccessfuloutcome(&rx_pdu.choice.unsuccessfulOutcome);
+        break;
+      default:
+        m_s1ap_log->error("Unhandled PDU type %d\n", rx_pdu->type().value);
+    }
+  });
+}
+
+uint32_t s1ap::get_pdu_shard(const s1ap_pdu_t& pdu)
+{
+  using init_msg_type_opts_t           = asn1::s1ap::s1ap_elem_procs_o::init_msg_c::types_opts;
+  using successful_outcome_type_opts_t = asn1::s1ap::s1ap_elem_procs_o::successful_outcome_c::types_opts;
+
+  // Non UE-associated procedures are processed by the first shard
+  if (pdu.type().value == s1ap_pdu_t::types_opts::init_msg) {
+    const asn1::s1ap::init_msg_s& msg = pdu.init_msg();
+    switch (msg.value.type().value) {
+      case init_msg_type_opts_t::init_ue_msg:
+        return get_init_ue_msg_shard(msg.value.init_ue_msg());
+      case init_msg_type_opts_t::ul_nas_transport:
+        return m_workers->get_shard(msg.value.ul_nas_transport().protocol_ies.mme_ue_s1ap_id.value.value);
+      case init_msg_type_opts_t::ue_context_release_request:
+        return m_workers->get_shard(msg.value.ue_context_release_request().protocol_ies.mme_ue_s1ap_id.value.value);
+      default:
+        return 0;
+    }
+  }
+  if (pdu.type().value == s1ap_pdu_t::types_opts::successful_outcome) {
+    const asn1::s1ap::successful_outcome_s& msg = pdu.successful_outcome();
+    switch (msg.value.type().value) {
+      case successful_outcome_type_opts_t::init_context_setup_resp:
+        return m_workers->get_shard(msg.value.init_context_setup_resp().protocol_ies.mme_ue_s1ap_id.value.value);
+      case successful_outcome_type_opts_t::ue_context_release_complete:
+        return m_workers->get_shard(msg.value.ue_context_release_complete().protocol_ies.mme_ue_s1ap_id.value.value);
+      default:
+        return 0;
+    }
+  }
+  return 0;
+}
+
+uint32_t s1ap::get_init_ue_msg_shard(const asn1::s1ap::init_ue_msg_s& init_ue)
+{
+  // UEs with a S-TMSI are owned by the shard that allocated it
+  if (init_ue.protocol_ies.s_tmsi_present) {
+    uint32_t m_tmsi = 0;
+    srslte::uint8_to_uint32(init_ue.protocol_ies.s_tmsi.value.m_tmsi.data(), &m_tmsi);
+    return m_workers->get_shard(m_tmsi);
+  }
+
+  // Attach requests are routed by the mobile identity they carry
+  srslte::unique_byte_buffer_t nas_msg = srslte::allocate_unique_buffer(*m_pool);
+  if (nas_msg != nullptr && init_ue.protocol_ies.nas_pdu.value.size() <= nas_msg->get_tailroom()) {
+    memcpy(nas_msg->msg, init_ue.protocol_ies.nas_pdu.value.data(), init_ue.protocol_ies.nas_pdu.value.size());
+    nas_msg->N_bytes = init_ue.protocol_ies.nas_pdu.value.size();
+
+    uint8_t pd, msg_type;
+    liblte_mme_parse_msg_header((LIBLTE_BYTE_MSG_STRUCT*)nas_msg.get(), &pd, &msg_type);
+
+    LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+    if (msg_type == LIBLTE_MME_MSG_TYPE_ATTACH_REQUEST &&
+        liblte_mme_unpack_attach_request_msg((LIBLTE_BYTE_MSG_STRUCT*)nas_msg.get(), &attach_req) == LIBLTE_SUCCESS) {
+      if (attach_req.eps_mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI) {
+        uint64_t imsi = 0;
+        for (int i = 0; i <= 14; i++) {
+          imsi += attach_req.eps_mobile_id.imsi[i] * std::pow(10, 14 - i);
+        }
+        return get_ue_shard(imsi);
+      }
+      if (attach_req.eps_mobile_id.type_of_id == LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI) {
+        return m_workers->get_shard(attach_req.eps_mobile_id.guti.m_tmsi);
+      }
+    }
+  }
+
+  // Any shard can take a UE without identity, spread them by eNB UE S1AP Id
+  return m_workers->get_shard(init_ue.protocol_ies.enb_ue_s1ap_id.value.value);
+}
+
+uint32_t s1ap::get_ue_shard(uint64_t imsi)
+{
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
+  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+  if (nas_ctx != nullptr) {
+    return nas_ctx->m_shard;
   }
+  return m_workers->get_shard(imsi);
 }
 
 void s1ap::handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri)
@@ -304,6 +406,7 @@ void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg
 // eNB Context Managment
 void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   m_s1ap_log->info("Adding new eNB context. eNB ID %d\n", enb_ctx.enb_id);
   std::set<uint32_t> ue_set;
   enb_ctx_t*         enb_ptr = new enb_ctx_t;
@@ -315,6 +418,7 @@ void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinf
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint16_t, enb_ctx_t*>::iterator it = m_active_enbs.find(enb_id);
   if (it == m_active_enbs.end()) {
     return nullptr;
@@ -325,6 +429,7 @@ enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 
 void s1ap::delete_enb_ctx(int32_t assoc_id)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
   uint16_t                              enb_id   = it_assoc->second;
 
@@ -350,6 +455,7 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
 // UE Context Management
 bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
   if (ctx_it != m_imsi_to_nas_ctx.end()) {
     m_s1ap_log->error("UE Context already exists. IMSI %015" PRIu64 "\n", nas_ctx->m_emm_ctx.imsi);
@@ -369,6 +475,7 @@ bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 
 bool s1ap::add_nas_ctx_to_tmsi_map(nas* nas_ctx, uint32_t tmsi)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint32_t, nas*>::iterator ctx_it = m_tmsi_to_nas_ctx.find(tmsi);
   if (ctx_it != m_tmsi_to_nas_ctx.end()) {
     m_s1ap_log->debug("UE Context already exists. M-TMSI %015" PRIu32 ", erasing... \n", tmsi);
@@ -390,6 +497,7 @@ bool s1ap::add_nas_ctx_to_tmsi_map(nas* nas_ctx, uint32_t tmsi)
 
 bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id == 0) {
     m_s1ap_log->error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.\n");
     return false;
@@ -413,6 +521,7 @@ bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
 
 bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
   if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
     m_s1ap_log->error("Could not find eNB from eNB SCTP association %d\n", enb_assoc);
@@ -430,6 +539,7 @@ bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 
 nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
   if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
     return NULL;
@@ -440,6 +550,7 @@ nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 
 nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
   if (it == m_imsi_to_nas_ctx.end()) {
     return NULL;
@@ -450,34 +561,48 @@ nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 
 void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   srslte::console("Releasing UEs context\n");
   std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
   std::set<uint32_t>::iterator                     ue_id      = ues_in_enb->second.begin();
   if (ue_id == ues_in_enb->second.end()) {
     srslte::console("No UEs to be released\n");
   } else {
+    // Every UE is released by the shard that owns it
     while (ue_id != ues_in_enb->second.end()) {
-      std::map<uint32_t, nas*>::iterator nas_ctx = m_mme_ue_s1ap_id_to_nas_ctx.find(*ue_id);
-      emm_ctx_t*                         emm_ctx = &nas_ctx->second->m_emm_ctx;
-      ecm_ctx_t*                         ecm_ctx = &nas_ctx->second->m_ecm_ctx;
-
-      m_s1ap_log->info(
-          "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d\n", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
-      if (emm_ctx->state == EMM_STATE_REGISTERED) {
-        m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
-        emm_ctx->state = EMM_STATE_DEREGISTERED;
-      }
-      srslte::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
-      ecm_ctx->state          = ECM_STATE_IDLE;
-      ecm_ctx->mme_ue_s1ap_id = 0;
-      ecm_ctx->enb_ue_s1ap_id = 0;
+      uint32_t mme_ue_s1ap_id = *ue_id;
+      m_workers->push(m_workers->get_shard(mme_ue_s1ap_id),
+                      [this, mme_ue_s1ap_id]() { release_ue_ecm_ctx_in_enb(mme_ue_s1ap_id); });
       ues_in_enb->second.erase(ue_id++);
     }
   }
 }
 
+void s1ap::release_ue_ecm_ctx_in_enb(uint32_t mme_ue_s1ap_id)
+{
+  nas* nas_ctx = find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id);
+  if (nas_ctx == NULL) {
+    m_s1ap_log->warning("Cannot release UE ECM context, UE not found. MME-UE S1AP Id: %d\n", mme_ue_s1ap_id);
+    return;
+  }
+  emm_ctx_t* emm_ctx = &nas_ctx->m_emm_ctx;
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+
+  m_s1ap_log->info(
+      "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d\n", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
+  if (emm_ctx->state == EMM_STATE_REGISTERED) {
+    m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
+    emm_ctx->state = EMM_STATE_DEREGISTERED;
+  }
+  srslte::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
+  ecm_ctx->state          = ECM_STATE_IDLE;
+  ecm_ctx->mme_ue_s1ap_id = 0;
+  ecm_ctx->enb_ue_s1ap_id = 0;
+}
+
 bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   nas* nas_ctx = find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id);
   if (nas_ctx == NULL) {
     m_s1ap_log->error("Cannot release UE ECM context, UE not found. MME-UE S1AP Id: %d\n", mme_ue_s1ap_id);
@@ -511,6 +636,7 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
 
 bool s1ap::delete_ue_ctx(uint64_t imsi)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
   if (nas_ctx == NULL) {
     m_s1ap_log->info("Cannot delete UE context, UE not found. IMSI: %" PRIu64 "\n", imsi);
@@ -532,6 +658,7 @@ bool s1ap::delete_ue_ctx(uint64_t imsi)
 // UE Bearer Managment
 void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint64_t, nas*>::iterator ue_ctx_it = m_imsi_to_nas_ctx.find(imsi);
   if (ue_ctx_it == m_imsi_to_nas_ctx.end()) {
     m_s1ap_log->error("Could not activate EPS bearer: Could not find UE context\n");
@@ -569,8 +696,10 @@ void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 
 uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 {
-  uint32_t m_tmsi = m_next_m_tmsi;
-  m_next_m_tmsi   = (m_next_m_tmsi + 1) % UINT32_MAX;
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
+  // The M-TMSI routes the Service Requests of the UE to its shard
+  uint32_t m_tmsi = m_workers->next_id(m_next_m_tmsi);
+  m_next_m_tmsi   = (m_tmsi + 1) % UINT32_MAX;
 
   m_tmsi_to_imsi.insert(std::pair<uint32_t, uint64_t>(m_tmsi, imsi));
   m_s1ap_log->debug("Allocated M-TMSI 0x%x to IMSI %015" PRIu64 ",\n", m_tmsi, imsi);
@@ -579,6 +708,7 @@ uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 
 uint64_t s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_ctx_mutex);
   std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
   if (it != m_tmsi_to_imsi.end()) {
     m_s1ap_log->debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x\n", it->second, m_tmsi);
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <getopt.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace srsepc;
+
+static uint32_t nof_users = 10000;
+
+static const uint64_t first_imsi = 1010000000000ULL;
+static const uint8_t  test_key[] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                   0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+
+void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n number of users in the DB file [Default %d]\n", nof_users);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_users = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void write_user(FILE* f, uint64_t imsi, uint32_t qci)
+{
+  fprintf(f,
+          "ue%" PRIu64 ",xor,%015" PRIu64 ",00112233445566778899aabbccddeeff,opc,63bfa50ee6523365ff14c1f45f88737d,9001,"
+          "000000001234,%d,dynamic\n",
+          imsi,
+          imsi,
+          qci);
+}
+
+static void write_db(const char* db_file, uint32_t nof, uint64_t skip_imsi, uint64_t extra_imsi, uint32_t qci)
+{
+  FILE* f = fopen(db_file, "w");
+  fprintf(f, "# Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc\n");
+  for (uint32_t i = 0; i < nof; i++) {
+    if (first_imsi + i != skip_imsi) {
+      write_user(f, first_imsi + i, i == 0 ? qci : 7);
+    }
+  }
+  if (extra_imsi != 0) {
+    write_user(f, extra_imsi, 7);
+  }
+  fclose(f);
+}
+
+// Recovers the SQN of a XOR authentication vector, AUTN = SQN ^ AK where AK = (K ^ RAND)[3..8]
+static uint64_t get_sqn(const uint8_t* autn, const uint8_t* rand)
+{
+  uint64_t sqn = 0;
+  for (int i = 0; i < 6; i++) {
+    sqn = (sqn << 8) | (autn[i] ^ test_key[i + 3] ^ rand[i + 3]);
+  }
+  return sqn;
+}
+
+static int gen_vector_sqn(hss* hss_ptr, uint64_t imsi, uint64_t* sqn)
+{
+  uint8_t k_asme[32], autn[16], rand[16], xres[16];
+  TESTASSERT(hss_ptr->gen_auth_info_answer(imsi, k_asme, autn, rand, xres));
+  *sqn = get_sqn(autn, rand);
+  return SRSLTE_SUCCESS;
+}
+
+int hss_test()
+{
+  const char* db_file = "hss_test_user_db.csv";
+  std::string journal = std::string(db_file) + ".sqn";
+  unlink(journal.c_str());
+  write_db(db_file, nof_users, 0, 0, 7);
+
+  srslte::log_filter hss_log("HSS");
+  hss_log.set_level(srslte::LOG_LEVEL_ERROR);
+
+  hss_args_t args       = {};
+  args.db_file          = db_file;
+  args.db_reload_period = 1;
+  args.mcc              = 0xf001;
+  args.mnc              = 0xff01;
+
+  // Load the DB file
+  hss*                                           hss_ptr = hss::get_instance();
+  std::chrono::high_resolution_clock::time_point t0      = std::chrono::high_resolution_clock::now();
+  TESTASSERT(hss_ptr->init(&args, &hss_log) == 0);
+  std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+  printf("Loaded %d users in %.1f ms\n",
+         nof_users,
+         std::chrono::duration_cast<std::chrono::duration<double, std::milli> >(t1 - t0).count());
+
+  // Every vector moves the SQN forward
+  uint64_t sqn0 = 0, sqn1 = 0, sqn = 0;
+  TESTASSERT(gen_vector_sqn(hss_ptr, first_imsi + 1, &sqn0) == SRSLTE_SUCCESS);
+  TESTASSERT(gen_vector_sqn(hss_ptr, first_imsi + 1, &sqn1) == SRSLTE_SUCCESS);
+  TESTASSERT(sqn0 == 0x1234);
+  TESTASSERT(sqn1 > sqn0);
+
+  // Without a clean stop, the SQN is recovered from the journal
+  hss::cleanup();
+  hss_ptr = hss::get_instance();
+  TESTASSERT(hss_ptr->init(&args, &hss_log) == 0);
+  TESTASSERT(gen_vector_sqn(hss_ptr, first_imsi + 1, &sqn) == SRSLTE_SUCCESS);
+  TESTASSERT(sqn > sqn1);
+  sqn1 = sqn;
+
+  // Hot reload: one user removed, one added and the QCI of another one changed
+  uint8_t qci = 0;
+  TESTASSERT(hss_ptr->gen_update_loc_answer(first_imsi, &qci) && qci == 7);
+  sleep(1);
+  write_db(db_file, nof_users, first_imsi + 2, first_imsi + nof_users, 9);
+  sleep(3);
+  TESTASSERT(hss_ptr->gen_update_loc_answer(first_imsi, &qci) && qci == 9);
+  TESTASSERT(not hss_ptr->gen_update_loc_answer(first_imsi + 2, &qci));
+  TESTASSERT(hss_ptr->gen_update_loc_answer(first_imsi + nof_users, &qci));
+
+  // Unchanged users keep their SQN
+  TESTASSERT(gen_vector_sqn(hss_ptr, first_imsi + 1, &sqn) == SRSLTE_SUCCESS);
+  TESTASSERT(sqn > sqn1);
+  sqn1 = sqn;
+
+  // A clean stop folds the journal into the DB file
+  hss_ptr->stop();
+  hss::cleanup();
+  struct stat st;
+  TESTASSERT(stat(journal.c_str(), &st) == 0 && st.st_size == 0);
+  hss_ptr = hss::get_instance();
+  TESTASSERT(hss_ptr->init(&args, &hss_log) == 0);
+  TESTASSERT(gen_vector_sqn(hss_ptr, first_imsi + 1, &sqn) == SRSLTE_SUCCESS);
+  TESTASSERT(sqn > sqn1);
+  hss_ptr->stop();
+  hss::cleanup();
+
+  unlink(db_file);
+  unlink(journal.c_str());
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  TESTASSERT(hss_test() == SRSLTE_SUCCESS);
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
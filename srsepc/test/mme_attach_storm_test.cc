@@ -0,0 +1,232 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Attach storm driver. Emulates a number of eNBs at the S1AP level, each of
+ * them setting up its S1 interface and then forwarding the IMSI Attach
+ * Requests of its UEs at once, and measures how fast the MME creates the UE
+ * contexts with a single and with several worker shards.
+ */
+
+#include "srsepc/hdr/mme/s1ap.h"
+#include "srslte/common/bcd_helpers.h"
+#include "srslte/common/test_common.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <getopt.h>
+
+using namespace srsepc;
+
+static uint32_t nof_enbs    = 8;
+static uint32_t nof_ues     = 1000;
+static uint32_t nof_workers = 4;
+
+static const uint16_t test_mcc = 0xf001;
+static const uint16_t test_mnc = 0xff01;
+static const uint16_t test_tac = 7;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [ewn]\n", prog);
+  printf("\t-e number of eNBs [Default %d]\n", nof_enbs);
+  printf("\t-n number of UEs [Default %d]\n", nof_ues);
+  printf("\t-w number of MME worker shards [Default %d]\n", nof_workers);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ewn")) != -1) {
+    switch (opt) {
+      case 'e':
+        nof_enbs = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'w':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void pack_and_rx(s1ap* s1ap_ptr, const s1ap_pdu_t& pdu, uint32_t enb_idx)
+{
+  srslte::byte_buffer_t buf;
+  asn1::bit_ref         bref(buf.msg, buf.get_tailroom());
+  pdu.pack(bref);
+  buf.N_bytes = bref.distance_bytes();
+
+  struct sctp_sndrcvinfo sri = {};
+  sri.sinfo_assoc_id         = enb_idx + 1;
+  s1ap_ptr->handle_s1ap_rx_pdu(&buf, &sri);
+}
+
+static void send_s1_setup_request(s1ap* s1ap_ptr, uint32_t enb_idx)
+{
+  uint32_t plmn;
+  srslte::s1ap_mccmnc_to_plmn(test_mcc, test_mnc, &plmn);
+  plmn = htonl(plmn);
+
+  s1ap_pdu_t pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+  asn1::s1ap::s1_setup_request_ies_container& container = pdu.init_msg().value.s1_setup_request().protocol_ies;
+  container.global_enb_id.value.plm_nid[0]              = ((uint8_t*)&plmn)[1];
+  container.global_enb_id.value.plm_nid[1]              = ((uint8_t*)&plmn)[2];
+  container.global_enb_id.value.plm_nid[2]              = ((uint8_t*)&plmn)[3];
+  container.global_enb_id.value.enb_id.set_macro_enb_id().from_number(0x19B + enb_idx);
+
+  container.supported_tas.value.resize(1);
+  uint16_t tac = htons(test_tac);
+  memcpy(container.supported_tas.value[0].tac.data(), (uint8_t*)&tac, 2);
+  container.supported_tas.value[0].broadcast_plmns.resize(1);
+  container.supported_tas.value[0].broadcast_plmns[0][0] = ((uint8_t*)&plmn)[1];
+  container.supported_tas.value[0].broadcast_plmns[0][1] = ((uint8_t*)&plmn)[2];
+  container.supported_tas.value[0].broadcast_plmns[0][2] = ((uint8_t*)&plmn)[3];
+  container.default_paging_drx.value.value               = asn1::s1ap::paging_drx_opts::v128;
+
+  pack_and_rx(s1ap_ptr, pdu, enb_idx);
+}
+
+static void send_attach_request(s1ap* s1ap_ptr, uint32_t enb_idx, uint32_t enb_ue_s1ap_id, uint64_t imsi)
+{
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+  attach_req.eps_attach_type                      = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+  for (uint32_t i = 0; i < 8; i++) {
+    attach_req.ue_network_cap.eea[i] = (i < 3);
+    attach_req.ue_network_cap.eia[i] = (i > 0 && i < 3);
+  }
+  attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  attach_req.nas_ksi.tsc_flag         = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req.nas_ksi.nas_ksi          = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+  for (int i = 14; i >= 0; i--) {
+    attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+    imsi /= 10;
+  }
+
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+  pdn_con_req.proc_transaction_id                            = 0x01;
+  pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+  srslte::byte_buffer_t nas_msg;
+  liblte_mme_pack_attach_request_msg(&attach_req, (LIBLTE_BYTE_MSG_STRUCT*)&nas_msg);
+
+  uint32_t plmn;
+  srslte::s1ap_mccmnc_to_plmn(test_mcc, test_mnc, &plmn);
+  plmn = htonl(plmn);
+
+  s1ap_pdu_t pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+  asn1::s1ap::init_ue_msg_ies_container& container = pdu.init_msg().value.init_ue_msg().protocol_ies;
+  container.enb_ue_s1ap_id.value                   = enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas_msg.N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas_msg.msg, nas_msg.N_bytes);
+  container.tai.value.plm_nid[0] = ((uint8_t*)&plmn)[1];
+  container.tai.value.plm_nid[1] = ((uint8_t*)&plmn)[2];
+  container.tai.value.plm_nid[2] = ((uint8_t*)&plmn)[3];
+  uint16_t tac                   = htons(test_tac);
+  memcpy(container.tai.value.tac.data(), (uint8_t*)&tac, 2);
+  container.eutran_cgi.value.plm_nid = container.tai.value.plm_nid;
+  container.eutran_cgi.value.cell_id.from_number(((0x19B + enb_idx) << 8) + 1);
+  container.rrc_establishment_cause.value = asn1::s1ap::rrc_establishment_cause_opts::mo_sig;
+
+  pack_and_rx(s1ap_ptr, pdu, enb_idx);
+}
+
+int attach_storm_test(uint32_t workers, double* attach_rate)
+{
+  srslte::log_filter s1ap_log("S1AP");
+  srslte::log_filter nas_log("NAS");
+  s1ap_log.set_level(srslte::LOG_LEVEL_ERROR);
+  nas_log.set_level(srslte::LOG_LEVEL_ERROR);
+
+  s1ap_args_t args     = {};
+  args.mme_code        = 0x01;
+  args.mme_group       = 0x0001;
+  args.tac             = test_tac;
+  args.mcc             = test_mcc;
+  args.mnc             = test_mnc;
+  args.paging_timer    = 2;
+  args.nof_workers     = workers;
+  args.mme_bind_addr   = "127.0.0.1";
+  args.mme_name        = "srsmme01";
+  args.dns_addr        = "8.8.8.8";
+  args.mme_apn         = "srsapn";
+  args.encryption_algo = srslte::CIPHERING_ALGORITHM_ID_EEA0;
+  args.integrity_algo  = srslte::INTEGRITY_ALGORITHM_ID_128_EIA1;
+
+  s1ap* s1ap_ptr = s1ap::get_instance();
+  TESTASSERT(s1ap_ptr->init(args, &nas_log, &s1ap_log) == 0);
+
+  // Bring up the eNBs
+  for (uint32_t e = 0; e < nof_enbs; e++) {
+    send_s1_setup_request(s1ap_ptr, e);
+  }
+  s1ap_ptr->get_workers()->wait_idle();
+  TESTASSERT(s1ap_ptr->m_active_enbs.size() == nof_enbs);
+
+  // All the UEs attach at once, spread over the eNBs
+  std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    send_attach_request(s1ap_ptr, i % nof_enbs, i / nof_enbs + 1, 1010000000000ULL + i);
+  }
+  s1ap_ptr->get_workers()->wait_idle();
+  std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+  double elapsed = std::chrono::duration_cast<std::chrono::duration<double> >(t1 - t0).count();
+  *attach_rate   = nof_ues / elapsed;
+
+  // Every UE has a context, owned by the shard its identifiers map to
+  TESTASSERT(s1ap_ptr->m_imsi_to_nas_ctx.size() == nof_ues);
+  for (std::map<uint64_t, nas*>::iterator it = s1ap_ptr->m_imsi_to_nas_ctx.begin();
+       it != s1ap_ptr->m_imsi_to_nas_ctx.end();
+       it++) {
+    TESTASSERT(it->second->m_shard == s1ap_ptr->get_workers()->get_shard(it->first));
+    TESTASSERT(it->second->m_shard == s1ap_ptr->get_workers()->get_shard(it->second->m_ecm_ctx.mme_ue_s1ap_id));
+  }
+
+  s1ap_ptr->stop();
+  s1ap::cleanup();
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  double rate_single = 0, rate_sharded = 0;
+  TESTASSERT(attach_storm_test(1, &rate_single) == SRSLTE_SUCCESS);
+  TESTASSERT(attach_storm_test(nof_workers, &rate_sharded) == SRSLTE_SUCCESS);
+
+  printf("Attach storm, %d eNBs, %d UEs: %.0f attach/s with 1 worker, %.0f attach/s with %d workers\n",
+         nof_enbs,
+         nof_ues,
+         rate_single,
+         rate_sharded,
+         nof_workers);
+  return SRSLTE_SUCCESS;
+}
@@ -65,6 +65,7 @@ void search::init(srslte::rf_buffer_t& buffer_, srslte::log* log_h_, uint32_t no
     Error("SYNC:  Initiating UE cell search\n");
   }
   srslte_ue_cellsearch_set_nof_valid_frames(&cs, 4);
+  srslte_ue_cellsearch_set_prescan(&cs, true);
 
   if (srslte_ue_mib_sync_init_multi(&ue_mib_sync, radio_recv_callback, nof_rx_channels, parent)) {
     Error("SYNC:  Initiating UE MIB synchronization\n");